@@ -0,0 +1,196 @@
+#ifndef ADAPTIVE_SORT_H
+#define ADAPTIVE_SORT_H
+
+#include <algorithm>   // std::min, std::max
+#include <cstddef>     // std::ptrdiff_t
+#include <functional>  // std::less, std::invoke
+#include <iterator>    // std::iterator_traits
+#include <type_traits> // std::is_arithmetic, std::decay_t, std::invoke_result_t
+#include <vector>
+
+#include "sorting.h"          // quickSort
+#include "advanced_sorting.h" // tim_sort, radix_sort, custom_insertion_sort_range
+#include "sample_sort.h"      // sample_sort
+#include "sort_tuning.h"      // sort_tuning() (dispatch thresholds)
+#include "sort_workspace.h"   // SortWorkspace (sample and engine scratch)
+
+
+// ADAPTIVE SORT (dispatcher)
+//
+// One entry point that looks at the input before choosing an engine. The look is cheap: a
+// natural-run scan that stops as soon as the input is clearly not presorted (on random data
+// after about 2.5 * n / adaptive_run_divisor comparisons) and a fixed-size strided sample for
+// the duplicate ratio and the key range. The choice, in order:
+//   - at most adaptive_small_size elements: insertion sort;
+//   - at most n / adaptive_run_divisor natural runs: tim_sort, which merges the runs;
+//   - integer / floating-point keys under std::less, at least adaptive_radix_min_size elements
+//     (half that when the sampled keys span 16 bits or less): radix_sort;
+//   - a multi-threaded pool, at least adaptive_sample_sort_min_size elements and fewer than
+//     adaptive_duplicate_percent sampled duplicates: sample_sort;
+//   - otherwise quickSort (pdqsort), which also handles many equal keys in linear passes.
+// Thresholds come from sort_tuning(), so calibrate_sort_tuning() fits them to the machine.
+// A SortWorkspace, if given, holds the sample and is passed on to tim_sort and radix_sort;
+// sample_sort takes none and allocates its buffers per call.
+// The sort is not stable. Named adaptive_sort because a global sort() would be ambiguous with
+// std::sort under argument-dependent lookup.
+
+const std::ptrdiff_t ADAPTIVE_SORT_SAMPLE_SIZE = 128; // Elements sampled for duplicates and key range
+
+enum class SortEngine { Insertion, Tim, Radix, Sample, Quick };
+
+inline const char* sort_engine_name(SortEngine engine) {
+    switch (engine) {
+        case SortEngine::Insertion: return "insertion";
+        case SortEngine::Tim: return "tim";
+        case SortEngine::Radix: return "radix";
+        case SortEngine::Sample: return "sample";
+        case SortEngine::Quick: return "quick";
+    }
+    return "?";
+}
+
+// What the dispatcher measured
+struct SortInputProfile {
+    std::ptrdiff_t size = 0;
+    std::ptrdiff_t runs = 0;          // Natural runs; the scan stops once runs exceed run_limit
+    std::ptrdiff_t run_limit = 0;
+    int duplicate_percent = 0;        // Sampled elements equal to another sampled element
+    int key_bits = 0;                 // Bits spanned by the sampled keys; 0 if not radix-sortable
+};
+
+namespace AdaptiveSortImpl {
+
+template<typename Key, typename Compare>
+struct is_radix_compare : std::false_type {};
+template<typename Key>
+struct is_radix_compare<Key, std::less<>> : std::true_type {};
+template<typename Key>
+struct is_radix_compare<Key, std::less<Key>> : std::true_type {};
+
+template<typename RandomIt, typename Compare, typename Proj>
+struct RadixTraits {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    using key_type = std::decay_t<std::invoke_result_t<Proj&, value_type&>>;
+    static constexpr bool sortable = std::is_arithmetic<key_type>::value && !std::is_same<key_type, bool>::value
+                                     && sizeof(key_type) <= 8 && is_radix_compare<key_type, Compare>::value;
+};
+
+// Natural runs as tim_sort sees them (non-descending or strictly descending), stopping past limit
+template<typename RandomIt, typename Compare>
+inline std::ptrdiff_t count_runs(RandomIt first, std::ptrdiff_t n, Compare& comp, std::ptrdiff_t limit) {
+    std::ptrdiff_t runs = 0, i = 0;
+    while (i < n && runs <= limit) {
+        ++runs;
+        if (++i == n) break;
+        if (comp(first[i], first[i - 1])) {
+            while (i + 1 < n && comp(first[i + 1], first[i])) ++i;
+        } else {
+            while (i + 1 < n && !comp(first[i + 1], first[i])) ++i;
+        }
+        ++i;
+    }
+    return runs;
+}
+
+template<typename Key>
+inline int span_bits(Key lo, Key hi) {
+    if constexpr (std::is_floating_point<Key>::value) {
+        return static_cast<int>(sizeof(Key) * 8);
+    } else {
+        using U = std::make_unsigned_t<Key>;
+        U span = static_cast<U>(static_cast<U>(hi) - static_cast<U>(lo));
+        int bits = 0;
+        while (span) { ++bits; span >>= 1; }
+        return bits;
+    }
+}
+
+} // namespace AdaptiveSortImpl
+
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline SortInputProfile profile_sort_input(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}, SortWorkspace* workspace = nullptr) {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    using Traits = AdaptiveSortImpl::RadixTraits<RandomIt, Compare, Proj>;
+    auto cmp = make_projected_compare(comp, proj);
+    SortInputProfile profile;
+    std::ptrdiff_t n = last - first;
+    profile.size = n;
+    if (n < 2) return profile;
+
+    profile.run_limit = std::max<std::ptrdiff_t>(1, n / std::max<std::ptrdiff_t>(1, sort_tuning().adaptive_run_divisor));
+    profile.runs = AdaptiveSortImpl::count_runs(first, n, cmp, profile.run_limit);
+
+    // Strided sample: sorted copy, adjacent equal keys are duplicates
+    std::ptrdiff_t sample_size = std::min(n, ADAPTIVE_SORT_SAMPLE_SIZE);
+    std::vector<value_type> local;
+    std::vector<value_type>& sample = sort_scratch(workspace, local, 0);
+    sample.clear();
+    sample.reserve(sample_size);
+    for (std::ptrdiff_t i = 0; i < sample_size; ++i) sample.push_back(first[i * (n / sample_size)]);
+    custom_insertion_sort_range(sample.begin(), sample.end(), cmp);
+    std::ptrdiff_t duplicates = 0;
+    for (std::ptrdiff_t i = 1; i < sample_size; ++i) {
+        if (!cmp(sample[i - 1], sample[i])) ++duplicates;
+    }
+    profile.duplicate_percent = static_cast<int>(100 * duplicates / sample_size);
+
+    if constexpr (Traits::sortable) {
+        profile.key_bits = AdaptiveSortImpl::span_bits(std::invoke(proj, sample.front()), std::invoke(proj, sample.back()));
+    }
+    return profile;
+}
+
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline SortEngine choose_sort_engine(const SortInputProfile& profile, unsigned threads) {
+    const SortTuning& tuning = sort_tuning();
+    std::ptrdiff_t n = profile.size;
+    if (n <= tuning.adaptive_small_size) return SortEngine::Insertion;
+    if (profile.runs <= profile.run_limit) return SortEngine::Tim;
+    if (AdaptiveSortImpl::RadixTraits<RandomIt, Compare, Proj>::sortable) {
+        std::ptrdiff_t radix_min = tuning.adaptive_radix_min_size;
+        if (profile.key_bits <= 16) radix_min /= 2;
+        if (n >= radix_min) return SortEngine::Radix;
+    }
+    if (threads > 1 && n >= tuning.adaptive_sample_sort_min_size && profile.duplicate_percent < tuning.adaptive_duplicate_percent) {
+        return SortEngine::Sample;
+    }
+    return SortEngine::Quick;
+}
+
+// Sort with the engine the input profile picks; returns the engine used
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline SortEngine adaptive_sort(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}, TaskPool& pool = default_task_pool(),
+                                SortWorkspace* workspace = nullptr) {
+    SortInputProfile profile = profile_sort_input(first, last, comp, proj, workspace);
+    if (profile.size < 2) return SortEngine::Insertion;
+    SortEngine engine = choose_sort_engine<RandomIt, Compare, Proj>(profile, pool.thread_count());
+    switch (engine) {
+        case SortEngine::Insertion:
+            custom_insertion_sort_range(first, last, make_projected_compare(comp, proj));
+            break;
+        case SortEngine::Tim:
+            tim_sort(first, last, comp, proj, workspace);
+            break;
+        case SortEngine::Radix:
+            if constexpr (AdaptiveSortImpl::RadixTraits<RandomIt, Compare, Proj>::sortable) {
+                RadixSortOptions options;
+                options.pool = &pool;
+                options.workspace = workspace;
+                radix_sort(first, last, proj, options);
+            }
+            break;
+        case SortEngine::Sample:
+            sample_sort(first, last, comp, proj, pool);
+            break;
+        case SortEngine::Quick:
+            quickSort(first, last, comp, proj, pool);
+            break;
+    }
+    return engine;
+}
+inline SortEngine adaptive_sort(std::vector<int>& arr, TaskPool& pool = default_task_pool(), SortWorkspace* workspace = nullptr) {
+    return adaptive_sort(arr.begin(), arr.end(), std::less<>(), identity_projection(), pool, workspace);
+}
+
+
+#endif
@@ -2,75 +2,91 @@
 #include <vector>
 #include <string>
 #include <thread>
-#include <mutex>
-#include <functional> // Needed for std::cref
 #include <chrono>
-#include <numeric>    // Needed for std::iota
-#include <random>
-#include <algorithm> // Only for std::min, std::shuffle in data generation
+#include <algorithm> // Only for std::min
 #include <exception> // Include for std::exception
 #include <iomanip>   // Include for std::setw, std::left
 
 // *** Include the header with the CONTEMPORARY sorting algorithms ***
 #include "advanced_sorting.h"
+#include "sorting.h" // quickSort for the large-size comparison
+#include "sample_sort.h" // sample_sort (parallel in-place sample sort)
+#include "datasets.h" // generate_dataset, load_dataset (seeded, cached inputs)
+#include "benchmark_scheduler.h" // CPU pinning and the worker limit (--cpus, --numa-node, --threads)
 
 
 const int NUM_RUNS = 10;
-const int MAX_CONCURRENT_THREADS = 20; 
-
-std::mutex cout_mutex;
-
-std::vector<int> generate_random_array(int size) { 
-    std::vector<int> arr(size); std::mt19937 rng(std::random_device{}()); std::uniform_int_distribution<int> dist(0, 1'000'000); std::generate(arr.begin(), arr.end(), [&]() { return dist(rng); }); return arr; }
-std::vector<int> generate_reverse_sorted_array(int size) { 
-    std::vector<int> arr(size); std::iota(arr.rbegin(), arr.rend(), 0); return arr; }
-std::vector<int> generate_ascending_sorted_array(int size) { 
-    std::vector<int> arr(size); std::iota(arr.begin(), arr.end(), 0); return arr; }
-std::vector<int> generate_partially_sorted_array(int size) { 
-    std::vector<int> arr(size); std::iota(arr.begin(), arr.end(), 0); if (size > 1) { std::mt19937 shuffle_rng(std::random_device{}()); std::shuffle(arr.begin(), arr.begin() + std::min(size, (size / 2) + (size % 2)), shuffle_rng); } return arr; }
+const std::vector<int> LARGE_COMPARISON_SIZES = {1000000, 10000000, 100000000};
+const int LARGE_COMPARISON_RUNS = 3;
 
 
 template <typename SortFunc>
-double average_sort_time(SortFunc sort_func, const std::vector<int>& original) { 
+double average_sort_time(SortFunc sort_func, const std::vector<int>& original, int runs = NUM_RUNS) { 
     double total_time = 0; if (original.empty()) return 0.0;
-    for (int i = 0; i < NUM_RUNS; ++i) {
+    for (int i = 0; i < runs; ++i) {
         std::vector<int> arr = original; auto start = std::chrono::high_resolution_clock::now();
         sort_func(arr); auto end = std::chrono::high_resolution_clock::now();
         total_time += std::chrono::duration<double, std::milli>(end - start).count();
-    } return total_time / NUM_RUNS; }
+    } return total_time / runs; }
+
+// Radix Sort vs the comparison sorts on large random inputs, one size at a time
+void run_large_comparison() {
+    std::cout << "\n=== Radix Sort vs Quick Sort vs Introsort (Random Data, Avg over " << LARGE_COMPARISON_RUNS << " runs) ===\n" << std::flush;
+    for (int size : LARGE_COMPARISON_SIZES) {
+        try {
+            std::vector<int> data = load_dataset<int>("random", size); // Cached after the first run
+            double quick_time = average_sort_time(
+                [](std::vector<int>& arr) { if (!arr.empty()) quickSort(arr, 0, arr.size() - 1); }, data, LARGE_COMPARISON_RUNS);
+            double intro_time = average_sort_time([](std::vector<int>& arr) { introsort(arr); }, data, LARGE_COMPARISON_RUNS);
+            double radix_time = average_sort_time([](std::vector<int>& arr) { radix_sort(arr); }, data, LARGE_COMPARISON_RUNS);
+
+            std::cout << "\n-- Size: " << size << " --\n" << std::fixed << std::setprecision(3);
+            std::cout << std::left << std::setw(16) << "Quick Sort:" << std::setw(12) << std::right << quick_time << " ms\n";
+            std::cout << std::left << std::setw(16) << "Introsort:" << std::setw(12) << std::right << intro_time << " ms\n";
+            std::cout << std::left << std::setw(16) << "Radix Sort:" << std::setw(12) << std::right << radix_time << " ms\n" << std::flush;
+        } catch (const std::bad_alloc& e) {
+            std::cerr << "Failed to allocate memory for large comparison of size " << size << ". Skipping." << std::endl;
+        } catch (const std::runtime_error& e) {
+            std::cerr << "Dataset cache error for size " << size << ": " << e.what() << ". Skipping." << std::endl;
+        }
+    }
+}
 
 
 //  Worker Function
 void process_dataset(int size, const std::string& label, const std::vector<int>& data) {
     double lib_time = 0.0, tim_time = 0.0, cock_time = 0.0;
-    double comb_time = 0.0, tourn_time = 0.0, intro_time = 0.0;
-    std::string note_lib = "(STUB)";
-    std::string note_tim = "(Simplified)";
+    double comb_time = 0.0, tourn_time = 0.0, intro_time = 0.0, radix_time = 0.0, sample_time = 0.0;
 
     try {
-        { std::lock_guard<std::mutex> lock(cout_mutex); std::cout << "  [" << label << "," << size << "] Starting Library Sort " << note_lib << "..." << std::flush; }
-        lib_time = average_sort_time(library_sort, data); // Calling the stub
+        std::cout << "  [" << label << "," << size << "] Starting Library Sort..." << std::flush;
+        lib_time = average_sort_time([](std::vector<int>& arr) { library_sort(arr); }, data); // Calling custom implementation
+
+        std::cout << " Done.\n  [" << label << "," << size << "] Starting Timsort..." << std::flush;
+        tim_time = average_sort_time([](std::vector<int>& arr) { tim_sort(arr); }, data); // Calling custom implementation
 
-        { std::lock_guard<std::mutex> lock(cout_mutex); std::cout << " Done.\n  [" << label << "," << size << "] Starting Timsort " << note_tim << "..." << std::flush; }
-        tim_time = average_sort_time(tim_sort, data); // Calling the simplified implementation
+        std::cout << " Done.\n  [" << label << "," << size << "] Starting Cocktail Shaker Sort..." << std::flush;
+        cock_time = average_sort_time([](std::vector<int>& arr) { cocktail_shaker_sort(arr); }, data); // Calling custom implementation
 
-        { std::lock_guard<std::mutex> lock(cout_mutex); std::cout << " Done.\n  [" << label << "," << size << "] Starting Cocktail Shaker Sort..." << std::flush; }
-        cock_time = average_sort_time(cocktail_shaker_sort, data); // Calling custom implementation
+        std::cout << " Done.\n  [" << label << "," << size << "] Starting Comb Sort..." << std::flush;
+        comb_time = average_sort_time([](std::vector<int>& arr) { comb_sort(arr); }, data); // Calling custom implementation
 
-        { std::lock_guard<std::mutex> lock(cout_mutex); std::cout << " Done.\n  [" << label << "," << size << "] Starting Comb Sort..." << std::flush; }
-        comb_time = average_sort_time(comb_sort, data); // Calling custom implementation
+        std::cout << " Done.\n  [" << label << "," << size << "] Starting Tournament Sort (Heap)..." << std::flush;
+        tourn_time = average_sort_time([](std::vector<int>& arr) { tournament_sort(arr); }, data); // Calling custom implementation
 
-        { std::lock_guard<std::mutex> lock(cout_mutex); std::cout << " Done.\n  [" << label << "," << size << "] Starting Tournament Sort (Heap)..." << std::flush; }
-        tourn_time = average_sort_time(tournament_sort, data); // Calling custom implementation
+        std::cout << " Done.\n  [" << label << "," << size << "] Starting Introsort (Custom)..." << std::flush;
+        intro_time = average_sort_time([](std::vector<int>& arr) { introsort(arr); }, data); // Calling custom implementation
 
-        { std::lock_guard<std::mutex> lock(cout_mutex); std::cout << " Done.\n  [" << label << "," << size << "] Starting Introsort (Custom)..." << std::flush; }
-        intro_time = average_sort_time(introsort, data); // Calling custom implementation
+        std::cout << " Done.\n  [" << label << "," << size << "] Starting Radix Sort (LSD)..." << std::flush;
+        radix_time = average_sort_time([](std::vector<int>& arr) { radix_sort(arr); }, data); // Calling custom implementation
 
-        { std::lock_guard<std::mutex> lock(cout_mutex); std::cout << " Done." << std::endl; }
+        std::cout << " Done.\n  [" << label << "," << size << "] Starting Sample Sort (IPS4o)..." << std::flush;
+        sample_time = average_sort_time([](std::vector<int>& arr) { sample_sort(arr); }, data); // Calling custom implementation
+
+        std::cout << " Done." << std::endl;
 
 
         // Format and print results
-        std::lock_guard<std::mutex> lock(cout_mutex);
         std::cout << "\n-- Results for " << label << " Data (Size: " << size << ", Avg over " << NUM_RUNS << " runs) --\n";
         std::cout << std::fixed << std::setprecision(3); 
 
@@ -79,36 +95,53 @@ void process_dataset(int size, const std::string& label, const std::vector<int>&
                       << std::setw(12) << std::right << time_ms << " ms\n";
         };
 
-        print_time("Library Sort", lib_time, note_lib);
-        print_time("Timsort", tim_time, note_tim);
+        print_time("Library Sort", lib_time);
+        print_time("Timsort", tim_time);
         print_time("Cocktail Shaker Sort", cock_time);
         print_time("Comb Sort", comb_time);
         print_time("Tournament Sort (Heap)", tourn_time);
         print_time("Introsort (Custom)", intro_time);
+        print_time("Radix Sort (LSD)", radix_time);
+        print_time("Sample Sort (IPS4o)", sample_time);
 
     } catch (const std::exception& e) {
-        std::lock_guard<std::mutex> lock(cout_mutex);
         std::cerr << "\n!!! Error processing dataset (" << label << ", Size: " << size << "): " << e.what() << std::endl;
     } catch (...) {
-        std::lock_guard<std::mutex> lock(cout_mutex);
         std::cerr << "\n!!! Unknown error processing dataset (" << label << ", Size: " << size << ")" << std::endl;
     }
 }
 
-int main() {
+// Usage: advanced_sorting [--cpus LIST | --numa-node N] [--threads N]
+// Datasets are measured one at a time; --cpus / --numa-node pin the run and --threads limits
+// the pool Sample Sort uses.
+int main(int argc, char** argv) {
     std::vector<int> sizes = {1000, 10000, 100000, 500000, 1000000}; 
 
+    BenchmarkPlacement placement;
+    std::string placement_info;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (!parse_placement_option(argc, argv, i, placement)) {
+                std::cerr << "Unknown or incomplete option: " << argv[i] << "\nUsage: " << argv[0] << " [--cpus LIST | --numa-node N] [--threads N]" << std::endl;
+                return 2;
+            }
+        }
+        placement_info = apply_benchmark_placement(placement); // Before the default pool starts
+    } catch (const std::exception& e) {
+        std::cerr << "!!! " << e.what() << " !!!" << std::endl;
+        return 2;
+    }
+
     unsigned int hardware_cores = std::thread::hardware_concurrency();
     std::cout << "Detected " << hardware_cores << " hardware threads (logical cores)." << std::endl;
-    std::cout << "Running up to " << MAX_CONCURRENT_THREADS << " concurrent dataset processing tasks (max 4 per size)." << std::endl;
+    std::cout << "Placement: " << placement_info << "." << std::endl;
+    std::cout << "Datasets are measured one at a time, in isolation." << std::endl;
     std::cout << "Benchmarking CONTEMPORARY sorting algorithms." << std::endl;
     std::cout << "All sorting algorithms implemented FROM SCRATCH (except where noted)." << std::endl;
     std::cout << "Each test will run " << NUM_RUNS << " times to calculate average execution time." << std::endl;
     std::cout << "\n!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!" << std::endl;
     std::cout << "!!! WARNING: Running Cocktail Shaker Sort (O(n^2) worst)   !!!" << std::endl;
     std::cout << "!!! This may take a VERY LONG TIME for sizes >= 100k.      !!!" << std::endl;
-    std::cout << "!!! Library Sort is a STUB requiring manual implementation.!!!" << std::endl;
-    std::cout << "!!! Timsort is a SIMPLIFIED version requiring review/impl. !!!" << std::endl;
     std::cout << "!!! Verify code against assignment rules on AI usage.      !!!" << std::endl;
     std::cout << "!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!\n" << std::endl;
 
@@ -119,34 +152,26 @@ int main() {
         try {
              // Generate all 4 dataset types
              datasets = {
-                 {"Random", generate_random_array(size)},
-                 {"Reverse Sorted", generate_reverse_sorted_array(size)},
-                 {"Ascending Sorted", generate_ascending_sorted_array(size)}, // Added Ascending
-                 {"Partially Sorted", generate_partially_sorted_array(size)}
+                 {"Random", generate_dataset<int>("random", size)},
+                 {"Reverse Sorted", generate_dataset<int>("descending", size)},
+                 {"Ascending Sorted", generate_dataset<int>("ascending", size)},
+                 {"Partially Sorted", generate_dataset<int>("partial", size)}
              };
         } catch (const std::bad_alloc& e) {
-             std::lock_guard<std::mutex> lock(cout_mutex);
              std::cerr << "Failed to allocate memory for datasets of size " << size << ". Skipping." << std::endl;
              continue; // Skip to next size
         }
 
         std::cout << "--- Processing Size: " << size << " ---\n" << std::flush;
-        std::vector<std::thread> threads;
-        // Launch a thread for each of the 4 datasets
+        // One dataset at a time: nothing else runs while a sort is timed
         for (auto const& [label, data_vec] : datasets) {
-            threads.emplace_back(process_dataset, size, label, std::cref(data_vec));
-        }
-
-        // Wait for threads for this size (now 4 threads)
-        std::cout << "Waiting for " << threads.size() << " dataset tasks for size " << size << " to complete...\n" << std::flush;
-        for (auto& t : threads) {
-             if (t.joinable()) {
-                 t.join();
-             }
+            process_dataset(size, label, data_vec);
         }
         std::cout << "--- Finished Processing Size: " << size << " ---\n" << std::flush;
     }
 
+    run_large_comparison();
+
     std::cout << "\n=== All Benchmarks Complete ===\n" << std::flush;
     return 0;
 }
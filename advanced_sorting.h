@@ -5,139 +5,926 @@
 #include <algorithm> // for std::swap, std::min, std::max, std::distance, std::reverse, std::copy, std::copy_backward
 #include <cmath>     // For std::log2, std::floor
 #include <iterator>  //  std::iterator_traits, std::distance, std::next, std::prev
-#include <limits>    
-#include <iostream>  
-#include <stdexcept> 
-#include <functional> // needed for std::function IF recursive lambda kept
+#include <cstddef>   // std::ptrdiff_t
+#include <functional> // std::less
+#include <limits>
+#include <iostream>
+#include <stdexcept>
+#include <cstdint>   // std::uint32_t, std::uint64_t
+#include <cstring>   // std::memcpy
+#include <type_traits> // std::is_integral, std::is_floating_point, std::make_unsigned
+#include <array>
+
+#include "sort_common.h" // identity_projection, make_projected_compare
+#include "task_pool.h"   // TaskPool, TaskGroup, default_task_pool (parallel radix passes)
+#include "pdqsort.h"     // PdqsortImpl (introsort engine)
+#include "sort_counters.h" // SORT_COUNT_RECURSION (no-op unless SORT_COUNTERS)
+#include "sort_tuning.h"   // sort_tuning() (timsort min_merge, introsort insertion threshold)
+#include "sort_workspace.h" // SortWorkspace, sort_scratch (reusable scratch buffers)
+
+// Every algorithm below is a template over random-access iterators, a comparator and an
+// optional key projection; the std::vector<int> signatures are thin wrappers over them.
 
 // Helper function; Custom Insertion Sort for small ranges (for Introsort)
-template<typename Iterator>
-inline void custom_insertion_sort_range(Iterator begin, Iterator end) {
+template<typename Iterator, typename Compare = std::less<>>
+inline void custom_insertion_sort_range(Iterator begin, Iterator end, Compare comp = {}) {
     if (begin == end || std::next(begin) == end) return;
     for (Iterator current = std::next(begin); current != end; ++current) {
-        typename std::iterator_traits<Iterator>::value_type key = *current; 
+        typename std::iterator_traits<Iterator>::value_type key = std::move(*current);
         Iterator shifter = current;
         Iterator prev = std::prev(shifter);
 
-        while (shifter != begin && *prev > key) {
-            *shifter = *prev; 
+        while (shifter != begin && comp(key, *prev)) {
+            *shifter = std::move(*prev);
             --shifter;
             --prev;
         }
-        *shifter = key; 
+        *shifter = std::move(key);
     }
 }
  // LIBRARY SORT IMPLEMENTATION
-inline void library_sort(std::vector<int>& arr) {
-    std::vector<int> sortedArr;
-    for (int num : arr) {
-        auto pos = std::lower_bound(sortedArr.begin(), sortedArr.end(), num);
-        sortedArr.insert(pos, num);
+//
+// Gapped insertion sort: elements live in a slot array with empty gaps between them, so an
+// insert only shifts elements up to the nearest gap. Whenever the element count reaches a
+// power of two the array is respread so that k elements occupy (1 + epsilon) * 2k slots,
+// leaving room for the next k inserts. An insert whose window has no gap left (presorted or
+// duplicate-heavy input) respreads the surrounding region first, as in a packed-memory array.
+// Binary search steps over gaps. Expected cost is O(n log n); given the final size up front,
+// the slot array is allocated exactly once, and with a SortWorkspace not even that.
+
+const double LIBRARY_SORT_EPSILON = 1.0;    // extra gap space per element after a rebalance
+const std::size_t LIBRARY_SORT_WINDOW = 64; // inserts shift elements within one window of this many slots
+
+// Sorted buffer with cheap one-at-a-time inserts, also usable on its own (ingestion paths).
+// Equal elements keep insertion order.
+template<typename T, typename Compare = std::less<>>
+class GappedSortedBuffer {
+public:
+    explicit GappedSortedBuffer(double epsilon = LIBRARY_SORT_EPSILON, Compare comp = {}) : epsilon_(epsilon), comp_(comp) {
+        if (!(epsilon > 0.0)) throw std::invalid_argument("GappedSortedBuffer: epsilon must be > 0");
+    }
+
+    // Allocate room for n elements up front; no reallocation until size() exceeds n
+    void reserve(std::size_t n) {
+        expected_size_ = std::max(expected_size_, n);
+        std::size_t needed = slots_for(n);
+        if (slots_.size() < needed) {
+            slots_.resize(needed);
+            occupied_.resize(needed, 0);
+        }
+    }
+
+    void insert(T value) {
+        if (count_ == span_ || count_ == next_rebalance_) rebalance();
+        bool whole_span = false;
+        for (;;) {
+            std::size_t pos = upper_bound_slot(value);
+            if (pos < span_ && !occupied_[pos]) { place(pos, std::move(value)); break; }
+            if (pos > 0 && !occupied_[pos - 1]) { place(pos - 1, std::move(value)); break; }
+
+            // Shift toward the nearest gap inside pos's window (anywhere, once the whole span was respread)
+            std::size_t window = window_begin(pos, LIBRARY_SORT_WINDOW);
+            std::size_t begin = whole_span ? 0 : window;
+            std::size_t end = whole_span ? span_ : std::min(window + LIBRARY_SORT_WINDOW, span_);
+            if (shift_into_gap(pos, begin, end, value)) break;
+
+            // Full window (e.g. presorted or duplicate-heavy input): respread around it and retry
+            whole_span = respread_around(pos);
+        }
+        ++count_;
+    }
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    void clear() {
+        std::fill(occupied_.begin(), occupied_.end(), 0);
+        count_ = 0;
+        span_ = 0;
+        next_rebalance_ = 1;
+    }
+
+    // Visit the elements in sorted order
+    template<typename Func>
+    void for_each(Func func) const {
+        for (std::size_t i = 0; i < span_; ++i) {
+            if (occupied_[i]) func(slots_[i]);
+        }
+    }
+
+    template<typename OutputIt>
+    OutputIt copy_to(OutputIt out) const {
+        for_each([&out](const T& value) { *out++ = value; });
+        return out;
+    }
+
+    // Move the elements out in sorted order and leave the buffer empty (capacity is kept)
+    template<typename OutputIt>
+    OutputIt move_to(OutputIt out) {
+        for (std::size_t i = 0; i < span_; ++i) {
+            if (occupied_[i]) { *out++ = std::move(slots_[i]); occupied_[i] = 0; }
+        }
+        count_ = 0;
+        span_ = 0;
+        next_rebalance_ = 1;
+        return out;
+    }
+
+    // Swap in slot storage from elsewhere (a SortWorkspace) for an empty buffer to work in;
+    // release_storage hands it back. Neither allocates.
+    void adopt_storage(std::vector<T>& slots, std::vector<unsigned char>& occupied) {
+        clear();
+        slots_.swap(slots);
+        occupied_.swap(occupied);
+        occupied_.resize(slots_.size());
+        std::fill(occupied_.begin(), occupied_.end(), 0);
+    }
+    void release_storage(std::vector<T>& slots, std::vector<unsigned char>& occupied) {
+        clear();
+        slots_.swap(slots);
+        occupied_.swap(occupied);
+    }
+
+private:
+    std::size_t slots_for(std::size_t n) const {
+        return static_cast<std::size_t>(std::ceil((1.0 + epsilon_) * static_cast<double>(n))) + 1;
+    }
+
+    void place(std::size_t pos, T&& value) {
+        slots_[pos] = std::move(value);
+        occupied_[pos] = 1;
+    }
+
+    // First slot such that every element before it is <= value and every element from it on is > value
+    std::size_t upper_bound_slot(const T& value) {
+        std::size_t lo = 0, hi = span_;
+        while (lo < hi) {
+            std::size_t mid = lo + (hi - lo) / 2;
+            std::size_t m = mid;
+            while (m < hi && !occupied_[m]) ++m; // Skip the gap
+            if (m == hi || comp_(value, slots_[m])) hi = mid;
+            else lo = m + 1;
+        }
+        return lo;
+    }
+
+    // Move the elements of [begin, end) to the front of the range; returns how many there are
+    std::size_t compact(std::size_t begin, std::size_t end) {
+        std::size_t w = begin;
+        for (std::size_t i = begin; i < end; ++i) {
+            if (!occupied_[i]) continue;
+            if (i != w) {
+                slots_[w] = std::move(slots_[i]);
+                occupied_[w] = 1;
+                occupied_[i] = 0;
+            }
+            ++w;
+        }
+        return w - begin;
+    }
+
+    // Spread m compacted elements at begin evenly over [begin, end), starting from the back
+    // so every element moves to a slot at or after its own and nothing is overwritten
+    void spread(std::size_t begin, std::size_t m, std::size_t end) {
+        std::size_t len = end - begin;
+        for (std::size_t j = m; j-- > 0;) {
+            std::size_t t = j * len / m;
+            if (t != j) {
+                slots_[begin + t] = std::move(slots_[begin + j]);
+                occupied_[begin + t] = 1;
+                occupied_[begin + j] = 0;
+            }
+        }
+    }
+
+    void respread(std::size_t begin, std::size_t end) {
+        std::size_t m = compact(begin, end);
+        if (m > 0) spread(begin, m, end);
     }
-    arr = sortedArr;
+
+    // Start of the w-slot window holding pos: aligned to w, except that the last window
+    // ends at span_ so appends never land in a small leftover window
+    std::size_t window_begin(std::size_t pos, std::size_t w) const {
+        std::size_t begin = (std::min(pos, span_ - 1) / w) * w;
+        return span_ >= w ? std::min(begin, span_ - w) : 0;
+    }
+
+    // Open a slot at pos by shifting toward the nearest gap in [begin, end) and store value there
+    bool shift_into_gap(std::size_t pos, std::size_t begin, std::size_t end, T& value) {
+        std::size_t right = pos, left = pos;
+        while (right < end && occupied_[right]) ++right;
+        while (left > begin && occupied_[left - 1]) --left;
+        bool has_right = right < end, has_left = left > begin;
+        if (has_right && (!has_left || right - pos <= pos - left)) { // Shift [pos, right) one slot right
+            std::move_backward(slots_.begin() + pos, slots_.begin() + right, slots_.begin() + right + 1);
+            occupied_[right] = 1;
+            place(pos, std::move(value));
+            return true;
+        }
+        if (has_left) { // Shift [left, pos) one slot left
+            std::move(slots_.begin() + left, slots_.begin() + pos, slots_.begin() + left - 1);
+            occupied_[left - 1] = 1;
+            place(pos - 1, std::move(value));
+            return true;
+        }
+        return false;
+    }
+
+    // Respread the smallest aligned window around pos whose density stays under its level's
+    // bound, which falls from 1 for a single window to 1/2 for the whole span (packed-memory
+    // array rule, so repeated inserts into one region cost O(log^2 n) moves amortized).
+    // Returns true when the whole span had to be respread.
+    bool respread_around(std::size_t pos) {
+        std::size_t height = 1;
+        for (std::size_t w = 2 * LIBRARY_SORT_WINDOW; w < span_; w *= 2) ++height;
+        std::size_t level = 1;
+        for (std::size_t w = 2 * LIBRARY_SORT_WINDOW;; w *= 2, ++level) {
+            std::size_t begin = window_begin(pos, w), end = std::min(begin + w, span_);
+            if (begin == 0 && end == span_) {
+                respread(0, span_);
+                return true;
+            }
+            std::size_t used = 1; // the element about to be inserted
+            for (std::size_t i = begin; i < end; ++i) used += occupied_[i];
+            double bound = 1.0 - 0.5 * static_cast<double>(level) / static_cast<double>(height);
+            if (static_cast<double>(used) <= bound * static_cast<double>(end - begin)) {
+                respread(begin, end);
+                return false;
+            }
+        }
+    }
+
+    // Respread count_ elements evenly over (1 + epsilon) * 2 * count_ slots
+    void rebalance() {
+        std::size_t k = std::max<std::size_t>(count_, 1);
+        std::size_t target = slots_for(2 * k);
+        if (expected_size_ > count_) target = std::min(target, slots_for(expected_size_));
+        target = std::max(target, count_ + 1);
+        if (slots_.size() < target) {
+            slots_.resize(target);
+            occupied_.resize(target, 0);
+        }
+        if (count_ > 0) spread(0, compact(0, span_), target);
+        span_ = target;
+        next_rebalance_ = 2 * k;
+    }
+
+    double epsilon_;
+    Compare comp_;
+    std::vector<T> slots_;
+    std::vector<unsigned char> occupied_;
+    std::size_t count_ = 0;          // elements stored
+    std::size_t span_ = 0;           // slots in use; elements and gaps all live in [0, span_)
+    std::size_t next_rebalance_ = 1; // element count that triggers the next respread
+    std::size_t expected_size_ = 0;  // size hint from reserve()
+};
+
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void library_sort(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}, double epsilon = LIBRARY_SORT_EPSILON,
+                         SortWorkspace* workspace = nullptr) {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    std::ptrdiff_t n = last - first;
+    if (n < 2) return;
+    auto cmp = make_projected_compare(comp, proj);
+    GappedSortedBuffer<value_type, decltype(cmp)> buffer(epsilon, cmp);
+    if (workspace) buffer.adopt_storage(workspace->buffer<value_type>(0), workspace->buffer<unsigned char>(0, 1));
+    buffer.reserve(static_cast<std::size_t>(n));
+    for (RandomIt it = first; it != last; ++it) buffer.insert(std::move(*it));
+    buffer.move_to(first);
+    if (workspace) buffer.release_storage(workspace->buffer<value_type>(0), workspace->buffer<unsigned char>(0, 1));
+}
+inline void library_sort(std::vector<int>& arr, SortWorkspace* workspace = nullptr) {
+    library_sort(arr.begin(), arr.end(), std::less<>(), identity_projection(), LIBRARY_SORT_EPSILON, workspace);
 }
 
 // TIMSORT implementation
-namespace TimsortImpl { const int MIN_MERGE = 32; int calc_min_run(int n) { int r = 0; while (n >= MIN_MERGE) { r |= (n & 1); n >>= 1; } return n + r; }
-void merge_runs(std::vector<int>& arr, int l, int m, int r) { int len1 = m - l + 1, len2 = r - m; if (len1 <= 0 || len2 <= 0) return; std::vector<int> left_part(len1); std::vector<int> right_part(len2); std::copy(arr.begin() + l, arr.begin() + m + 1, left_part.begin()); std::copy(arr.begin() + m + 1, arr.begin() + r + 1, right_part.begin()); int i = 0, j = 0, k = l; while (i < len1 && j < len2) { arr[k++] = (left_part[i] <= right_part[j]) ? left_part[i++] : right_part[j++]; } while (i < len1) arr[k++] = left_part[i++]; while (j < len2) arr[k++] = right_part[j++]; } }
-inline void tim_sort(std::vector<int>& arr) { int n = arr.size(); if (n < 2) return; int min_run = TimsortImpl::calc_min_run(n); for (int start = 0; start < n; start += min_run) { int end = std::min(start + min_run - 1, n - 1); custom_insertion_sort_range(arr.begin() + start, arr.begin() + end + 1); } for (int size = min_run; size < n; size = 2 * size) { for (int left = 0; left < n; left += 2 * size) { int mid = left + size - 1; int right = std::min((left + 2 * size - 1), (n - 1)); if (mid < right) { TimsortImpl::merge_runs(arr, left, mid, right); } } } }
+//
+// Natural runs (strictly descending ones reversed in place) are extended to minrun with
+// binary insertion sort and pushed on a run stack whose lengths keep the invariants
+// len[i-2] > len[i-1] + len[i] and len[i-1] > len[i]. Merges gallop once one side wins
+// min_gallop times in a row, with min_gallop adapting to how well galloping pays off.
+// All merges share one scratch buffer of at most n/2 elements, which together with the run
+// stack can come from a SortWorkspace so repeated sorts allocate nothing. Presorted input is a
+// single run and costs n - 1 comparisons. minrun lies in [min_merge/2, min_merge], with
+// min_merge = sort_tuning().timsort_min_merge (default 32).
+namespace TimsortImpl {
+const int MIN_GALLOP = 7;
 
+inline std::ptrdiff_t calc_min_run(std::ptrdiff_t n, std::ptrdiff_t min_merge) { std::ptrdiff_t r = 0; while (n >= min_merge) { r |= (n & 1); n >>= 1; } return n + r; }
 
-// COCKTAIL SHAKER SORT IMPLEMENTATION
-inline void cocktail_shaker_sort(std::vector<int>& arr) { 
-    int n = arr.size(); if (n < 2) return; bool swapped = true; int start = 0; int end = n - 1; while (swapped) { swapped = false; for (int i = start; i < end; ++i) { if (arr[i] > arr[i + 1]) { std::swap(arr[i], arr[i + 1]); swapped = true; } } if (!swapped) break; swapped = false; --end; for (int i = end - 1; i >= start; --i) { if (arr[i] > arr[i + 1]) { std::swap(arr[i], arr[i + 1]); swapped = true; } } ++start; } }
+// Length of the run starting at lo; a strictly descending run is reversed so it ascends
+template<typename RandomIt, typename Compare>
+std::ptrdiff_t count_run_and_make_ascending(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare& comp) {
+    std::ptrdiff_t run_hi = lo + 1;
+    if (run_hi == hi) return 1;
+    if (comp(a[run_hi++], a[lo])) {
+        while (run_hi < hi && comp(a[run_hi], a[run_hi - 1])) run_hi++;
+        std::reverse(a + lo, a + run_hi);
+    } else {
+        while (run_hi < hi && !comp(a[run_hi], a[run_hi - 1])) run_hi++;
+    }
+    return run_hi - lo;
+}
 
-// COMB_SORT IMPLEMENTATION
-inline int comb_sort_get_next_gap(int gap) { 
-    gap = static_cast<int>(std::floor(static_cast<double>(gap) / 1.3)); return std::max(1, gap); }
-inline void comb_sort(std::vector<int>& arr) {
-    int n = arr.size(); if (n < 2) return; int gap = n; bool swapped = true; while (gap != 1 || swapped == true) { gap = comb_sort_get_next_gap(gap); swapped = false; for (int i = 0; i < n - gap; ++i) { if (arr[i] > arr[i + gap]) { std::swap(arr[i], arr[i + gap]); swapped = true; } } } }
+// Sorts [lo, hi) given that [lo, start) is already sorted
+template<typename RandomIt, typename Compare>
+void binary_insertion_sort(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, std::ptrdiff_t start, Compare& comp) {
+    if (start == lo) start++;
+    for (; start < hi; start++) {
+        auto pivot = std::move(a[start]);
+        RandomIt pos = std::upper_bound(a + lo, a + start, pivot, comp);
+        std::move_backward(pos, a + start, a + start + 1);
+        *pos = std::move(pivot);
+    }
+}
 
-// TOURNAMENT SORT IMPLEMENTATION
-inline void custom_heapify_down(std::vector<int>& arr, int n, int i) { 
-    int largest = i; int left = 2 * i + 1; int right = 2 * i + 2; if (left < n && arr[left] > arr[largest]) largest = left; if (right < n && arr[right] > arr[largest]) largest = right; if (largest != i) { std::swap(arr[i], arr[largest]); custom_heapify_down(arr, n, largest); } }
-inline void custom_build_max_heap(std::vector<int>& arr) { 
-    int n = arr.size(); for (int i = n / 2 - 1; i >= 0; --i) { custom_heapify_down(arr, n, i); } }
-inline void tournament_sort(std::vector<int>& arr) { 
-    int n = arr.size(); if (n < 2) return; custom_build_max_heap(arr); for (int i = n - 1; i > 0; --i) { std::swap(arr[0], arr[i]); custom_heapify_down(arr, i, 0); } }
+// Leftmost position to insert key into sorted base[0, len), searching outward from hint
+template<typename T, typename It, typename Compare>
+std::ptrdiff_t gallop_left(const T& key, It base, std::ptrdiff_t len, std::ptrdiff_t hint, Compare& comp) {
+    std::ptrdiff_t last_ofs = 0, ofs = 1;
+    if (comp(base[hint], key)) {
+        std::ptrdiff_t max_ofs = len - hint;
+        while (ofs < max_ofs && comp(base[hint + ofs], key)) { last_ofs = ofs; ofs = (ofs << 1) + 1; }
+        if (ofs > max_ofs) ofs = max_ofs;
+        last_ofs += hint;
+        ofs += hint;
+    } else {
+        std::ptrdiff_t max_ofs = hint + 1;
+        while (ofs < max_ofs && !comp(base[hint - ofs], key)) { last_ofs = ofs; ofs = (ofs << 1) + 1; }
+        if (ofs > max_ofs) ofs = max_ofs;
+        std::ptrdiff_t tmp = last_ofs;
+        last_ofs = hint - ofs;
+        ofs = hint - tmp;
+    }
+    last_ofs++;
+    while (last_ofs < ofs) {
+        std::ptrdiff_t m = last_ofs + ((ofs - last_ofs) >> 1);
+        if (comp(base[m], key)) last_ofs = m + 1;
+        else ofs = m;
+    }
+    return ofs;
+}
 
-// INTROSORT IMPLEMENTATION
+// Rightmost position to insert key into sorted base[0, len), searching outward from hint
+template<typename T, typename It, typename Compare>
+std::ptrdiff_t gallop_right(const T& key, It base, std::ptrdiff_t len, std::ptrdiff_t hint, Compare& comp) {
+    std::ptrdiff_t last_ofs = 0, ofs = 1;
+    if (comp(key, base[hint])) {
+        std::ptrdiff_t max_ofs = hint + 1;
+        while (ofs < max_ofs && comp(key, base[hint - ofs])) { last_ofs = ofs; ofs = (ofs << 1) + 1; }
+        if (ofs > max_ofs) ofs = max_ofs;
+        std::ptrdiff_t tmp = last_ofs;
+        last_ofs = hint - ofs;
+        ofs = hint - tmp;
+    } else {
+        std::ptrdiff_t max_ofs = len - hint;
+        while (ofs < max_ofs && !comp(key, base[hint + ofs])) { last_ofs = ofs; ofs = (ofs << 1) + 1; }
+        if (ofs > max_ofs) ofs = max_ofs;
+        last_ofs += hint;
+        ofs += hint;
+    }
+    last_ofs++;
+    while (last_ofs < ofs) {
+        std::ptrdiff_t m = last_ofs + ((ofs - last_ofs) >> 1);
+        if (comp(key, base[m])) ofs = m;
+        else last_ofs = m + 1;
+    }
+    return ofs;
+}
+
+// Run stack, adaptive gallop threshold and the shared scratch buffer for one sort. The
+// buffer and the stack live in the workspace when one is given (slots 0, 1 and 2).
+template<typename RandomIt, typename Compare>
+class TimSortState {
+public:
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
 
-const int INTROSORT_INSERTION_THRESHOLD = 16; 
+    TimSortState(RandomIt a, std::ptrdiff_t n, Compare comp, SortWorkspace* workspace = nullptr)
+        : a_(a), n_(n), comp_(comp), tmp_(sort_scratch(workspace, local_tmp_, 0, 0)),
+          run_base_(sort_scratch(workspace, local_base_, 0, 1)), run_len_(sort_scratch(workspace, local_len_, 0, 2)) {
+        run_base_.clear();
+        run_len_.clear();
+    }
+
+    void push_run(std::ptrdiff_t base, std::ptrdiff_t len) {
+        run_base_.push_back(base);
+        run_len_.push_back(len);
+    }
 
-inline int custom_partition_qs(std::vector<int>& arr, int low, int high) { 
-    if (low >= high) return low; int pivot = arr[high]; int i = low - 1; for (int j = low; j < high; ++j) { if (arr[j] <= pivot) { i++; std::swap(arr[i], arr[j]); } } std::swap(arr[i + 1], arr[high]); return i + 1; }
+    // Merge until the run-length invariants hold again
+    void merge_collapse() {
+        while (run_len_.size() > 1) {
+            std::ptrdiff_t n = static_cast<std::ptrdiff_t>(run_len_.size()) - 2;
+            if ((n > 0 && run_len_[n - 1] <= run_len_[n] + run_len_[n + 1]) ||
+                (n > 1 && run_len_[n - 2] <= run_len_[n] + run_len_[n - 1])) {
+                if (run_len_[n - 1] < run_len_[n + 1]) n--;
+            } else if (run_len_[n] > run_len_[n + 1]) {
+                break;
+            }
+            merge_at(n);
+        }
+    }
 
-inline void custom_median_of_three_qs(std::vector<int>& arr, int low, int high) { 
-     if (low >= high) return; int mid = low + (high - low) / 2; if (arr[low] > arr[mid]) std::swap(arr[low], arr[mid]); if (arr[low] > arr[high]) std::swap(arr[low], arr[high]); if (arr[mid] > arr[high]) std::swap(arr[mid], arr[high]); std::swap(arr[mid], arr[high]); }
+    void merge_force_collapse() {
+        while (run_len_.size() > 1) {
+            std::ptrdiff_t n = static_cast<std::ptrdiff_t>(run_len_.size()) - 2;
+            if (n > 0 && run_len_[n - 1] < run_len_[n + 1]) n--;
+            merge_at(n);
+        }
+    }
 
-// Helper function for heapify on a range
-inline void custom_heapify_down_range(std::vector<int>& arr, int low, int n_range, int i_heap) {
-    int largest_heap = i_heap; 
-    int l_heap = 2 * i_heap + 1;
-    int r_heap = 2 * i_heap + 2;
+private:
+    // Merge stack runs i and i + 1
+    void merge_at(std::ptrdiff_t i) {
+        std::ptrdiff_t base1 = run_base_[i], len1 = run_len_[i];
+        std::ptrdiff_t base2 = run_base_[i + 1], len2 = run_len_[i + 1];
+        run_len_[i] = len1 + len2;
+        run_base_.erase(run_base_.begin() + i + 1);
+        run_len_.erase(run_len_.begin() + i + 1);
 
-    int current_arr_idx = low + i_heap;
-    int largest_arr_idx = low + largest_heap; 
+        // Elements of run1 already in place, and of run2 already at the end, take no part in the merge
+        std::ptrdiff_t k = gallop_right(a_[base2], a_ + base1, len1, 0, comp_);
+        base1 += k;
+        len1 -= k;
+        if (len1 == 0) return;
+        len2 = gallop_left(a_[base1 + len1 - 1], a_ + base2, len2, len2 - 1, comp_);
+        if (len2 == 0) return;
 
-    if (l_heap < n_range && arr[low + l_heap] > arr[largest_arr_idx]) {
-        largest_heap = l_heap;
-        largest_arr_idx = low + largest_heap; 
+        if (len1 <= len2) merge_lo(base1, len1, base2, len2);
+        else merge_hi(base1, len1, base2, len2);
     }
 
-    if (r_heap < n_range && arr[low + r_heap] > arr[largest_arr_idx]) {
-        largest_heap = r_heap;
-        largest_arr_idx = low + largest_heap; 
+    typename std::vector<value_type>::iterator ensure_capacity(std::ptrdiff_t min_capacity) {
+        if (static_cast<std::ptrdiff_t>(tmp_.size()) < min_capacity) {
+            std::ptrdiff_t capacity = 1;
+            while (capacity < min_capacity) capacity <<= 1;
+            tmp_.resize(std::min(capacity, std::max(min_capacity, n_ / 2)));
+        }
+        return tmp_.begin();
     }
 
-    if (largest_heap != i_heap) {
-        std::swap(arr[current_arr_idx], arr[largest_arr_idx]);
-        custom_heapify_down_range(arr, low, n_range, largest_heap);
+    [[noreturn]] static void comparison_violation() {
+        throw std::invalid_argument("tim_sort: comparison function violates strict weak ordering");
     }
-}
 
+    // Merge adjacent runs with len1 <= len2: run1 goes to the buffer, merge front to back
+    void merge_lo(std::ptrdiff_t base1, std::ptrdiff_t len1, std::ptrdiff_t base2, std::ptrdiff_t len2) {
+        auto tmp = ensure_capacity(len1);
+        std::move(a_ + base1, a_ + base1 + len1, tmp);
+        std::ptrdiff_t cursor1 = 0, cursor2 = base2, dest = base1;
 
-// Recursive helper for Introsort
-inline void introsort_recursive(std::vector<int>& arr, int low, int high, int depth_limit) {
-    int size = high - low + 1;
+        a_[dest++] = std::move(a_[cursor2++]);
+        if (--len2 == 0) { std::move(tmp + cursor1, tmp + cursor1 + len1, a_ + dest); return; }
+        if (len1 == 1) { std::move(a_ + cursor2, a_ + cursor2 + len2, a_ + dest); a_[dest + len2] = std::move(tmp[cursor1]); return; }
 
-    if (size <= INTROSORT_INSERTION_THRESHOLD) {
-        custom_insertion_sort_range(arr.begin() + low, arr.begin() + high + 1);
-        return;
+        int min_gallop = min_gallop_;
+        for (;;) {
+            std::ptrdiff_t count1 = 0, count2 = 0; // consecutive wins of each run
+
+            // One element at a time until one run wins consistently
+            do {
+                if (comp_(a_[cursor2], tmp[cursor1])) {
+                    a_[dest++] = std::move(a_[cursor2++]);
+                    count2++; count1 = 0;
+                    if (--len2 == 0) goto merge_done;
+                } else {
+                    a_[dest++] = std::move(tmp[cursor1++]);
+                    count1++; count2 = 0;
+                    if (--len1 == 1) goto merge_done;
+                }
+            } while ((count1 | count2) < min_gallop);
+
+            // Galloping mode, until neither run wins by MIN_GALLOP or more
+            do {
+                count1 = gallop_right(a_[cursor2], tmp + cursor1, len1, 0, comp_);
+                if (count1 != 0) {
+                    std::move(tmp + cursor1, tmp + cursor1 + count1, a_ + dest);
+                    dest += count1; cursor1 += count1; len1 -= count1;
+                    if (len1 <= 1) goto merge_done;
+                }
+                a_[dest++] = std::move(a_[cursor2++]);
+                if (--len2 == 0) goto merge_done;
+
+                count2 = gallop_left(tmp[cursor1], a_ + cursor2, len2, 0, comp_);
+                if (count2 != 0) {
+                    std::move(a_ + cursor2, a_ + cursor2 + count2, a_ + dest);
+                    dest += count2; cursor2 += count2; len2 -= count2;
+                    if (len2 == 0) goto merge_done;
+                }
+                a_[dest++] = std::move(tmp[cursor1++]);
+                if (--len1 == 1) goto merge_done;
+                min_gallop--;
+            } while (count1 >= MIN_GALLOP || count2 >= MIN_GALLOP);
+            if (min_gallop < 0) min_gallop = 0;
+            min_gallop += 2; // Penalize leaving galloping mode
+        }
+    merge_done:
+        min_gallop_ = std::max(1, min_gallop);
+
+        if (len1 == 1) {
+            std::move(a_ + cursor2, a_ + cursor2 + len2, a_ + dest);
+            a_[dest + len2] = std::move(tmp[cursor1]);
+        } else if (len1 == 0) {
+            comparison_violation();
+        } else {
+            std::move(tmp + cursor1, tmp + cursor1 + len1, a_ + dest);
+        }
     }
 
-    if (depth_limit == 0) {
-        int n_range = high - low + 1;
-        if (n_range < 2) return; // Already sorted range
+    // Merge adjacent runs with len1 > len2: run2 goes to the buffer, merge back to front
+    void merge_hi(std::ptrdiff_t base1, std::ptrdiff_t len1, std::ptrdiff_t base2, std::ptrdiff_t len2) {
+        auto tmp = ensure_capacity(len2);
+        std::move(a_ + base2, a_ + base2 + len2, tmp);
+        std::ptrdiff_t cursor1 = base1 + len1 - 1, cursor2 = len2 - 1, dest = base2 + len2 - 1;
 
-        // Build heap on the range [low, high] using the helper function
-        for (int i_heap = n_range / 2 - 1; i_heap >= 0; --i_heap) {
-            custom_heapify_down_range(arr, low, n_range, i_heap);
+        a_[dest--] = std::move(a_[cursor1--]);
+        if (--len1 == 0) { std::move(tmp, tmp + len2, a_ + (dest - (len2 - 1))); return; }
+        if (len2 == 1) {
+            dest -= len1; cursor1 -= len1;
+            std::move_backward(a_ + (cursor1 + 1), a_ + (cursor1 + 1 + len1), a_ + (dest + 1 + len1));
+            a_[dest] = std::move(tmp[cursor2]);
+            return;
         }
-        // Extract elements (Heap Sort)
-        for (int i_range = n_range - 1; i_range > 0; --i_range) {
-            std::swap(arr[low], arr[low + i_range]);
-            custom_heapify_down_range(arr, low, i_range, 0);
+
+        int min_gallop = min_gallop_;
+        for (;;) {
+            std::ptrdiff_t count1 = 0, count2 = 0;
+
+            do {
+                if (comp_(tmp[cursor2], a_[cursor1])) {
+                    a_[dest--] = std::move(a_[cursor1--]);
+                    count1++; count2 = 0;
+                    if (--len1 == 0) goto merge_done;
+                } else {
+                    a_[dest--] = std::move(tmp[cursor2--]);
+                    count2++; count1 = 0;
+                    if (--len2 == 1) goto merge_done;
+                }
+            } while ((count1 | count2) < min_gallop);
+
+            do {
+                count1 = len1 - gallop_right(tmp[cursor2], a_ + base1, len1, len1 - 1, comp_);
+                if (count1 != 0) {
+                    dest -= count1; cursor1 -= count1; len1 -= count1;
+                    std::move_backward(a_ + (cursor1 + 1), a_ + (cursor1 + 1 + count1), a_ + (dest + 1 + count1));
+                    if (len1 == 0) goto merge_done;
+                }
+                a_[dest--] = std::move(tmp[cursor2--]);
+                if (--len2 == 1) goto merge_done;
+
+                count2 = len2 - gallop_left(a_[cursor1], tmp, len2, len2 - 1, comp_);
+                if (count2 != 0) {
+                    dest -= count2; cursor2 -= count2; len2 -= count2;
+                    std::move(tmp + (cursor2 + 1), tmp + (cursor2 + 1 + count2), a_ + (dest + 1));
+                    if (len2 <= 1) goto merge_done;
+                }
+                a_[dest--] = std::move(a_[cursor1--]);
+                if (--len1 == 0) goto merge_done;
+                min_gallop--;
+            } while (count1 >= MIN_GALLOP || count2 >= MIN_GALLOP);
+            if (min_gallop < 0) min_gallop = 0;
+            min_gallop += 2;
         }
+    merge_done:
+        min_gallop_ = std::max(1, min_gallop);
+
+        if (len2 == 1) {
+            dest -= len1; cursor1 -= len1;
+            std::move_backward(a_ + (cursor1 + 1), a_ + (cursor1 + 1 + len1), a_ + (dest + 1 + len1));
+            a_[dest] = std::move(tmp[cursor2]);
+        } else if (len2 == 0) {
+            comparison_violation();
+        } else {
+            std::move(tmp, tmp + len2, a_ + (dest - (len2 - 1)));
+        }
+    }
+
+    RandomIt a_;
+    std::ptrdiff_t n_;
+    Compare comp_;
+    int min_gallop_ = MIN_GALLOP;
+    std::vector<value_type> local_tmp_; // Used without a workspace
+    std::vector<std::ptrdiff_t> local_base_, local_len_;
+    std::vector<value_type>& tmp_;
+    std::vector<std::ptrdiff_t>& run_base_;
+    std::vector<std::ptrdiff_t>& run_len_;
+};
+} // namespace TimsortImpl
+
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void tim_sort(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}, SortWorkspace* workspace = nullptr) {
+    auto cmp = make_projected_compare(comp, proj);
+    std::ptrdiff_t n = last - first;
+    if (n < 2) return;
+
+    // Small arrays: one run plus binary insertion, no merging
+    const std::ptrdiff_t min_merge = sort_tuning().timsort_min_merge;
+    if (n < min_merge) {
+        std::ptrdiff_t init_run_len = TimsortImpl::count_run_and_make_ascending(first, 0, n, cmp);
+        TimsortImpl::binary_insertion_sort(first, 0, n, init_run_len, cmp);
         return;
     }
 
-    // proceeding with quick sort part
-    custom_median_of_three_qs(arr, low, high); // choosing pivot
-    int p = custom_partition_qs(arr, low, high); // partition
+    TimsortImpl::TimSortState<RandomIt, decltype(cmp)> state(first, n, cmp, workspace);
+    std::ptrdiff_t min_run = TimsortImpl::calc_min_run(n, min_merge);
+    std::ptrdiff_t lo = 0, remaining = n;
+    do {
+        std::ptrdiff_t run_len = TimsortImpl::count_run_and_make_ascending(first, lo, n, cmp);
+        if (run_len < min_run) { // Extend short runs to min_run
+            std::ptrdiff_t force = std::min(remaining, min_run);
+            TimsortImpl::binary_insertion_sort(first, lo, lo + force, lo + run_len, cmp);
+            run_len = force;
+        }
+        state.push_run(lo, run_len);
+        state.merge_collapse();
+        lo += run_len;
+        remaining -= run_len;
+    } while (remaining != 0);
+    state.merge_force_collapse();
+}
+inline void tim_sort(std::vector<int>& arr, SortWorkspace* workspace = nullptr) {
+    tim_sort(arr.begin(), arr.end(), std::less<>(), identity_projection(), workspace);
+}
+
 
-    // Recurse
-    introsort_recursive(arr, low, p - 1, depth_limit - 1);
-    introsort_recursive(arr, p + 1, high, depth_limit - 1);
+// COCKTAIL SHAKER SORT IMPLEMENTATION
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void cocktail_shaker_sort(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}) {
+    auto cmp = make_projected_compare(comp, proj); std::ptrdiff_t n = last - first; if (n < 2) return; bool swapped = true; std::ptrdiff_t start = 0; std::ptrdiff_t end = n - 1; while (swapped) { swapped = false; for (std::ptrdiff_t i = start; i < end; ++i) { if (cmp(first[i + 1], first[i])) { std::swap(first[i], first[i + 1]); swapped = true; } } if (!swapped) break; swapped = false; --end; for (std::ptrdiff_t i = end - 1; i >= start; --i) { if (cmp(first[i + 1], first[i])) { std::swap(first[i], first[i + 1]); swapped = true; } } ++start; } }
+inline void cocktail_shaker_sort(std::vector<int>& arr) { cocktail_shaker_sort(arr.begin(), arr.end()); }
+
+// COMB_SORT IMPLEMENTATION
+inline std::ptrdiff_t comb_sort_get_next_gap(std::ptrdiff_t gap) {
+    gap = static_cast<std::ptrdiff_t>(std::floor(static_cast<double>(gap) / 1.3)); return std::max<std::ptrdiff_t>(1, gap); }
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void comb_sort(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}) {
+    auto cmp = make_projected_compare(comp, proj); std::ptrdiff_t n = last - first; if (n < 2) return; std::ptrdiff_t gap = n; bool swapped = true; while (gap != 1 || swapped == true) { gap = comb_sort_get_next_gap(gap); swapped = false; for (std::ptrdiff_t i = 0; i < n - gap; ++i) { if (cmp(first[i + gap], first[i])) { std::swap(first[i], first[i + gap]); swapped = true; } } } }
+inline void comb_sort(std::vector<int>& arr) { comb_sort(arr.begin(), arr.end()); }
+
+// TOURNAMENT SORT IMPLEMENTATION
+// A binary tournament: the binary heap of heap_engine.h, with each winner's replacement
+// played down to a leaf and back up (Floyd's bottom-up sift, about log2 n comparisons)
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void tournament_sort(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}) {
+    auto cmp = make_projected_compare(comp, proj);
+    heap_sort_range<2>(first, last, cmp, false);
+}
+inline void tournament_sort(std::vector<int>& arr) { tournament_sort(arr.begin(), arr.end()); }
+
+// INTROSORT IMPLEMENTATION
+
+// Recursive helper for Introsort: quicksort on the pdqsort engine (block partitioning, ninther
+// pivot, equal-key splitting) with heapsort once depth_limit bad partitions have been seen and
+// a sorting network or insertion sort below sort_tuning().introsort_insertion_threshold (default 16)
+template<typename RandomIt, typename Compare>
+inline void introsort_recursive(RandomIt arr, std::ptrdiff_t low, std::ptrdiff_t high, int depth_limit, Compare comp) {
+    if (high <= low) return;
+    PdqsortImpl::pdqsort_sequential(arr + low, arr + high + 1, comp, std::max(depth_limit, 1), true, sort_tuning().introsort_insertion_threshold);
 }
 
 // Introsort function
-inline void introsort(std::vector<int>& arr) {
-    int n = arr.size();
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void introsort(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}) {
+    std::ptrdiff_t n = last - first;
     if (n < 2) return;
     int depth_limit = 2 * static_cast<int>(std::floor(std::log2(static_cast<double>(n))));
-    introsort_recursive(arr, 0, n - 1, depth_limit);
+    introsort_recursive(first, 0, n - 1, depth_limit, make_projected_compare(comp, proj));
+}
+inline void introsort(std::vector<int>& arr) {
+    introsort(arr.begin(), arr.end());
+}
+
+
+// RADIX SORT IMPLEMENTATION
+//
+// LSD radix sort with 8/11/16-bit digits for 32/64-bit integer and IEEE float keys.
+// Keys are mapped to unsigned integers whose order matches the numeric order
+// (sign bit flipped for signed ints; for floats negatives are inverted, positives
+// get the sign bit set), so every pass is a plain counting sort. Digits that are
+// identical across the whole input are skipped. Histograms and scatter run per
+// chunk on the TaskPool. When n * sizeof(T) of scratch exceeds the memory budget,
+// an in-place MSD (American flag) sort is used instead.
+//
+// NaNs sort by bit pattern: negative NaNs first, positive NaNs last; -0.0 before +0.0.
+
+const int RADIX_INSERTION_THRESHOLD = 32;      // ranges this small use insertion sort on the encoded key
+const std::ptrdiff_t RADIX_MIN_CHUNK = 1 << 16; // smallest per-thread chunk for parallel histogram/scatter
+
+struct RadixSortOptions {
+    int digit_bits = 0;                                           // 8, 11 or 16; 0 picks by input size
+    std::size_t memory_budget = std::numeric_limits<std::size_t>::max(); // max scratch bytes for LSD
+    TaskPool* pool = nullptr;                                     // nullptr uses default_task_pool()
+    SortWorkspace* workspace = nullptr;                           // LSD buffer and counts; nullptr allocates per call
+};
+
+namespace RadixSortImpl {
+
+template<typename Key, typename Enable = void>
+struct key_traits;
+
+template<typename Key>
+struct key_traits<Key, typename std::enable_if<std::is_integral<Key>::value && std::is_unsigned<Key>::value>::type> {
+    using type = Key;
+    static type encode(Key k) { return k; }
+};
+
+template<typename Key>
+struct key_traits<Key, typename std::enable_if<std::is_integral<Key>::value && std::is_signed<Key>::value>::type> {
+    using type = typename std::make_unsigned<Key>::type;
+    static type encode(Key k) { return static_cast<type>(k) ^ (type(1) << (sizeof(type) * 8 - 1)); }
+};
+
+template<typename Key>
+struct key_traits<Key, typename std::enable_if<std::is_floating_point<Key>::value>::type> {
+    static_assert(sizeof(Key) == 4 || sizeof(Key) == 8, "radix_sort supports 32- and 64-bit IEEE floats only");
+    using type = typename std::conditional<sizeof(Key) == 4, std::uint32_t, std::uint64_t>::type;
+    static type encode(Key k) {
+        type bits;
+        std::memcpy(&bits, &k, sizeof(bits));
+        const type sign = type(1) << (sizeof(type) * 8 - 1);
+        return (bits & sign) ? ~bits : (bits | sign);
+    }
+};
+
+// Encoded unsigned key of an element under the projection
+template<typename Proj>
+struct KeyEncoder {
+    Proj proj;
+    template<typename T>
+    auto operator()(const T& value) {
+        using key_type = typename std::decay<decltype(std::invoke(proj, value))>::type;
+        return key_traits<key_type>::encode(std::invoke(proj, value));
+    }
+};
+
+// Run body(chunk) for every chunk, chunk 0 on the calling thread
+template<typename Body>
+inline void for_each_chunk(TaskPool& pool, std::ptrdiff_t chunks, Body body) {
+    if (chunks == 1) { body(0); return; }
+    TaskGroup group(pool);
+    for (std::ptrdiff_t c = 1; c < chunks; ++c) group.run([&body, c]() { body(c); });
+    body(0);
+    group.wait();
+}
+
+template<typename RandomIt, typename Encoder>
+inline void insertion_sort_by_key(RandomIt first, RandomIt last, Encoder& encode) {
+    custom_insertion_sort_range(first, last, [&encode](const auto& a, const auto& b) { return encode(a) < encode(b); });
+}
+
+template<typename RandomIt, typename Encoder>
+void lsd_radix_sort(RandomIt first, std::ptrdiff_t n, Encoder encode, int digit_bits, TaskPool& pool, SortWorkspace* workspace) {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    using ukey = decltype(encode(*first));
+    const int key_bits = static_cast<int>(sizeof(ukey) * 8);
+    const std::size_t buckets = std::size_t(1) << digit_bits;
+    const ukey mask = static_cast<ukey>(buckets - 1);
+
+    std::ptrdiff_t chunks = std::max<std::ptrdiff_t>(1, std::min<std::ptrdiff_t>(pool.thread_count(), n / RADIX_MIN_CHUNK));
+    std::ptrdiff_t chunk_len = (n + chunks - 1) / chunks;
+    auto chunk_begin = [&](std::ptrdiff_t c) { return std::min(n, c * chunk_len); };
+
+    // Bits that differ from the first key anywhere in the input; constant digits need no pass
+    const ukey first_key = encode(first[0]);
+    std::vector<ukey> local_varying;
+    std::vector<ukey>& varying = sort_scratch(workspace, local_varying, static_cast<std::size_t>(chunks), 2);
+    for_each_chunk(pool, chunks, [&](std::ptrdiff_t c) {
+        Encoder enc = encode;
+        ukey acc = 0;
+        for (std::ptrdiff_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) acc |= enc(first[i]) ^ first_key;
+        varying[c] = acc;
+    });
+    ukey varying_bits = 0;
+    for (std::ptrdiff_t c = 0; c < chunks; ++c) varying_bits |= varying[c];
+    if (varying_bits == 0) return; // all keys equal
+
+    std::vector<value_type> local_buffer;
+    std::vector<std::size_t> local_counts;
+    std::vector<value_type>& buffer = sort_scratch(workspace, local_buffer, static_cast<std::size_t>(n), 0);
+    std::vector<std::size_t>& counts = sort_scratch(workspace, local_counts, static_cast<std::size_t>(chunks) * buckets, 1);
+    bool in_buffer = false;
+
+    for (int shift = 0; shift < key_bits; shift += digit_bits) {
+        if (((varying_bits >> shift) & mask) == 0) continue;
+
+        auto scatter = [&](auto src, auto dst) {
+            // Per-chunk histograms of this digit
+            for_each_chunk(pool, chunks, [&](std::ptrdiff_t c) {
+                Encoder enc = encode;
+                std::size_t* hist = &counts[c * buckets];
+                std::fill(hist, hist + buckets, 0);
+                for (std::ptrdiff_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) ++hist[(enc(src[i]) >> shift) & mask];
+            });
+            // Exclusive prefix sum, bucket-major then chunk, keeps the scatter stable
+            std::size_t total = 0;
+            for (std::size_t b = 0; b < buckets; ++b) {
+                for (std::ptrdiff_t c = 0; c < chunks; ++c) {
+                    std::size_t count = counts[c * buckets + b];
+                    counts[c * buckets + b] = total;
+                    total += count;
+                }
+            }
+            for_each_chunk(pool, chunks, [&](std::ptrdiff_t c) {
+                Encoder enc = encode;
+                std::size_t* offset = &counts[c * buckets];
+                for (std::ptrdiff_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+                    dst[offset[(enc(src[i]) >> shift) & mask]++] = std::move(src[i]);
+                }
+            });
+        };
+        if (in_buffer) scatter(buffer.begin(), first);
+        else scatter(first, buffer.begin());
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer) {
+        for_each_chunk(pool, chunks, [&](std::ptrdiff_t c) {
+            std::move(buffer.begin() + chunk_begin(c), buffer.begin() + chunk_begin(c + 1), first + chunk_begin(c));
+        });
+    }
+}
+
+// In-place MSD radix sort (American flag sort), 8-bit digits from the top down
+template<typename RandomIt, typename Encoder>
+void american_flag_sort(RandomIt first, std::ptrdiff_t n, Encoder encode, int shift, TaskPool& pool) {
+    SORT_COUNT_RECURSION();
+    for (;;) {
+        if (n <= RADIX_INSERTION_THRESHOLD) {
+            insertion_sort_by_key(first, first + n, encode);
+            return;
+        }
+        std::array<std::ptrdiff_t, 256> counts{};
+        for (std::ptrdiff_t i = 0; i < n; ++i) ++counts[(encode(first[i]) >> shift) & 0xFF];
+
+        // Constant digit: go straight to the next one without permuting
+        if (std::find(counts.begin(), counts.end(), n) != counts.end()) {
+            if (shift == 0) return;
+            shift -= 8;
+            continue;
+        }
+
+        std::array<std::ptrdiff_t, 256> heads, tails;
+        std::ptrdiff_t sum = 0;
+        for (int b = 0; b < 256; ++b) { heads[b] = sum; sum += counts[b]; tails[b] = sum; }
+
+        // Cycle every misplaced element into its bucket's next free slot
+        for (int b = 0; b < 256; ++b) {
+            while (heads[b] < tails[b]) {
+                int d = static_cast<int>((encode(first[heads[b]]) >> shift) & 0xFF);
+                if (d == b) ++heads[b];
+                else std::swap(first[heads[b]], first[heads[d]++]);
+            }
+        }
+        if (shift == 0) return;
+
+        // Large buckets are sorted in parallel (on pools of more than one thread), the rest inline
+        TaskGroup group(pool);
+        std::ptrdiff_t start = 0;
+        for (int b = 0; b < 256; ++b) {
+            std::ptrdiff_t len = counts[b];
+            if (len > 1) {
+                RandomIt bucket = first + start;
+                if (len >= RADIX_MIN_CHUNK && pool.thread_count() > 1) group.run([=, &pool]() mutable { american_flag_sort(bucket, len, encode, shift - 8, pool); });
+                else american_flag_sort(bucket, len, encode, shift - 8, pool);
+            }
+            start += len;
+        }
+        group.wait();
+        return;
+    }
+}
+
+} // namespace RadixSortImpl
+
+// Radix sort function; sorts ascending by the (projected) integer or floating-point key
+template<typename RandomIt, typename Proj = identity_projection>
+inline void radix_sort(RandomIt first, RandomIt last, Proj proj = {}, const RadixSortOptions& options = {}) {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    RadixSortImpl::KeyEncoder<Proj> encode{proj};
+    using ukey = decltype(encode(*first));
+    std::ptrdiff_t n = last - first;
+    if (n < 2) return;
+    if (n <= RADIX_INSERTION_THRESHOLD) {
+        RadixSortImpl::insertion_sort_by_key(first, last, encode);
+        return;
+    }
+
+    int digit_bits = options.digit_bits;
+    if (digit_bits == 0) digit_bits = (n < (std::ptrdiff_t(1) << 16)) ? 8 : 11;
+    if (digit_bits != 8 && digit_bits != 11 && digit_bits != 16) {
+        throw std::invalid_argument("radix_sort: digit_bits must be 8, 11 or 16");
+    }
+    TaskPool& pool = options.pool ? *options.pool : default_task_pool();
+
+    if (static_cast<std::size_t>(n) > options.memory_budget / sizeof(value_type)) {
+        RadixSortImpl::american_flag_sort(first, n, encode, static_cast<int>(sizeof(ukey) * 8) - 8, pool);
+    } else {
+        RadixSortImpl::lsd_radix_sort(first, n, encode, digit_bits, pool, options.workspace);
+    }
+}
+inline void radix_sort(std::vector<int>& arr) {
+    radix_sort(arr.begin(), arr.end());
 }
 
 
-#endif 
+#endif
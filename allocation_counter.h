@@ -0,0 +1,87 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+// HEAP ALLOCATION COUNTER
+//
+// Counts calls to the global operator new (and the bytes asked for) across all threads, so a
+// benchmark can show that a sort's steady-state hot path allocates nothing. Counting needs the
+// replacement operator new / delete below, which may be defined in only one translation unit
+// of a program: that file defines ALLOCATION_COUNTER_REPLACE_NEW before including this header.
+// Every other file just reads the counters. Without the replacement the counters stay at zero
+// and allocation_counter_installed() returns false.
+//
+// Only the single-object forms are replaced: the default array and nothrow forms call them,
+// and the sized deletes go to the unsized ones. Blocks come from malloc / aligned_alloc.
+
+#include <atomic>
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+
+struct AllocationCounts {
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+};
+
+namespace AllocationCounterImpl {
+
+inline std::atomic<std::uint64_t> allocations{0};
+inline std::atomic<std::uint64_t> bytes{0};
+inline std::atomic<bool> installed{false};
+
+inline void record(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+} // namespace AllocationCounterImpl
+
+inline bool allocation_counter_installed() {
+    return AllocationCounterImpl::installed.load(std::memory_order_relaxed);
+}
+
+// Totals since program start; take the difference of two reads around the code of interest
+inline AllocationCounts allocation_counts_read() {
+    AllocationCounts counts;
+    counts.allocations = AllocationCounterImpl::allocations.load(std::memory_order_relaxed);
+    counts.bytes = AllocationCounterImpl::bytes.load(std::memory_order_relaxed);
+    return counts;
+}
+
+#ifdef ALLOCATION_COUNTER_REPLACE_NEW
+
+#include <cstdlib> // std::malloc, std::aligned_alloc, std::free
+#include <new>     // std::bad_alloc, std::align_val_t, std::get_new_handler
+
+namespace AllocationCounterImpl {
+
+inline void* allocate(std::size_t size, std::size_t alignment) {
+    record(size);
+    if (size == 0) size = 1;
+    if (alignment > alignof(std::max_align_t)) size = (size + alignment - 1) / alignment * alignment; // aligned_alloc wants a multiple
+    for (;;) {
+        void* p = alignment > alignof(std::max_align_t) ? std::aligned_alloc(alignment, size) : std::malloc(size);
+        if (p) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+// Set during static initialization of the one file that replaces operator new
+const bool replaced = (installed.store(true, std::memory_order_relaxed), true);
+
+} // namespace AllocationCounterImpl
+
+void* operator new(std::size_t size) { return AllocationCounterImpl::allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return AllocationCounterImpl::allocate(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+#endif // ALLOCATION_COUNTER_REPLACE_NEW
+
+
+#endif
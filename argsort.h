@@ -0,0 +1,183 @@
+#ifndef ARGSORT_H
+#define ARGSORT_H
+
+#include <algorithm>   // std::min
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <cstdint>     // std::uint32_t
+#include <functional>  // std::less, std::invoke
+#include <iterator>    // std::iterator_traits
+#include <limits>
+#include <stdexcept>   // std::invalid_argument
+#include <tuple>       // std::tuple, std::apply
+#include <type_traits> // std::decay_t, std::invoke_result_t
+#include <utility>     // std::move
+#include <vector>
+
+#include "task_pool.h"     // TaskPool, TaskGroup, default_task_pool
+#include "sort_common.h"   // identity_projection
+#include "adaptive_sort.h" // adaptive_sort, AdaptiveSortImpl::RadixTraits
+#include "advanced_sorting.h" // radix_sort
+
+
+// ARGSORT, KEY/PAYLOAD SORT AND PERMUTATION APPLY
+//
+// Records are not moved while sorting: the (projected) key is copied next to its 32-bit
+// position into an 8-16 byte KeyIndex, those are sorted, and the records (or the columns of
+// a struct-of-arrays layout) are then gathered once through the resulting permutation.
+// Sorting moves a few bytes per element instead of a whole 32-128 byte record, and the single
+// gather pass is blocked so the block of indices stays in L1 while every column reads it.
+//
+// Permutations are gather permutations: sorted[i] = original[perm[i]]. All three entry points
+// are stable: integer and floating-point keys under std::less use the (stable) LSD radix sort,
+// everything else adaptive_sort with ties broken by index (radix orders -0.0 before +0.0, which
+// std::less treats as equal). At most 2^32 - 1 elements.
+
+const std::ptrdiff_t PERMUTATION_BLOCK_SIZE = 4096;     // Indices per gather block (16 KiB)
+const std::ptrdiff_t PERMUTATION_PREFETCH_DISTANCE = 16; // Gathers issued ahead of use
+const std::ptrdiff_t PERMUTATION_MIN_PARALLEL_SIZE = 1 << 16;
+
+template<typename Key>
+struct KeyIndex {
+    Key key;
+    std::uint32_t index;
+};
+
+namespace ArgsortImpl {
+
+inline void check_size(std::ptrdiff_t n) {
+    if (n > static_cast<std::ptrdiff_t>(std::numeric_limits<std::uint32_t>::max())) {
+        throw std::invalid_argument("argsort: more than 2^32 - 1 elements");
+    }
+}
+
+// Orders by key, then by position: a strict total order, so any engine gives the stable result
+template<typename Compare>
+struct KeyIndexCompare {
+    Compare comp;
+    template<typename Key>
+    bool operator()(const KeyIndex<Key>& a, const KeyIndex<Key>& b) {
+        if (comp(a.key, b.key)) return true;
+        if (comp(b.key, a.key)) return false;
+        return a.index < b.index;
+    }
+};
+
+struct key_of {
+    template<typename Key>
+    const Key& operator()(const KeyIndex<Key>& item) const { return item.key; }
+};
+
+template<typename Key, typename Compare>
+inline void sort_key_index(std::vector<KeyIndex<Key>>& items, Compare comp, TaskPool& pool) {
+    using It = typename std::vector<KeyIndex<Key>>::iterator;
+    if constexpr (AdaptiveSortImpl::RadixTraits<It, Compare, key_of>::sortable) {
+        RadixSortOptions options;
+        options.pool = &pool;
+        radix_sort(items.begin(), items.end(), key_of(), options);
+    } else {
+        adaptive_sort(items.begin(), items.end(), KeyIndexCompare<Compare>{comp}, identity_projection(), pool);
+    }
+}
+
+template<typename RandomIt, typename Proj>
+using projected_key_t = std::decay_t<std::invoke_result_t<Proj&, typename std::iterator_traits<RandomIt>::reference>>;
+
+template<typename RandomIt, typename Proj>
+inline std::vector<KeyIndex<projected_key_t<RandomIt, Proj>>> make_key_index(RandomIt first, std::ptrdiff_t n, Proj& proj) {
+    std::vector<KeyIndex<projected_key_t<RandomIt, Proj>>> items;
+    items.reserve(n);
+    for (std::ptrdiff_t i = 0; i < n; ++i) items.push_back({std::invoke(proj, first[i]), static_cast<std::uint32_t>(i)});
+    return items;
+}
+
+// body(begin, end) over [0, n) in PERMUTATION_BLOCK_SIZE-aligned chunks, one per pool thread
+template<typename Body>
+inline void for_each_block_range(std::ptrdiff_t n, TaskPool& pool, Body body) {
+    std::ptrdiff_t chunks = std::max<std::ptrdiff_t>(1, std::min<std::ptrdiff_t>(pool.thread_count(), n / PERMUTATION_MIN_PARALLEL_SIZE));
+    std::ptrdiff_t blocks = (n + PERMUTATION_BLOCK_SIZE - 1) / PERMUTATION_BLOCK_SIZE;
+    TaskGroup group(pool);
+    for (std::ptrdiff_t c = 1; c < chunks; ++c) {
+        std::ptrdiff_t begin = std::min(n, blocks * c / chunks * PERMUTATION_BLOCK_SIZE);
+        std::ptrdiff_t end = std::min(n, blocks * (c + 1) / chunks * PERMUTATION_BLOCK_SIZE);
+        group.run([=]() { body(begin, end); });
+    }
+    body(0, std::min(n, blocks / chunks * PERMUTATION_BLOCK_SIZE));
+    group.wait();
+}
+
+// out[i] = in[perm[i]] for i in [begin, end), prefetching the reads ahead
+template<typename InIt, typename OutIt>
+inline void gather(InIt in, OutIt out, const std::uint32_t* perm, std::ptrdiff_t begin, std::ptrdiff_t end) {
+    for (std::ptrdiff_t i = begin; i < end; ++i) {
+#if defined(__GNUC__)
+        if (i + PERMUTATION_PREFETCH_DISTANCE < end) __builtin_prefetch(&in[perm[i + PERMUTATION_PREFETCH_DISTANCE]]);
+#endif
+        out[i] = std::move(in[perm[i]]);
+    }
+}
+
+template<typename Column>
+inline void check_column(const Column& column, std::size_t n) {
+    if (column.size() != n) throw std::invalid_argument("apply_permutation: column size differs from the permutation");
+}
+
+} // namespace ArgsortImpl
+
+// Stable argsort: the permutation that sorts [first, last) (first itself is not modified)
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline std::vector<std::uint32_t> argsort(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}, TaskPool& pool = default_task_pool()) {
+    std::ptrdiff_t n = last - first;
+    ArgsortImpl::check_size(n);
+    auto items = ArgsortImpl::make_key_index(first, n, proj);
+    ArgsortImpl::sort_key_index(items, comp, pool);
+    std::vector<std::uint32_t> perm(n);
+    for (std::ptrdiff_t i = 0; i < n; ++i) perm[i] = items[i].index;
+    return perm;
+}
+inline std::vector<std::uint32_t> argsort(const std::vector<int>& arr, TaskPool& pool = default_task_pool()) {
+    return argsort(arr.begin(), arr.end(), std::less<>(), identity_projection(), pool);
+}
+
+// Reorder every column by perm in one blocked pass: column[i] = old column[perm[i]]. Each
+// column is gathered into a scratch vector and swapped in. All columns must have perm.size()
+// elements; perm must be a permutation of 0..n-1.
+template<typename... Columns>
+inline void apply_permutation(const std::vector<std::uint32_t>& perm, TaskPool& pool, std::vector<Columns>&... columns) {
+    std::size_t n = perm.size();
+    (ArgsortImpl::check_column(columns, n), ...);
+    std::tuple<std::vector<Columns>...> scratch{std::vector<Columns>(n)...};
+    ArgsortImpl::for_each_block_range(static_cast<std::ptrdiff_t>(n), pool, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t block = begin; block < end; block += PERMUTATION_BLOCK_SIZE) {
+            std::ptrdiff_t block_end = std::min(end, block + PERMUTATION_BLOCK_SIZE);
+            std::apply([&](auto&... out) {
+                (ArgsortImpl::gather(columns.begin(), out.begin(), perm.data(), block, block_end), ...);
+            }, scratch);
+        }
+    });
+    std::apply([&](auto&... out) { (columns.swap(out), ...); }, scratch);
+}
+template<typename... Columns>
+inline void apply_permutation(const std::vector<std::uint32_t>& perm, std::vector<Columns>&... columns) {
+    apply_permutation(perm, default_task_pool(), columns...);
+}
+
+// Stable sort of a struct-of-arrays table by its key column: keys and payload are reordered
+// together and only KeyIndex items move during the sort itself
+template<typename Key, typename Payload, typename Compare = std::less<>>
+inline void sort_by_key(std::vector<Key>& keys, std::vector<Payload>& payload, Compare comp = {}, TaskPool& pool = default_task_pool()) {
+    if (payload.size() != keys.size()) throw std::invalid_argument("sort_by_key: payload size differs from the key count");
+    std::ptrdiff_t n = static_cast<std::ptrdiff_t>(keys.size());
+    ArgsortImpl::check_size(n);
+    identity_projection proj;
+    auto items = ArgsortImpl::make_key_index(keys.begin(), n, proj);
+    ArgsortImpl::sort_key_index(items, comp, pool);
+    std::vector<std::uint32_t> perm(n);
+    for (std::ptrdiff_t i = 0; i < n; ++i) {
+        keys[i] = std::move(items[i].key); // The keys are already in order
+        perm[i] = items[i].index;
+    }
+    apply_permutation(perm, pool, payload);
+}
+
+
+#endif
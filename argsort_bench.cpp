@@ -0,0 +1,112 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <array>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>   // std::memcpy
+#include <iomanip>   //  std::setw, std::left (formatting output)
+
+#include "sorting.h"   // quickSort, mergeSort
+#include "argsort.h"   // argsort, apply_permutation, sort_by_key
+#include "benchmark_timing.h" // benchmark_copy_average_ms, print_benchmark_time
+
+// Benchmark: sorting records (int key + payload) directly as an array of structs against
+// moving only key + 32-bit index (argsort, then one gather of the records) and against a
+// struct-of-arrays table sorted with sort_by_key. Every result is checked: each payload
+// must still carry the key it started with.
+
+// Constants
+const std::vector<std::size_t> SIZES = {100000, 1000000};
+const int NUM_RUNS = 5;
+
+
+template <std::size_t PayloadBytes>
+struct Record {
+    int key;
+    std::array<std::uint8_t, PayloadBytes> payload;
+};
+
+// payload bytes 0-3 hold a copy of the key, so a record split from its key is detected
+template <std::size_t PayloadBytes>
+std::array<std::uint8_t, PayloadBytes> make_payload(int key) {
+    std::array<std::uint8_t, PayloadBytes> payload{};
+    std::memcpy(payload.data(), &key, sizeof(key));
+    return payload;
+}
+
+template <std::size_t PayloadBytes>
+bool payload_matches(int key, const std::array<std::uint8_t, PayloadBytes>& payload) {
+    int copy;
+    std::memcpy(&copy, payload.data(), sizeof(copy));
+    return copy == key;
+}
+
+template <std::size_t PayloadBytes>
+void run_payload(std::size_t size) {
+    using Rec = Record<PayloadBytes>;
+    std::mt19937 rng(42);
+    std::vector<Rec> records(size);
+    for (auto& r : records) {
+        r.key = static_cast<int>(rng() % 1'000'000);
+        r.payload = make_payload<PayloadBytes>(r.key);
+    }
+    struct Table {
+        std::vector<int> keys;
+        std::vector<std::array<std::uint8_t, PayloadBytes>> payload;
+    } table;
+    for (const auto& r : records) {
+        table.keys.push_back(r.key);
+        table.payload.push_back(r.payload);
+    }
+
+    auto records_ok = [](const std::vector<Rec>& data) {
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            if ((i > 0 && data[i].key < data[i - 1].key) || !payload_matches(data[i].key, data[i].payload)) return false;
+        }
+        return true;
+    };
+    auto table_ok = [](const Table& t) {
+        for (std::size_t i = 0; i < t.keys.size(); ++i) {
+            if ((i > 0 && t.keys[i] < t.keys[i - 1]) || !payload_matches(t.keys[i], t.payload[i])) return false;
+        }
+        return true;
+    };
+
+    std::cout << "\n=== " << size << " records, " << sizeof(Rec) << " bytes each (avg over " << NUM_RUNS << " runs) ===\n";
+    std::cout << std::fixed << std::setprecision(3);
+    print_benchmark_time("AoS quickSort (moves records)", 36, benchmark_copy_average_ms(NUM_RUNS, records, [](std::vector<Rec>& d) {
+        quickSort(d.begin(), d.end(), std::less<>(), &Rec::key); }, records_ok));
+    print_benchmark_time("AoS mergeSort (moves records)", 36, benchmark_copy_average_ms(NUM_RUNS, records, [](std::vector<Rec>& d) {
+        mergeSort(d.begin(), d.end(), std::less<>(), &Rec::key); }, records_ok));
+    print_benchmark_time("AoS std::sort (moves records)", 36, benchmark_copy_average_ms(NUM_RUNS, records, [](std::vector<Rec>& d) {
+        std::sort(d.begin(), d.end(), [](const Rec& a, const Rec& b) { return a.key < b.key; }); }, records_ok));
+    print_benchmark_time("AoS argsort + apply_permutation", 36, benchmark_copy_average_ms(NUM_RUNS, records, [](std::vector<Rec>& d) {
+        std::vector<std::uint32_t> perm = argsort(d.begin(), d.end(), std::less<>(), &Rec::key);
+        apply_permutation(perm, d); }, records_ok));
+    print_benchmark_time("SoA sort_by_key", 36, benchmark_copy_average_ms(NUM_RUNS, table, [](Table& t) {
+        sort_by_key(t.keys, t.payload); }, table_ok));
+    auto perm_ok = [&keys = table.keys](const std::vector<std::uint32_t>& perm) { // A permutation that orders keys
+        std::vector<bool> seen(keys.size());
+        if (perm.size() != keys.size()) return false;
+        for (std::size_t i = 0; i < perm.size(); ++i) {
+            if (perm[i] >= keys.size() || seen[perm[i]] || (i > 0 && keys[perm[i]] < keys[perm[i - 1]])) return false;
+            seen[perm[i]] = true;
+        }
+        return true;
+    };
+    print_benchmark_time("argsort only (keys)", 36, benchmark_copy_average_ms(NUM_RUNS, table.keys, [](std::vector<int>& k) {
+        return argsort(k); }, perm_ok));
+}
+
+
+int main() {
+    std::cout << "Key/payload sorting: records moved whole vs key + index (" << default_task_pool().thread_count() << " pool thread(s))" << std::endl;
+    for (std::size_t size : SIZES) {
+        run_payload<32>(size);
+        run_payload<64>(size);
+        run_payload<128>(size);
+    }
+    return 0;
+}
@@ -0,0 +1,280 @@
+#define ALLOCATION_COUNTER_REPLACE_NEW // This program counts its heap allocations (allocation_counter.h)
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>    // std::strtod, std::strtoull
+#include <exception>  // for std::exception
+#include <iomanip>    //  std::setw, std::left (formatting output)
+#include <map>
+#include <memory>     // std::unique_ptr
+#include <sstream>
+
+#include "benchmark_harness.h"
+#include "sort_calibration.h"
+#include "benchmark_scheduler.h" // --cpus / --numa-node / --threads, --scaling sweeps
+
+// Unified benchmark driver over sorting.h and advanced_sorting.h.
+//
+//   benchmark [--algorithms a,b,...] [--sizes n,n,...] [--distributions d,d,...]
+//             [--reps N] [--warmups N] [--time-budget MS] [--quadratic-cap N]
+//             [--seed S] [--cache DIR] [--json FILE] [--csv FILE] [--workspace] [--no-perf] [--list]
+//             [--cpus LIST | --numa-node N] [--threads N]
+//   benchmark --scaling strong|weak [--algorithms a,b,...] [--sizes n,...] [--distributions d,...] [--reps N]
+//             [--cpus LIST | --numa-node N] [--threads N]
+//   benchmark --calibrate [--profile FILE]
+//
+// Sizes accept k / M suffixes (e.g. 10k, 1M). For every algorithm, distribution and size the
+// driver warms up, times up to --reps runs within --time-budget and validates every result.
+// O(n^2) sorts are skipped above --quadratic-cap, and an algorithm whose single run already
+// exceeded the budget is skipped at larger sizes of the same distribution.
+// Distributions are the datasets.h shapes (see --list); --cache keeps every generated input in
+// DIR and memory-maps it on later runs instead of generating it again.
+// Hardware counters (cycles, instructions, branch / cache misses, page faults) are reported per
+// element under each result unless --no-perf is given or perf_event_open is not permitted.
+// Build with -DSORT_COUNTERS to add comparisons, moves and recursion depth per algorithm.
+// The Allocs column is the mean number of heap allocations made inside one timed sort call.
+// --workspace hands the sorts that accept one a SortWorkspace kept across runs (merge, tim,
+// library, radix, adaptive), which brings their steady state to zero allocations wherever
+// no parallel task is forked: below the parallel thresholds, and at every size with --threads 1.
+// Measurements run one at a time on the main thread. --cpus (a list such as 0-3,8) or
+// --numa-node pins the run, and the pool's workers with it; --threads sets the number of
+// worker threads the parallel sorts get (default: one per CPU of the placement).
+// --scaling sweeps the parallel sorts (merge, quick, sample, radix, adaptive) over pinned pools
+// of 1, 2, 4, ... --threads workers: strong keeps each --sizes n fixed, weak gives every thread
+// n elements. It reports speedup, parallel efficiency, and the bandwidth reached against a
+// parallel copy on the same threads; --distributions defaults to random and --sizes to 10M there.
+// Exits with status 1 if any result failed validation.
+//
+// --calibrate measures the sort_tuning() thresholds on this machine and writes them to FILE
+// (default sort_tuning.profile, which sorts load on startup from the working directory).
+
+
+std::vector<std::string> split_list(const std::string& s) {
+    std::vector<std::string> items;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+int parse_size(const std::string& s) {
+    char* end = nullptr;
+    double value = std::strtod(s.c_str(), &end);
+    std::string suffix = end;
+    if (suffix == "k" || suffix == "K") value *= 1e3;
+    else if (suffix == "m" || suffix == "M") value *= 1e6;
+    else if (!suffix.empty()) throw std::invalid_argument("bad size: " + s);
+    if (value < 0 || value > 2e9) throw std::invalid_argument("size out of range: " + s);
+    return static_cast<int>(value);
+}
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--algorithms a,b,...] [--sizes n,n,...] [--distributions d,d,...]\n"
+              << "       [--reps N] [--warmups N] [--time-budget MS] [--quadratic-cap N] [--seed S] [--cache DIR]\n"
+              << "       [--json FILE] [--csv FILE] [--workspace] [--no-perf] [--list] [--cpus LIST | --numa-node N] [--threads N]\n"
+              << "       " << program << " --scaling strong|weak [--algorithms a,b,...] [--sizes n,...] [--distributions d,...] [--reps N]\n"
+              << "       " << program << " --calibrate [--profile FILE]" << std::endl;
+}
+
+void print_registry() {
+    std::cout << "Algorithms:";
+    for (const auto& a : benchmark_algorithms()) std::cout << " " << a.name << (a.quadratic ? "*" : "");
+    std::cout << "   (* = O(n^2), size-capped)\nParallel (--scaling):";
+    for (const auto& a : parallel_benchmark_algorithms()) std::cout << " " << a.name;
+    std::cout << "\nDistributions:";
+    for (const auto& d : benchmark_distributions()) std::cout << " " << d.name;
+    std::cout << std::endl;
+}
+
+void print_header() {
+    std::cout << std::left << std::setw(12) << "Algorithm" << std::setw(12) << "Input" << std::right << std::setw(11) << "Size"
+              << std::setw(6) << "Runs" << std::setw(12) << "Min ms" << std::setw(12) << "Median ms" << std::setw(12) << "P95 ms"
+              << std::setw(12) << "Max ms" << std::setw(14) << "Melem/s" << std::setw(10) << "Allocs" << "\n";
+    std::cout << std::string(113, '-') << std::endl;
+}
+
+void print_result(const BenchmarkResult& r) {
+    std::cout << std::left << std::setw(12) << r.algorithm << std::setw(12) << r.distribution << std::right << std::setw(11) << r.size;
+    if (!r.skipped.empty()) {
+        std::cout << "   skipped (" << r.skipped << ")" << std::endl;
+        return;
+    }
+    std::cout << std::fixed << std::setprecision(3) << std::setw(6) << r.runs << std::setw(12) << r.min_ms << std::setw(12) << r.median_ms
+              << std::setw(12) << r.p95_ms << std::setw(12) << r.max_ms << std::setw(14) << r.elements_per_second / 1e6;
+    if (r.has_allocations) std::cout << std::setprecision(1) << std::setw(10) << r.allocations_per_run;
+    else std::cout << std::setw(10) << "-";
+    if (!r.valid) std::cout << "   !!! INVALID: not sorted or not a permutation !!!";
+    std::cout << "\n";
+
+    // Per-element counters on a second line, only those that were measured
+    std::ostringstream counters;
+    counters << std::fixed << std::setprecision(2);
+    for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+        if (r.perf_valid[e]) counters << "  " << perf_event_name(e) << " " << r.perf_per_element[e];
+    }
+    if (r.has_counts) {
+        counters << "  comparisons " << r.comparisons_per_element << "  moves " << r.moves_per_element << "  max_depth " << r.max_depth;
+    }
+    if (!counters.str().empty()) std::cout << std::setw(24) << "per element:" << counters.str() << "\n";
+    std::cout << std::flush;
+}
+
+int main(int argc, char** argv) {
+    BenchmarkConfig config;
+    bool use_perf = true;
+    bool calibrate = false;
+    std::string profile_path = "sort_tuning.profile";
+    BenchmarkPlacement placement;
+    std::string scaling;              // "strong" or "weak": run the scaling sweeps instead
+    bool distributions_given = false, sizes_given = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "--list") { print_registry(); return 0; }
+            else if (arg == "--algorithms" && has_value) config.algorithms = split_list(argv[++i]);
+            else if (arg == "--sizes" && has_value) {
+                config.sizes.clear();
+                sizes_given = true;
+                for (const auto& s : split_list(argv[++i])) config.sizes.push_back(parse_size(s));
+            }
+            else if (arg == "--distributions" && has_value) {
+                config.distributions = split_list(argv[++i]);
+                distributions_given = true;
+            }
+            else if (arg == "--reps" && has_value) config.repetitions = std::max(1, std::atoi(argv[++i]));
+            else if (arg == "--warmups" && has_value) config.warmups = std::max(0, std::atoi(argv[++i]));
+            else if (arg == "--time-budget" && has_value) config.time_budget_ms = std::strtod(argv[++i], nullptr);
+            else if (arg == "--quadratic-cap" && has_value) config.quadratic_cap = parse_size(argv[++i]);
+            else if (arg == "--seed" && has_value) config.seed = std::strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--cache" && has_value) config.cache_dir = argv[++i];
+            else if (arg == "--json" && has_value) config.json_path = argv[++i];
+            else if (arg == "--csv" && has_value) config.csv_path = argv[++i];
+            else if (arg == "--workspace") config.workspace = true;
+            else if (arg == "--no-perf") use_perf = false;
+            else if (arg == "--calibrate") calibrate = true;
+            else if (arg == "--profile" && has_value) profile_path = argv[++i];
+            else if (arg == "--scaling" && has_value) {
+                scaling = argv[++i];
+                if (scaling != "strong" && scaling != "weak") throw std::invalid_argument("--scaling takes strong or weak");
+            }
+            else if (parse_placement_option(argc, argv, i, placement)) continue;
+            else {
+                std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+                print_usage(argv[0]);
+                return 2;
+            }
+        }
+
+        std::string placement_info = apply_benchmark_placement(placement); // Before the default pool starts
+
+        if (!scaling.empty()) {
+            std::vector<const ParallelBenchmarkAlgorithm*> parallel;
+            for (const auto& a : parallel_benchmark_algorithms()) {
+                if (config.algorithms.empty() || std::find(config.algorithms.begin(), config.algorithms.end(), a.name) != config.algorithms.end()) {
+                    parallel.push_back(&a);
+                }
+            }
+            for (const auto& name : config.algorithms) {
+                find_benchmark_algorithm(name); // Unknown names throw; known serial ones are left out
+                bool found = false;
+                for (const auto* a : parallel) found = found || a->name == name;
+                if (!found) std::cerr << "Skipping " << name << ": not a parallel sort" << std::endl;
+            }
+            if (!distributions_given) config.distributions = {"random"};
+            if (!sizes_given) config.sizes = {SCALING_DEFAULT_SIZE};
+            for (const auto& name : config.distributions) find_benchmark_distribution(name);
+
+            ScalingConfig scaling_config;
+            scaling_config.mode = scaling == "strong" ? ScalingMode::Strong : ScalingMode::Weak;
+            scaling_config.runs = config.repetitions;
+            scaling_config.seed = config.seed;
+            scaling_config.cache_dir = config.cache_dir;
+            std::cout << "Scaling: " << scaling << ", median of " << config.repetitions << " run(s), " << placement_info << std::endl;
+            bool all_valid = true;
+            for (const auto& distribution : config.distributions) {
+                scaling_config.distribution = distribution;
+                for (int size : config.sizes) {
+                    scaling_config.size = size;
+                    all_valid = run_scaling_sweeps(std::cout, parallel, placement, scaling_config) && all_valid;
+                }
+            }
+            return all_valid ? 0 : 1;
+        }
+
+        if (calibrate) {
+            SortTuning tuning = calibrate_sort_tuning(default_task_pool(), &std::cout);
+            sort_tuning() = tuning;
+            save_sort_tuning(profile_path, tuning);
+            std::cout << "\nCalibrated thresholds:\n";
+            write_sort_tuning(std::cout, tuning);
+            std::cout << "Wrote " << profile_path << std::endl;
+            return 0;
+        }
+
+        std::vector<const BenchmarkAlgorithm*> algorithms;
+        if (config.algorithms.empty()) {
+            for (const auto& a : benchmark_algorithms()) algorithms.push_back(&a);
+        } else {
+            for (const auto& name : config.algorithms) algorithms.push_back(&find_benchmark_algorithm(name));
+        }
+        std::vector<const BenchmarkDistribution*> distributions;
+        for (const auto& name : config.distributions) distributions.push_back(&find_benchmark_distribution(name));
+        std::sort(config.sizes.begin(), config.sizes.end());
+
+        // Opened before the default TaskPool starts its workers so the counters inherit into them
+        std::unique_ptr<PerfCounters> perf;
+        if (use_perf) perf.reset(new PerfCounters());
+
+        std::cout << "Benchmark: " << config.repetitions << " reps, " << config.warmups << " warmup(s), "
+                  << config.time_budget_ms << " ms budget, O(n^2) cap " << config.quadratic_cap
+                  << ", " << default_task_pool().thread_count() << " pool thread(s)" << (config.workspace ? ", reused workspace" : "") << "\n";
+        std::cout << "Placement: " << placement_info << "\n";
+        if (perf) std::cout << "Hardware counters: " << (perf->status().empty() ? "all available" : perf->status()) << "\n";
+        std::cout << "\n";
+        print_header();
+
+        std::vector<BenchmarkResult> results;
+        bool all_valid = true;
+        for (const BenchmarkDistribution* distribution : distributions) {
+            std::map<std::string, bool> over_budget; // Per algorithm, for this distribution
+            for (int size : config.sizes) {
+                std::vector<int> data = benchmark_input(*distribution, size, config);
+                for (const BenchmarkAlgorithm* algorithm : algorithms) {
+                    BenchmarkResult result;
+                    if (algorithm->quadratic && size > config.quadratic_cap) {
+                        result.skipped = "O(n^2) above cap";
+                    } else if (over_budget[algorithm->name]) {
+                        result.skipped = "over time budget";
+                    } else {
+                        result = run_benchmark(*algorithm, distribution->name, data, config, perf.get());
+                        if (result.min_ms >= config.time_budget_ms) over_budget[algorithm->name] = true;
+                        all_valid = all_valid && result.valid;
+                    }
+                    result.algorithm = algorithm->name;
+                    result.distribution = distribution->name;
+                    result.size = size;
+                    print_result(result);
+                    results.push_back(result);
+                }
+            }
+        }
+
+        if (!config.json_path.empty()) {
+            write_benchmark_json(config.json_path, config, results);
+            std::cout << "\nWrote " << config.json_path << std::endl;
+        }
+        if (!config.csv_path.empty()) {
+            write_benchmark_csv(config.csv_path, results);
+            std::cout << "Wrote " << config.csv_path << std::endl;
+        }
+        return all_valid ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "!!! Benchmark failed: " << e.what() << " !!!" << std::endl;
+        return 2;
+    }
+}
@@ -0,0 +1,368 @@
+#ifndef BENCHMARK_HARNESS_H
+#define BENCHMARK_HARNESS_H
+
+#include <algorithm>  // std::sort, std::is_sorted
+#include <array>
+#include <chrono>
+#include <cstdint>    // std::uint64_t
+#include <fstream>
+#include <functional> // std::function
+#include <numeric>    // std::accumulate
+#include <stdexcept>  // std::invalid_argument
+#include <string>
+#include <thread>     // std::thread::hardware_concurrency
+#include <type_traits> // std::is_same_v
+#include <vector>
+
+#include "sorting.h"
+#include "advanced_sorting.h"
+#include "sample_sort.h"
+#include "adaptive_sort.h"
+#include "perf_counters.h" // PerfCounters (hardware counters per run)
+#include "sort_counters.h" // CountedKey, sort_counters_read (with -DSORT_COUNTERS)
+#include "sort_workspace.h"   // SortWorkspace (reused scratch with --workspace)
+#include "allocation_counter.h" // allocation_counts_read (heap allocations per run)
+#include "datasets.h"         // generate_dataset, load_dataset (input distributions)
+
+
+// BENCHMARK HARNESS
+//
+// Shared by the benchmark driver: the algorithm registry over sorting.h / advanced_sorting.h,
+// the input distributions, timing with warmups and a time budget, result validation and the
+// JSON / CSV writers. Every timed run sorts a fresh copy of the same input, written into one
+// reused array outside the timed region. Hardware counters (perf_counters.h) are read around
+// each timed run when a PerfCounters is passed in; builds with -DSORT_COUNTERS add one untimed
+// run on CountedKey for comparison / move / depth counts. Heap allocations are counted around
+// each sort call when the program installs allocation_counter.h's operator new. With
+// config.workspace the sorts that take a SortWorkspace get one that lives across the warmups
+// and timed runs, so after the warmup their scratch memory is already in place.
+
+const int BENCHMARK_DEFAULT_REPETITIONS = 10;
+const int BENCHMARK_DEFAULT_WARMUPS = 1;
+const double BENCHMARK_DEFAULT_TIME_BUDGET_MS = 10000.0; // Per algorithm, size and distribution
+const int BENCHMARK_DEFAULT_QUADRATIC_CAP = 100000;      // O(n^2) sorts are skipped above this size
+
+struct BenchmarkAlgorithm {
+    std::string name;
+    bool quadratic;                                 // O(n^2): subject to the size cap
+    std::function<void(std::vector<int>&, SortWorkspace*)> sort; // The workspace may be nullptr
+#ifdef SORT_COUNTERS
+    std::function<void(std::vector<CountedKey>&)> counted_sort;
+#endif
+};
+
+// sort is a generic lambda taking (std::vector<T>&, SortWorkspace*), instantiated for int (and
+// CountedKey, without a workspace)
+template<typename Sort>
+inline BenchmarkAlgorithm make_benchmark_algorithm(const std::string& name, bool quadratic, Sort sort) {
+    BenchmarkAlgorithm algorithm;
+    algorithm.name = name;
+    algorithm.quadratic = quadratic;
+    algorithm.sort = [sort](std::vector<int>& arr, SortWorkspace* workspace) { sort(arr, workspace); };
+#ifdef SORT_COUNTERS
+    algorithm.counted_sort = [sort](std::vector<CountedKey>& arr) { sort(arr, nullptr); };
+#endif
+    return algorithm;
+}
+
+// Radix sort needs an integer key: the element itself, or CountedKey::value
+template<typename T>
+inline void benchmark_radix_sort(std::vector<T>& arr, SortWorkspace* workspace) {
+    RadixSortOptions options;
+    options.workspace = workspace;
+    if constexpr (std::is_same_v<T, int>) radix_sort(arr.begin(), arr.end(), identity_projection(), options);
+    else radix_sort(arr.begin(), arr.end(), [](const T& key) { return key.value; }, options);
+}
+
+// Every sort in sorting.h and advanced_sorting.h, plus sample_sort.h and adaptive_sort.h
+inline const std::vector<BenchmarkAlgorithm>& benchmark_algorithms() {
+    static const std::vector<BenchmarkAlgorithm> algorithms = {
+        make_benchmark_algorithm("bubble", true, [](auto& arr, SortWorkspace*) { bubble_sort(arr.begin(), arr.end()); }),
+        make_benchmark_algorithm("insertion", true, [](auto& arr, SortWorkspace*) { insertion_sort(arr.begin(), arr.end()); }),
+        make_benchmark_algorithm("selection", true, [](auto& arr, SortWorkspace*) { selection_sort(arr.begin(), arr.end()); }),
+        make_benchmark_algorithm("cocktail", true, [](auto& arr, SortWorkspace*) { cocktail_shaker_sort(arr.begin(), arr.end()); }),
+        make_benchmark_algorithm("merge", false, [](auto& arr, SortWorkspace* ws) {
+            mergeSort(arr.begin(), arr.end(), std::less<>(), identity_projection(), default_task_pool(), ws); }),
+        make_benchmark_algorithm("quick", false, [](auto& arr, SortWorkspace*) { quickSort(arr.begin(), arr.end()); }),
+        make_benchmark_algorithm("heap", false, [](auto& arr, SortWorkspace*) { heapSort(arr.begin(), arr.end()); }),
+        make_benchmark_algorithm("library", false, [](auto& arr, SortWorkspace* ws) {
+            library_sort(arr.begin(), arr.end(), std::less<>(), identity_projection(), LIBRARY_SORT_EPSILON, ws); }),
+        make_benchmark_algorithm("tim", false, [](auto& arr, SortWorkspace* ws) { tim_sort(arr.begin(), arr.end(), std::less<>(), identity_projection(), ws); }),
+        make_benchmark_algorithm("comb", false, [](auto& arr, SortWorkspace*) { comb_sort(arr.begin(), arr.end()); }),
+        make_benchmark_algorithm("tournament", false, [](auto& arr, SortWorkspace*) { tournament_sort(arr.begin(), arr.end()); }),
+        make_benchmark_algorithm("intro", false, [](auto& arr, SortWorkspace*) { introsort(arr.begin(), arr.end()); }),
+        make_benchmark_algorithm("radix", false, [](auto& arr, SortWorkspace* ws) { benchmark_radix_sort(arr, ws); }),
+        make_benchmark_algorithm("sample", false, [](auto& arr, SortWorkspace*) { sample_sort(arr.begin(), arr.end()); }),
+        make_benchmark_algorithm("adaptive", false, [](auto& arr, SortWorkspace* ws) {
+            adaptive_sort(arr.begin(), arr.end(), std::less<>(), identity_projection(), default_task_pool(), ws); }),
+        make_benchmark_algorithm("std", false, [](auto& arr, SortWorkspace*) { std::sort(arr.begin(), arr.end()); }),
+    };
+    return algorithms;
+}
+
+inline const BenchmarkAlgorithm& find_benchmark_algorithm(const std::string& name) {
+    for (const auto& a : benchmark_algorithms()) {
+        if (a.name == name) return a;
+    }
+    throw std::invalid_argument("unknown algorithm: " + name);
+}
+
+// INPUT DISTRIBUTIONS (the datasets.h shapes, deterministic for a given seed)
+
+struct BenchmarkDistribution {
+    std::string name;
+    std::function<std::vector<int>(int size, std::uint64_t seed)> generate;
+};
+
+inline const std::vector<BenchmarkDistribution>& benchmark_distributions() {
+    static const std::vector<BenchmarkDistribution> distributions = [] {
+        std::vector<BenchmarkDistribution> list;
+        for (const auto& shape : dataset_shapes()) {
+            list.push_back({shape, [shape](int size, std::uint64_t seed) { return generate_dataset<int>(shape, size, seed); }});
+        }
+        return list;
+    }();
+    return distributions;
+}
+
+inline const BenchmarkDistribution& find_benchmark_distribution(const std::string& name) {
+    for (const auto& d : benchmark_distributions()) {
+        if (d.name == name) return d;
+    }
+    throw std::invalid_argument("unknown distribution: " + name);
+}
+
+// VALIDATION
+
+// Order-independent checksum of the multiset of values: equal for any permutation of the input
+inline std::uint64_t permutation_checksum(const std::vector<int>& arr) {
+    std::uint64_t sum = 0, mixed = 0;
+    for (int x : arr) {
+        std::uint64_t z = static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) + 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull; // splitmix64 finalizer
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        sum += static_cast<std::uint64_t>(static_cast<std::uint32_t>(x));
+        mixed += z ^ (z >> 31);
+    }
+    return sum ^ (mixed * 0x2545f4914f6cdd1dull);
+}
+
+// MEASUREMENT
+
+struct BenchmarkConfig {
+    std::vector<std::string> algorithms;   // Empty: all
+    std::vector<int> sizes = {1000, 10000, 100000, 1000000};
+    std::vector<std::string> distributions = {"random", "ascending", "descending", "partial", "few_unique", "zipf"};
+    int repetitions = BENCHMARK_DEFAULT_REPETITIONS;
+    int warmups = BENCHMARK_DEFAULT_WARMUPS;
+    double time_budget_ms = BENCHMARK_DEFAULT_TIME_BUDGET_MS;
+    int quadratic_cap = BENCHMARK_DEFAULT_QUADRATIC_CAP;
+    std::uint64_t seed = 42;
+    bool workspace = false;                // Pass a SortWorkspace kept across runs
+    std::string cache_dir;                 // Non-empty: inputs come from this datasets.h cache
+    std::string json_path;
+    std::string csv_path;
+};
+
+// The input for one distribution and size: generated, or mapped from config.cache_dir
+inline std::vector<int> benchmark_input(const BenchmarkDistribution& distribution, int size, const BenchmarkConfig& config) {
+    if (config.cache_dir.empty()) return distribution.generate(size, config.seed);
+    return load_dataset<int>(distribution.name, size, config.seed, config.cache_dir);
+}
+
+struct BenchmarkResult {
+    std::string algorithm;
+    std::string distribution;
+    int size = 0;
+    int runs = 0;                 // Timed runs (fewer than requested when the budget ran out)
+    double min_ms = 0, median_ms = 0, p95_ms = 0, max_ms = 0, mean_ms = 0;
+    double elements_per_second = 0; // At the median time
+    bool valid = true;              // Every run sorted and a permutation of the input
+    std::string skipped;            // Non-empty: not run, and why
+    std::array<double, PERF_EVENT_COUNT> perf_per_element{}; // Mean over the timed runs
+    std::array<bool, PERF_EVENT_COUNT> perf_valid{};
+    bool has_counts = false;        // SORT_COUNTERS build: the fields below are filled
+    double comparisons_per_element = 0, moves_per_element = 0;
+    int max_depth = 0;
+    bool has_allocations = false;   // allocation_counter_installed(): the fields below are filled
+    double allocations_per_run = 0, allocated_bytes_per_run = 0; // Mean over the timed runs, sort call only
+};
+
+// Nearest-rank percentile of sorted samples
+inline double benchmark_percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    std::size_t rank = static_cast<std::size_t>(p / 100.0 * sorted.size() + 0.999999);
+    rank = std::min(sorted.size(), std::max<std::size_t>(1, rank));
+    return sorted[rank - 1];
+}
+
+inline void summarize_samples(std::vector<double> samples, BenchmarkResult& result) {
+    std::sort(samples.begin(), samples.end());
+    result.runs = static_cast<int>(samples.size());
+    if (samples.empty()) return;
+    result.min_ms = samples.front();
+    result.max_ms = samples.back();
+    result.median_ms = samples.size() % 2 ? samples[samples.size() / 2]
+                                          : (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]) / 2;
+    result.p95_ms = benchmark_percentile(samples, 95.0);
+    result.mean_ms = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    result.elements_per_second = result.median_ms > 0 ? result.size / (result.median_ms / 1000.0) : 0.0;
+}
+
+// Warm up, then time up to config.repetitions runs, stopping early once the time budget is
+// spent (always at least one timed run). Each run is validated outside the timed region.
+inline BenchmarkResult run_benchmark(const BenchmarkAlgorithm& algorithm, const std::string& distribution,
+                                     const std::vector<int>& original, const BenchmarkConfig& config,
+                                     PerfCounters* perf = nullptr) {
+    BenchmarkResult result;
+    result.algorithm = algorithm.name;
+    result.distribution = distribution;
+    result.size = static_cast<int>(original.size());
+
+    std::uint64_t expected = permutation_checksum(original);
+    auto validate = [&](const std::vector<int>& arr) {
+        if (arr.size() != original.size() || !std::is_sorted(arr.begin(), arr.end()) || permutation_checksum(arr) != expected) {
+            result.valid = false;
+        }
+    };
+
+    SortWorkspace workspace;
+    SortWorkspace* ws = config.workspace ? &workspace : nullptr;
+    std::vector<int> arr; // Refilled from original before every run, without reallocating
+
+    double spent_ms = 0;
+    for (int i = 0; i < config.warmups && spent_ms < config.time_budget_ms; ++i) {
+        arr.assign(original.begin(), original.end());
+        auto start = std::chrono::steady_clock::now();
+        algorithm.sort(arr, ws);
+        spent_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        validate(arr);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(config.repetitions);
+    PerfReading perf_total;
+    perf_total.valid.fill(true);
+    AllocationCounts allocation_total;
+    for (int i = 0; i < config.repetitions; ++i) {
+        if (!samples.empty() && spent_ms >= config.time_budget_ms) break;
+        arr.assign(original.begin(), original.end());
+        if (perf) perf->start();
+        AllocationCounts before = allocation_counts_read();
+        auto start = std::chrono::steady_clock::now();
+        algorithm.sort(arr, ws);
+        auto end = std::chrono::steady_clock::now();
+        AllocationCounts after = allocation_counts_read();
+        allocation_total.allocations += after.allocations - before.allocations;
+        allocation_total.bytes += after.bytes - before.bytes;
+        if (perf) {
+            PerfReading reading = perf->stop();
+            for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+                perf_total.values[e] += reading.values[e];
+                perf_total.valid[e] = perf_total.valid[e] && reading.valid[e];
+            }
+        }
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        spent_ms += ms;
+        samples.push_back(ms);
+        validate(arr);
+    }
+    if (perf && !original.empty()) {
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            result.perf_valid[e] = perf_total.valid[e];
+            result.perf_per_element[e] = perf_total.values[e] / (static_cast<double>(samples.size()) * original.size());
+        }
+    }
+    if (allocation_counter_installed() && !samples.empty()) {
+        result.has_allocations = true;
+        result.allocations_per_run = static_cast<double>(allocation_total.allocations) / samples.size();
+        result.allocated_bytes_per_run = static_cast<double>(allocation_total.bytes) / samples.size();
+    }
+    summarize_samples(std::move(samples), result);
+
+#ifdef SORT_COUNTERS
+    std::vector<CountedKey> keys(original.begin(), original.end());
+    sort_counters_reset();
+    algorithm.counted_sort(keys);
+    SortCounterTotals counts = sort_counters_read();
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        if (i > 0 && keys[i].value < keys[i - 1].value) result.valid = false;
+    }
+    result.has_counts = true;
+    result.comparisons_per_element = original.empty() ? 0.0 : static_cast<double>(counts.comparisons) / original.size();
+    result.moves_per_element = original.empty() ? 0.0 : static_cast<double>(counts.moves) / original.size();
+    result.max_depth = counts.max_depth;
+#endif
+    return result;
+}
+
+// OUTPUT
+
+inline std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+inline void write_benchmark_json(const std::string& path, const BenchmarkConfig& config, const std::vector<BenchmarkResult>& results) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("cannot write " + path);
+    out.precision(6);
+    out << std::fixed;
+    out << "{\n  \"config\": {\"repetitions\": " << config.repetitions << ", \"warmups\": " << config.warmups
+        << ", \"time_budget_ms\": " << config.time_budget_ms << ", \"quadratic_cap\": " << config.quadratic_cap
+        << ", \"seed\": " << config.seed << ", \"dataset_version\": " << DATASET_FORMAT_VERSION << ", \"workspace\": " << (config.workspace ? "true" : "false") << ", \"hardware_threads\": " << std::thread::hardware_concurrency()
+        << ", \"pool_threads\": " << default_task_pool().thread_count() << "},\n  \"results\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"algorithm\": \"" << json_escape(r.algorithm) << "\", \"distribution\": \"" << json_escape(r.distribution)
+            << "\", \"size\": " << r.size << ", \"runs\": " << r.runs
+            << ", \"min_ms\": " << r.min_ms << ", \"median_ms\": " << r.median_ms << ", \"p95_ms\": " << r.p95_ms
+            << ", \"max_ms\": " << r.max_ms << ", \"mean_ms\": " << r.mean_ms << ", \"elements_per_second\": " << r.elements_per_second
+            << ", \"valid\": " << (r.valid ? "true" : "false") << ", \"skipped\": \"" << json_escape(r.skipped) << "\"";
+        out << ", \"per_element\": {";
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            out << (e ? ", \"" : "\"") << perf_event_name(e) << "\": ";
+            if (r.perf_valid[e]) out << r.perf_per_element[e];
+            else out << "null";
+        }
+        if (r.has_counts) {
+            out << ", \"comparisons\": " << r.comparisons_per_element << ", \"moves\": " << r.moves_per_element;
+        }
+        out << "}";
+        if (r.has_counts) out << ", \"max_depth\": " << r.max_depth;
+        if (r.has_allocations) out << ", \"allocations_per_run\": " << r.allocations_per_run << ", \"allocated_bytes_per_run\": " << r.allocated_bytes_per_run;
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+inline void write_benchmark_csv(const std::string& path, const std::vector<BenchmarkResult>& results) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("cannot write " + path);
+    out.precision(6);
+    out << std::fixed;
+    // Per-element counter columns are left empty where a counter was unavailable
+    out << "algorithm,distribution,size,runs,min_ms,median_ms,p95_ms,max_ms,mean_ms,elements_per_second,valid,skipped";
+    for (int e = 0; e < PERF_EVENT_COUNT; ++e) out << ',' << perf_event_name(e) << "_per_element";
+    out << ",comparisons_per_element,moves_per_element,max_depth,allocations_per_run,allocated_bytes_per_run\n";
+    for (const BenchmarkResult& r : results) {
+        out << r.algorithm << ',' << r.distribution << ',' << r.size << ',' << r.runs << ','
+            << r.min_ms << ',' << r.median_ms << ',' << r.p95_ms << ',' << r.max_ms << ',' << r.mean_ms << ','
+            << r.elements_per_second << ',' << (r.valid ? "true" : "false") << ',' << r.skipped;
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            out << ',';
+            if (r.perf_valid[e]) out << r.perf_per_element[e];
+        }
+        if (r.has_counts) out << ',' << r.comparisons_per_element << ',' << r.moves_per_element << ',' << r.max_depth;
+        else out << ",,,";
+        if (r.has_allocations) out << ',' << r.allocations_per_run << ',' << r.allocated_bytes_per_run << '\n';
+        else out << ",,\n";
+    }
+}
+
+
+#endif
@@ -0,0 +1,398 @@
+#ifndef BENCHMARK_SCHEDULER_H
+#define BENCHMARK_SCHEDULER_H
+
+#include <algorithm>  // std::sort, std::min
+#include <chrono>
+#include <cstdint>    // std::uint64_t
+#include <cstdlib>    // std::strtol
+#include <cstring>    // std::memcpy
+#include <fstream>    // std::ifstream (NUMA node CPU lists)
+#include <functional> // std::function
+#include <iomanip>    // std::setw, std::setprecision
+#include <ostream>
+#include <sstream>
+#include <stdexcept>  // std::invalid_argument, std::runtime_error
+#include <string>
+#include <thread>     // std::thread::hardware_concurrency
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>    // sched_setaffinity, sched_getaffinity, cpu_set_t
+#endif
+
+#include "task_pool.h"
+#include "sorting.h"          // mergeSort, quickSort
+#include "advanced_sorting.h" // radix_sort
+#include "sample_sort.h"      // sample_sort
+#include "adaptive_sort.h"    // adaptive_sort
+#include "datasets.h"         // generate_dataset, load_dataset (sweep inputs)
+
+
+// BENCHMARK SCHEDULER
+//
+// Placement and isolation for the benchmark programs. A BenchmarkPlacement names the CPUs a
+// benchmark may use (a list such as "0-3,8", or every CPU of one NUMA node, read from
+// /sys/devices/system/node) and how many worker threads the parallel sorts get. Pinning is
+// sched_setaffinity on the calling thread before a pool starts: new threads inherit the mask
+// of the thread that creates them, so the TaskPool workers stay on the same CPUs. The
+// programs run their measurements one at a time on that thread, so a parallel sort competes
+// only with its own workers, never with another dataset's sort.
+//
+// The scaling sweeps time each parallel sort on fresh pools of 1, 2, 4, ... P threads, with
+// the pool of p threads pinned to the first p CPUs of the placement (so the CPU list order
+// decides how sockets and hyperthread siblings fill up). Strong scaling keeps n fixed:
+// speedup T(1) / T(p). Weak scaling gives every thread n elements: scaled speedup
+// p T(1) / T(p), where the n log n work of a sort keeps the ideal a little below p.
+// Efficiency is speedup / p in both. Sort GB/s is 2 n sizeof(int) / T, the one read and one
+// write of the array that any sort makes at least; it is printed beside the bandwidth a
+// parallel copy of the same array reaches on the same threads, so the ratio shows how close
+// a sort comes to being memory bound. Multi-pass sorts (radix, merge) move more than this.
+//
+// Pinning that the OS refuses (or that is unavailable off Linux) is reported, not thrown:
+// the measurements then run unpinned. The banner says so for the placement, and every sweep
+// point names its CPU subset and whether the pin took.
+//
+// Every run is checked against a std::sort of its input, so a sort that drops or duplicates
+// keys fails even when the sum and the order happen to survive.
+
+const int SCALING_DEFAULT_RUNS = 3;
+const int SCALING_DEFAULT_SIZE = 10000000;
+const int SCALING_COPY_RUNS = 3; // Best of, for the copy bandwidth
+
+// CPU LISTS
+
+// Parses the kernel's cpulist format: "0-3,8,10-11"
+inline std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item.erase(0, item.find_first_not_of(" \t\n"));
+        item.erase(item.find_last_not_of(" \t\n") + 1);
+        if (item.empty()) continue;
+        char* end = nullptr;
+        long first = std::strtol(item.c_str(), &end, 10);
+        long last = first;
+        if (*end == '-') last = std::strtol(end + 1, &end, 10);
+        if (*end != '\0' || first < 0 || last < first || last >= 65536) {
+            throw std::invalid_argument("bad CPU list entry: " + item);
+        }
+        for (long cpu = first; cpu <= last; ++cpu) cpus.push_back(static_cast<int>(cpu));
+    }
+    if (cpus.empty()) throw std::invalid_argument("empty CPU list: " + list);
+    return cpus;
+}
+
+inline std::string format_cpu_list(const std::vector<int>& cpus) {
+    std::ostringstream out;
+    for (std::size_t i = 0; i < cpus.size();) {
+        std::size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+        out << (i ? "," : "") << cpus[i];
+        if (j > i) out << "-" << cpus[j];
+        i = j + 1;
+    }
+    return out.str();
+}
+
+// The CPUs of a NUMA node, from sysfs
+inline std::vector<int> numa_node_cpus(int node) {
+    std::string path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+    std::ifstream in(path);
+    std::string list;
+    if (!in || !std::getline(in, list)) throw std::runtime_error("no NUMA node " + std::to_string(node) + " (cannot read " + path + ")");
+    return parse_cpu_list(list);
+}
+
+// The CPUs this process may run on
+inline std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        unsigned n = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned cpu = 0; cpu < n; ++cpu) cpus.push_back(static_cast<int>(cpu));
+    }
+    return cpus;
+}
+
+// PINNING
+
+// Restricts the calling thread, and the threads it starts from now on, to cpus. False when
+// the OS refuses (none of them allowed) or on a platform without sched_setaffinity.
+inline bool pin_current_thread(const std::vector<int>& cpus) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return CPU_COUNT(&set) > 0 && sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+// Pins the calling thread for the lifetime of the scope, then restores its previous mask
+class CpuPinScope {
+public:
+    explicit CpuPinScope(const std::vector<int>& cpus) {
+#ifdef __linux__
+        CPU_ZERO(&saved_);
+        if (sched_getaffinity(0, sizeof(saved_), &saved_) == 0) pinned_ = pin_current_thread(cpus);
+#else
+        (void)cpus;
+#endif
+    }
+
+    ~CpuPinScope() {
+#ifdef __linux__
+        if (pinned_) sched_setaffinity(0, sizeof(saved_), &saved_);
+#endif
+    }
+
+    CpuPinScope(const CpuPinScope&) = delete;
+    CpuPinScope& operator=(const CpuPinScope&) = delete;
+
+    bool pinned() const { return pinned_; }
+
+private:
+    bool pinned_ = false;
+#ifdef __linux__
+    cpu_set_t saved_;
+#endif
+};
+
+// PLACEMENT
+
+struct BenchmarkPlacement {
+    std::vector<int> cpus; // Empty: every allowed CPU, unpinned
+    unsigned threads = 0;  // Worker threads for the parallel sorts; 0: one per CPU
+};
+
+// Consumes argv[i] and its value when it is --cpus LIST, --numa-node N or --threads N
+inline bool parse_placement_option(int argc, char** argv, int& i, BenchmarkPlacement& placement) {
+    std::string arg = argv[i];
+    if (i + 1 >= argc) return false;
+    if (arg == "--cpus") {
+        placement.cpus = parse_cpu_list(argv[++i]);
+    } else if (arg == "--numa-node") {
+        placement.cpus = numa_node_cpus(std::atoi(argv[++i]));
+    } else if (arg == "--threads") {
+        int threads = std::atoi(argv[++i]);
+        if (threads < 1) throw std::invalid_argument(std::string("bad thread count: ") + argv[i]);
+        placement.threads = static_cast<unsigned>(threads);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Pins the calling thread to placement.cpus (when given) and limits default_task_pool() to
+// placement.threads workers, filling in the defaults. Call at startup, before anything uses
+// the default pool. Returns a one-line description for the program's banner.
+inline std::string apply_benchmark_placement(BenchmarkPlacement& placement) {
+    bool pin = !placement.cpus.empty();
+    if (!pin) placement.cpus = allowed_cpus();
+    if (placement.threads == 0) placement.threads = static_cast<unsigned>(placement.cpus.size());
+    default_task_pool_threads() = placement.threads;
+
+    std::ostringstream out;
+    if (!pin) out << "CPUs " << format_cpu_list(placement.cpus) << " (unpinned)";
+    else if (pin_current_thread(placement.cpus)) out << "pinned to CPUs " << format_cpu_list(placement.cpus);
+    else out << "NOT pinned (sched_setaffinity refused CPUs " << format_cpu_list(placement.cpus) << ")";
+    out << ", " << placement.threads << " worker thread(s) for the parallel sorts";
+    return out.str();
+}
+
+// PARALLEL SORTS (every int sort that takes a TaskPool)
+
+struct ParallelBenchmarkAlgorithm {
+    std::string name;
+    std::function<void(std::vector<int>&, TaskPool&)> sort;
+};
+
+inline const std::vector<ParallelBenchmarkAlgorithm>& parallel_benchmark_algorithms() {
+    static const std::vector<ParallelBenchmarkAlgorithm> algorithms = {
+        {"merge", [](std::vector<int>& arr, TaskPool& pool) { mergeSort(arr.begin(), arr.end(), std::less<>(), identity_projection(), pool); }},
+        {"quick", [](std::vector<int>& arr, TaskPool& pool) { quickSort(arr.begin(), arr.end(), std::less<>(), identity_projection(), pool); }},
+        {"sample", [](std::vector<int>& arr, TaskPool& pool) { sample_sort(arr, pool); }},
+        {"radix", [](std::vector<int>& arr, TaskPool& pool) {
+            RadixSortOptions options;
+            options.pool = &pool;
+            radix_sort(arr.begin(), arr.end(), identity_projection(), options); }},
+        {"adaptive", [](std::vector<int>& arr, TaskPool& pool) { adaptive_sort(arr, pool); }},
+    };
+    return algorithms;
+}
+
+// SCALING SWEEPS
+
+enum class ScalingMode { Strong, Weak };
+
+inline const char* scaling_mode_name(ScalingMode mode) { return mode == ScalingMode::Strong ? "strong" : "weak"; }
+
+struct ScalingConfig {
+    ScalingMode mode = ScalingMode::Strong;
+    std::size_t size = SCALING_DEFAULT_SIZE; // Strong: the input size; weak: elements per thread
+    unsigned max_threads = 0;     // Largest pool; 0: placement.threads
+    int runs = SCALING_DEFAULT_RUNS;
+    std::string distribution = "random";
+    std::uint64_t seed = DATASET_DEFAULT_SEED;
+    std::string cache_dir;        // Non-empty: inputs come from this datasets.h cache
+};
+
+struct ScalingPoint {
+    unsigned threads = 0;
+    std::size_t size = 0;
+    double median_ms = 0;
+    double speedup = 0;       // Strong: T(1) / T(p); weak: p T(1) / T(p)
+    double efficiency = 0;    // speedup / p
+    double sort_gb_per_s = 0; // 2 n sizeof(int) / T
+    double copy_gb_per_s = 0; // Parallel copy of the same array on the same threads
+    bool valid = true;        // Every run equal to the std::sort of the input
+    std::string cpus;         // The CPU subset the pool was pinned to
+    bool pinned = false;      // sched_setaffinity accepted that subset
+};
+
+// 1, 2, 4, ... and max_threads itself
+inline std::vector<unsigned> scaling_thread_counts(unsigned max_threads) {
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < max_threads; t *= 2) counts.push_back(t);
+    counts.push_back(std::max(1u, max_threads));
+    return counts;
+}
+
+namespace BenchmarkSchedulerImpl {
+
+inline double gb_per_s(std::size_t bytes, double ms) { return ms > 0 ? bytes / (ms * 1e6) : 0.0; }
+
+inline double median(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    std::size_t n = samples.size();
+    if (n == 0) return 0.0;
+    return n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+}
+
+// Best-of-runs read + write bandwidth of copying src to dst in one chunk per thread
+inline double copy_bandwidth(const std::vector<int>& src, std::vector<int>& dst, TaskPool& pool, unsigned threads) {
+    std::size_t n = src.size();
+    double best_ms = 0;
+    for (int run = 0; run < SCALING_COPY_RUNS; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        {
+            TaskGroup group(pool);
+            for (unsigned t = 0; t < threads; ++t) {
+                std::size_t begin = n * t / threads, end = n * (t + 1) / threads;
+                group.run([&src, &dst, begin, end]() {
+                    if (end > begin) std::memcpy(dst.data() + begin, src.data() + begin, (end - begin) * sizeof(int));
+                });
+            }
+            group.wait();
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (run == 0 || ms < best_ms) best_ms = ms;
+    }
+    return gb_per_s(2 * n * sizeof(int), best_ms);
+}
+
+} // namespace BenchmarkSchedulerImpl
+
+inline void print_scaling_header(std::ostream& out, const std::string& name, const ScalingConfig& config) {
+    out << "\n-- " << name << ": " << scaling_mode_name(config.mode) << " scaling, " << config.distribution << ", "
+        << (config.mode == ScalingMode::Strong ? "n = " : "n per thread = ") << config.size << " --\n";
+    out << std::left << std::setw(10) << "Threads" << std::right << std::setw(12) << "Size" << std::setw(12) << "Median ms"
+        << std::setw(10) << "Speedup" << std::setw(12) << "Efficiency" << std::setw(12) << "Sort GB/s"
+        << std::setw(12) << "Copy GB/s" << std::setw(10) << "Of copy" << "   CPUs" << "\n";
+}
+
+inline void print_scaling_point(std::ostream& out, const ScalingPoint& p) {
+    out << std::left << std::setw(10) << p.threads << std::right << std::setw(12) << p.size
+        << std::fixed << std::setprecision(3) << std::setw(12) << p.median_ms
+        << std::setprecision(2) << std::setw(9) << p.speedup << "x" << std::setw(11) << p.efficiency * 100 << "%"
+        << std::setw(12) << p.sort_gb_per_s << std::setw(12) << p.copy_gb_per_s
+        << std::setw(9) << (p.copy_gb_per_s > 0 ? p.sort_gb_per_s / p.copy_gb_per_s * 100 : 0.0) << "%";
+    out << "   " << p.cpus << (p.pinned ? "" : " (NOT pinned: sched_setaffinity refused)");
+    if (!p.valid) out << "   !!! INVALID: not sorted or not a permutation !!!";
+    out << "\n" << std::flush;
+}
+
+// Sweeps one parallel sort over pools of 1 .. max threads, printing each point to log as it
+// completes. Each point builds its pool after pinning, and fills the sorted array on the
+// pinned thread so its pages are first touched there. Inputs are generated (or mapped from
+// config.cache_dir) outside the pinned region.
+inline std::vector<ScalingPoint> run_scaling_sweep(const ParallelBenchmarkAlgorithm& algorithm, const BenchmarkPlacement& placement,
+                                                   const ScalingConfig& config, std::ostream* log = nullptr) {
+    using namespace BenchmarkSchedulerImpl;
+    std::vector<int> cpus = placement.cpus.empty() ? allowed_cpus() : placement.cpus;
+    unsigned max_threads = config.max_threads ? config.max_threads : std::max(1u, placement.threads);
+
+    std::vector<ScalingPoint> points;
+    std::vector<int> input, expected;
+    double base_ms = 0;
+    for (unsigned threads : scaling_thread_counts(max_threads)) {
+        ScalingPoint point;
+        point.threads = threads;
+        point.size = config.mode == ScalingMode::Strong ? config.size : config.size * threads;
+        if (input.size() != point.size || points.empty()) {
+            input.clear();
+            input.shrink_to_fit(); // Weak-scaling inputs grow: free the last one before the next
+            expected.clear();
+            expected.shrink_to_fit();
+            input = config.cache_dir.empty() ? generate_dataset<int>(config.distribution, point.size, config.seed)
+                                             : load_dataset<int>(config.distribution, point.size, config.seed, config.cache_dir);
+            expected = input;
+            std::sort(expected.begin(), expected.end());
+        }
+
+        std::vector<int> subset(cpus.begin(), cpus.begin() + std::min<std::size_t>(threads, cpus.size()));
+        CpuPinScope pin(subset);
+        point.cpus = format_cpu_list(subset);
+        point.pinned = pin.pinned();
+        TaskPool pool(threads); // Started after pinning: the workers inherit the mask
+        std::vector<int> arr(input.size()), copy(input.size());
+        point.copy_gb_per_s = copy_bandwidth(input, copy, pool, threads);
+
+        std::vector<double> samples;
+        for (int run = 0; run < std::max(1, config.runs); ++run) {
+            arr.assign(input.begin(), input.end());
+            auto start = std::chrono::steady_clock::now();
+            algorithm.sort(arr, pool);
+            samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            if (arr != expected) point.valid = false;
+        }
+        point.median_ms = median(std::move(samples));
+        if (points.empty()) base_ms = point.median_ms;
+        double ratio = point.median_ms > 0 ? base_ms / point.median_ms : 0.0;
+        point.speedup = config.mode == ScalingMode::Strong ? ratio : ratio * threads;
+        point.efficiency = point.speedup / threads;
+        point.sort_gb_per_s = gb_per_s(2 * point.size * sizeof(int), point.median_ms);
+        if (log) print_scaling_point(*log, point);
+        points.push_back(point);
+    }
+    return points;
+}
+
+// Sweeps and prints every algorithm in turn; false if any run produced a wrong result
+inline bool run_scaling_sweeps(std::ostream& out, const std::vector<const ParallelBenchmarkAlgorithm*>& algorithms,
+                               const BenchmarkPlacement& placement, const ScalingConfig& config) {
+    bool all_valid = true;
+    for (const ParallelBenchmarkAlgorithm* algorithm : algorithms) {
+        print_scaling_header(out, algorithm->name, config);
+        for (const ScalingPoint& point : run_scaling_sweep(*algorithm, placement, config, &out)) {
+            all_valid = all_valid && point.valid;
+        }
+    }
+    return all_valid;
+}
+
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef BENCHMARK_TIMING_H
+#define BENCHMARK_TIMING_H
+
+#include <algorithm>   // std::sort, std::is_sorted, std::any_of
+#include <chrono>
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint32_t, std::uint64_t
+#include <cstring>     // std::memcpy
+#include <iomanip>     // std::setw, std::left, std::right
+#include <iostream>
+#include <limits>      // std::numeric_limits
+#include <random>      // std::mt19937_64
+#include <string>
+#include <type_traits> // std::is_void, std::conditional
+#include <utility>     // std::move
+#include <vector>
+
+
+// BENCHMARK TIMING (shared by the standalone *_bench programs)
+//
+// The per-module benchmarks all time their variants the same way: runs times, each on an input
+// made fresh outside the timed region, with the output checked after every run. The result is
+// the average in milliseconds, or -1 as soon as a check fails, which the print helpers show as
+// FAILED. The driver (benchmark.cpp) has its own harness with warmups, a time budget and
+// percentiles (benchmark_harness.h); these programs compare a few variants on one input.
+
+// Average ms of run(data) over runs, with data = make() before each. check gets what run
+// returns or, when run returns nothing, the data it worked on; -1 if a check fails.
+template<typename Make, typename Run, typename Check>
+inline double benchmark_average_ms(int runs, Make make, Run run, Check check) {
+    double total_ms = 0;
+    for (int i = 0; i < runs; ++i) {
+        auto data = make();
+        auto start = std::chrono::steady_clock::now();
+        if constexpr (std::is_void<decltype(run(data))>::value) {
+            run(data);
+            total_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (!check(data)) return -1.0;
+        } else {
+            auto result = run(data);
+            total_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (!check(result)) return -1.0;
+        }
+    }
+    return total_ms / runs;
+}
+
+// Average ms of run(copy of original), checked as by benchmark_average_ms
+template<typename Data, typename Run, typename Check>
+inline double benchmark_copy_average_ms(int runs, const Data& original, Run run, Check check) {
+    return benchmark_average_ms(runs, [&original]() { return original; }, std::move(run), std::move(check));
+}
+
+// The common case: sort(copy of original), which must then equal expected
+template<typename Data, typename Sort>
+inline double benchmark_sort_average_ms(int runs, const Data& original, const Data& expected, Sort sort) {
+    return benchmark_copy_average_ms(runs, original, std::move(sort), [&expected](const Data& data) { return data == expected; });
+}
+
+// One right-aligned cell of a table
+inline void print_benchmark_cell(double ms, int width) {
+    std::cout << std::setw(width);
+    if (ms < 0) std::cout << "FAILED";
+    else std::cout << ms;
+}
+
+// "  label        12.345 ms"
+inline void print_benchmark_time(const std::string& label, int label_width, double ms) {
+    std::cout << "  " << std::left << std::setw(label_width) << label << std::right;
+    print_benchmark_cell(ms, 12);
+    std::cout << (ms < 0 ? "\n" : " ms\n");
+}
+
+// "  label        12.345   8.10": the time and the rate in million items per second
+inline void print_benchmark_row(const std::string& label, int label_width, double ms, std::size_t items, int rate_width) {
+    std::cout << "  " << std::left << std::setw(label_width) << label << std::right;
+    print_benchmark_cell(ms, 12);
+    if (ms >= 0) std::cout << std::setw(rate_width) << items / ms / 1e3;
+    std::cout << "\n";
+}
+
+
+// FLOATING-POINT KEY CHECKS (signed zeros and NaN)
+//
+// Sorts that pick branch-free selects or vector min/max for float / double can lose a key whose
+// bits differ from an equal one (+0.0 / -0.0) or that compares unordered with everything (NaN),
+// by writing its neighbour twice. These inputs are made of such keys and the check compares the
+// output with the input bit for bit, as a multiset. With a NaN in the input std::less is no
+// longer an order, so only the permutation is required then.
+
+// The output has the input's bit patterns, each as often, and is sorted unless the input has a NaN
+template<typename Float>
+inline bool is_sorted_permutation(const std::vector<Float>& input, const std::vector<Float>& output) {
+    typedef typename std::conditional<sizeof(Float) == 4, std::uint32_t, std::uint64_t>::type Bits;
+    static_assert(sizeof(Bits) == sizeof(Float), "float or double keys");
+    if (output.size() != input.size()) return false;
+    bool has_nan = std::any_of(input.begin(), input.end(), [](Float k) { return k != k; });
+    if (!has_nan && !std::is_sorted(output.begin(), output.end())) return false;
+    std::vector<Bits> a(input.size()), b(output.size());
+    if (!input.empty()) {
+        std::memcpy(a.data(), input.data(), input.size() * sizeof(Float));
+        std::memcpy(b.data(), output.data(), output.size() * sizeof(Float));
+    }
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    return a == b;
+}
+
+// Mostly signed zeros with a few small keys around them; with_nan turns some of those into NaNs
+template<typename Float>
+inline std::vector<Float> generate_signed_zeros(std::size_t size, std::mt19937_64& rng, bool with_nan = false) {
+    std::vector<Float> keys(size);
+    for (auto& k : keys) {
+        std::uint64_t r = rng() % 8;
+        if (r < 3) k = Float(0);
+        else if (r < 6) k = -Float(0);
+        else if (r == 7 && with_nan) k = rng() % 2 ? std::numeric_limits<Float>::quiet_NaN() : -std::numeric_limits<Float>::quiet_NaN();
+        else k = static_cast<Float>(static_cast<int>(rng() % 7) - 3);
+    }
+    return keys;
+}
+
+
+#endif
@@ -0,0 +1,521 @@
+#ifndef DATASETS_H
+#define DATASETS_H
+
+#include <algorithm>   // std::max, std::swap
+#include <cmath>       // std::pow, std::ldexp, std::sqrt
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint32_t, std::uint64_t
+#include <cstdio>      // std::FILE, std::fopen, std::fwrite, std::rename, std::remove
+#include <cstring>     // std::memcmp, std::memcpy, std::strncpy
+#include <filesystem>
+#include <limits>      // std::numeric_limits
+#include <random>      // std::mt19937_64
+#include <stdexcept>   // std::invalid_argument, std::runtime_error
+#include <string>
+#include <type_traits> // std::is_arithmetic, std::is_floating_point, std::is_signed
+#include <utility>     // std::move, std::exchange
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close, getpid
+#endif
+
+
+// BENCHMARK DATASETS (seeded generators and an on-disk cache)
+//
+// Every benchmark program draws its inputs from generate_dataset<T>(shape, size, seed), so a
+// (shape, size, seed) triple is the same array in every program and every run. The generator
+// is std::mt19937_64, whose output the standard fixes, with its own bounded-integer, float
+// and shuffle steps (the std:: distributions and std::shuffle differ between libraries).
+// T is any arithmetic type; int, std::int64_t, float and double are the ones benchmarked.
+//
+// Shapes:
+//   random        uniform: [0, DATASET_RANDOM_MAX] for types narrower than 64 bits, every
+//                 value for 64-bit integers, [0, 1) for floating point
+//   ascending     0, 1, ..., n - 1
+//   descending    n - 1, ..., 1, 0
+//   partial       ascending with the first half shuffled
+//   few_unique    DATASET_FEW_UNIQUE_KEYS distinct keys, uniformly
+//   zipf          Zipf-distributed ranks (exponent DATASET_ZIPF_EXPONENT, at most
+//                 DATASET_ZIPF_UNIVERSE of them), each rank scrambled to a key so the heavy
+//                 hitters are spread over the key range: duplicate-heavy and skewed
+//   organ_pipe    ascending to the middle, then descending
+//   sawtooth      ascending runs of about sqrt(n) elements, restarting at 0
+//   k_swaps       ascending with max(1, n / DATASET_SWAP_DIVISOR) random pairs swapped
+//   mo3_killer    Musser's median-of-3 killer permutation of 1..n, quadratic for a quicksort
+//                 that takes the median of first, middle and last as its pivot
+//
+// map_dataset keeps each generated array in cache_dir as a binary file (a 64-byte header and
+// the raw elements) and memory-maps it on later calls, so a 100M-element input costs a page
+// cache read instead of a regeneration. The file name and header carry the shape, element
+// type, size, seed and DATASET_FORMAT_VERSION; a file that does not match is regenerated.
+// New files are written under a temporary name and renamed, so concurrent runs never map a
+// partial file. Where mmap is not available the file is read into memory instead.
+
+const std::uint64_t DATASET_DEFAULT_SEED = 42;
+const int DATASET_RANDOM_MAX = 1'000'000;
+const int DATASET_FEW_UNIQUE_KEYS = 16;
+const std::size_t DATASET_ZIPF_UNIVERSE = std::size_t(1) << 20;
+const double DATASET_ZIPF_EXPONENT = 1.0;
+const std::size_t DATASET_SWAP_DIVISOR = 100;                // k_swaps: 1% of the size
+const char* const DATASET_CACHE_DIR = "dataset_cache";       // Relative to the working directory
+const std::uint32_t DATASET_FORMAT_VERSION = 1;              // Bump when a generator changes
+
+inline const std::vector<std::string>& dataset_shapes() {
+    static const std::vector<std::string> shapes = {
+        "random", "ascending", "descending", "partial", "few_unique",
+        "zipf", "organ_pipe", "sawtooth", "k_swaps", "mo3_killer"};
+    return shapes;
+}
+
+inline bool is_dataset_shape(const std::string& shape) {
+    for (const auto& s : dataset_shapes()) {
+        if (s == shape) return true;
+    }
+    return false;
+}
+
+namespace DatasetImpl {
+
+// Uniform in [0, range); the modulo bias is below 2^-40 for the ranges used here
+inline std::uint64_t bounded(std::mt19937_64& rng, std::uint64_t range) { return rng() % range; }
+
+// Uniform in [0, 1) with the full precision of T
+template<typename T>
+inline T unit(std::mt19937_64& rng) {
+    constexpr int digits = std::numeric_limits<T>::digits < 64 ? std::numeric_limits<T>::digits : 64;
+    return static_cast<T>(std::ldexp(static_cast<double>(rng() >> (64 - digits)), -digits));
+}
+
+template<typename T>
+inline T random_value(std::mt19937_64& rng) {
+    if constexpr (std::is_floating_point<T>::value) return unit<T>(rng);
+    else if constexpr (sizeof(T) >= 8) return static_cast<T>(rng());
+    else return static_cast<T>(bounded(rng, static_cast<std::uint64_t>(DATASET_RANDOM_MAX) + 1));
+}
+
+// Fisher-Yates over [first, first + n)
+template<typename T>
+inline void shuffle(T* first, std::size_t n, std::mt19937_64& rng) {
+    for (std::size_t i = n; i > 1; --i) std::swap(first[i - 1], first[bounded(rng, i)]);
+}
+
+// Bijective 32-bit mix (murmur3 finalizer)
+inline std::uint32_t scramble(std::uint32_t x) {
+    x ^= x >> 16; x *= 0x85ebca6bu;
+    x ^= x >> 13; x *= 0xc2b2ae35u;
+    return x ^ (x >> 16);
+}
+
+// Walker's alias method over ranks 0 .. universe - 1 with P(r) proportional to (r + 1)^-s:
+// O(universe) setup, then one column draw and one coin flip per sample
+class ZipfSampler {
+public:
+    ZipfSampler(std::size_t universe, double exponent) : probability_(universe, 1.0), alias_(universe) {
+        std::vector<double> scaled(universe);
+        double total = 0;
+        for (std::size_t r = 0; r < universe; ++r) total += scaled[r] = std::pow(static_cast<double>(r + 1), -exponent);
+        std::vector<std::uint32_t> small, large;
+        for (std::size_t r = 0; r < universe; ++r) {
+            scaled[r] *= static_cast<double>(universe) / total;
+            alias_[r] = static_cast<std::uint32_t>(r);
+            (scaled[r] < 1.0 ? small : large).push_back(static_cast<std::uint32_t>(r));
+        }
+        while (!small.empty() && !large.empty()) {
+            std::uint32_t s = small.back(), l = large.back();
+            small.pop_back();
+            probability_[s] = scaled[s];
+            alias_[s] = l;
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0) { large.pop_back(); small.push_back(l); }
+        }
+        // Whatever is left over is 1 up to rounding and keeps probability 1
+    }
+
+    std::uint32_t operator()(std::mt19937_64& rng) const {
+        std::size_t column = static_cast<std::size_t>(bounded(rng, probability_.size()));
+        return unit<double>(rng) < probability_[column] ? static_cast<std::uint32_t>(column) : alias_[column];
+    }
+
+private:
+    std::vector<double> probability_;
+    std::vector<std::uint32_t> alias_;
+};
+
+// Musser's sequence for n = 2k with k even; any remainder continues ascending
+template<typename T>
+inline void median_of_3_killer(std::vector<T>& arr) {
+    std::size_t n = arr.size(), m = n / 4 * 4, k = m / 2;
+    for (std::size_t i = 1; i <= k; ++i) {
+        if (i % 2 == 1) {
+            arr[i - 1] = static_cast<T>(i);
+            arr[i] = static_cast<T>(k + i);
+        }
+        arr[k + i - 1] = static_cast<T>(2 * i);
+    }
+    for (std::size_t i = m; i < n; ++i) arr[i] = static_cast<T>(i + 1);
+}
+
+// "i32", "u64", "f32", ...: the type part of cache file names
+template<typename T>
+inline std::string type_name() {
+    char kind = std::is_floating_point<T>::value ? 'f' : std::is_signed<T>::value ? 'i' : 'u';
+    return kind + std::to_string(sizeof(T) * 8);
+}
+
+template<typename T>
+inline std::uint32_t type_tag() {
+    std::uint32_t kind = std::is_floating_point<T>::value ? 2 : std::is_signed<T>::value ? 1 : 0;
+    return (kind << 8) | static_cast<std::uint32_t>(sizeof(T));
+}
+
+// Cache file header; the elements follow at offset 64
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t type;
+    std::uint64_t size;
+    std::uint64_t seed;
+    char shape[32];
+};
+static_assert(sizeof(FileHeader) == 64, "dataset file header must stay 64 bytes");
+
+const char FILE_MAGIC[8] = {'S', 'O', 'R', 'T', 'D', 'A', 'T', 'A'};
+
+template<typename T>
+inline FileHeader make_header(const std::string& shape, std::size_t size, std::uint64_t seed) {
+    FileHeader header{};
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = DATASET_FORMAT_VERSION;
+    header.type = type_tag<T>();
+    header.size = size;
+    header.seed = seed;
+    std::strncpy(header.shape, shape.c_str(), sizeof(header.shape) - 1);
+    return header;
+}
+
+template<typename T>
+inline void write_file(const std::string& path, const std::string& shape, std::uint64_t seed, const std::vector<T>& data) {
+    std::string temp = path + ".tmp";
+#if defined(__unix__) || defined(__APPLE__)
+    temp += "." + std::to_string(static_cast<long>(getpid()));
+#endif
+    std::FILE* f = std::fopen(temp.c_str(), "wb");
+    if (!f) throw std::runtime_error("dataset cache: cannot create " + temp);
+    FileHeader header = make_header<T>(shape, data.size(), seed);
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1
+           && (data.empty() || std::fwrite(data.data(), sizeof(T), data.size(), f) == data.size());
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok || std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::remove(temp.c_str());
+        throw std::runtime_error("dataset cache: cannot write " + path);
+    }
+}
+
+} // namespace DatasetImpl
+
+// The shape's array of size elements for this seed; throws std::invalid_argument for an
+// unknown shape
+template<typename T>
+inline std::vector<T> generate_dataset(const std::string& shape, std::size_t size, std::uint64_t seed = DATASET_DEFAULT_SEED) {
+    static_assert(std::is_arithmetic<T>::value, "datasets are arithmetic keys");
+    std::vector<T> arr(size);
+    std::mt19937_64 rng(seed);
+    auto ramp = [&arr]() { for (std::size_t i = 0; i < arr.size(); ++i) arr[i] = static_cast<T>(i); };
+
+    if (shape == "random") {
+        for (auto& x : arr) x = DatasetImpl::random_value<T>(rng);
+    } else if (shape == "ascending") {
+        ramp();
+    } else if (shape == "descending") {
+        for (std::size_t i = 0; i < size; ++i) arr[i] = static_cast<T>(size - 1 - i);
+    } else if (shape == "partial") {
+        ramp();
+        DatasetImpl::shuffle(arr.data(), size / 2 + size % 2, rng);
+    } else if (shape == "few_unique") {
+        for (auto& x : arr) x = static_cast<T>(DatasetImpl::bounded(rng, DATASET_FEW_UNIQUE_KEYS));
+    } else if (shape == "zipf") {
+        DatasetImpl::ZipfSampler sampler(std::max<std::size_t>(1, std::min(size, DATASET_ZIPF_UNIVERSE)), DATASET_ZIPF_EXPONENT);
+        for (auto& x : arr) x = static_cast<T>(DatasetImpl::scramble(sampler(rng)) >> 1);
+    } else if (shape == "organ_pipe") {
+        for (std::size_t i = 0; i < size; ++i) arr[i] = static_cast<T>(i < size / 2 ? i : size - 1 - i);
+    } else if (shape == "sawtooth") {
+        std::size_t period = std::max<std::size_t>(2, static_cast<std::size_t>(std::sqrt(static_cast<double>(size))));
+        for (std::size_t i = 0; i < size; ++i) arr[i] = static_cast<T>(i % period);
+    } else if (shape == "k_swaps") {
+        ramp();
+        for (std::size_t k = std::max<std::size_t>(1, size / DATASET_SWAP_DIVISOR); k > 0 && size > 1; --k) {
+            std::swap(arr[DatasetImpl::bounded(rng, size)], arr[DatasetImpl::bounded(rng, size)]);
+        }
+    } else if (shape == "mo3_killer") {
+        DatasetImpl::median_of_3_killer(arr);
+    } else {
+        throw std::invalid_argument("unknown dataset shape: " + shape);
+    }
+    return arr;
+}
+
+// A cached dataset mapped read-only into memory (or read into it where mmap is unavailable)
+template<typename T>
+class MappedDataset {
+public:
+    MappedDataset() = default;
+    MappedDataset(const MappedDataset&) = delete;
+    MappedDataset& operator=(const MappedDataset&) = delete;
+    MappedDataset(MappedDataset&& other) noexcept { *this = std::move(other); }
+    MappedDataset& operator=(MappedDataset&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            map_ = std::exchange(other.map_, nullptr);
+            map_bytes_ = std::exchange(other.map_bytes_, 0);
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            owned_ = std::move(other.owned_);
+        }
+        return *this;
+    }
+    ~MappedDataset() { unmap(); }
+
+    const T* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+    std::vector<T> to_vector() const { return std::vector<T>(begin(), end()); }
+
+    // Map path if it holds exactly this (shape, size, seed) dataset of T
+    bool open(const std::string& path, const std::string& shape, std::size_t size, std::uint64_t seed) {
+        unmap();
+        DatasetImpl::FileHeader expected = DatasetImpl::make_header<T>(shape, size, seed);
+        std::size_t bytes = sizeof(expected) + size * sizeof(T);
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        void* map = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) == bytes) {
+            map = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd); // The mapping keeps the file
+        if (map == MAP_FAILED) return false;
+        if (std::memcmp(map, &expected, sizeof(expected)) != 0) {
+            munmap(map, bytes);
+            return false;
+        }
+        map_ = map;
+        map_bytes_ = bytes;
+        data_ = reinterpret_cast<const T*>(static_cast<const char*>(map) + sizeof(expected));
+#else
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return false;
+        DatasetImpl::FileHeader header;
+        owned_.resize(size);
+        bool ok = std::fread(&header, sizeof(header), 1, f) == 1
+               && std::memcmp(&header, &expected, sizeof(header)) == 0
+               && std::fread(owned_.data(), sizeof(T), size, f) == size
+               && std::fgetc(f) == EOF;
+        std::fclose(f);
+        if (!ok) { owned_.clear(); return false; }
+        data_ = owned_.data();
+#endif
+        size_ = size;
+        return true;
+    }
+
+private:
+    void unmap() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (map_) munmap(map_, map_bytes_);
+#endif
+        map_ = nullptr;
+        map_bytes_ = 0;
+        data_ = nullptr;
+        size_ = 0;
+        owned_.clear();
+    }
+
+    void* map_ = nullptr;
+    std::size_t map_bytes_ = 0;
+    const T* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::vector<T> owned_;
+};
+
+// Cache file of a dataset: <cache_dir>/<shape>_<type>_<size>_<seed>.v<version>.bin
+template<typename T>
+inline std::string dataset_cache_path(const std::string& cache_dir, const std::string& shape, std::size_t size, std::uint64_t seed) {
+    std::string name = shape + "_" + DatasetImpl::type_name<T>() + "_" + std::to_string(size) + "_"
+                     + std::to_string(seed) + ".v" + std::to_string(DATASET_FORMAT_VERSION) + ".bin";
+    return (std::filesystem::path(cache_dir) / name).string();
+}
+
+// The dataset from cache_dir, generated and written there first if it is missing or stale;
+// throws std::runtime_error when the cache cannot be written
+template<typename T>
+inline MappedDataset<T> map_dataset(const std::string& shape, std::size_t size, std::uint64_t seed = DATASET_DEFAULT_SEED,
+                                    const std::string& cache_dir = DATASET_CACHE_DIR) {
+    if (!is_dataset_shape(shape)) throw std::invalid_argument("unknown dataset shape: " + shape);
+    std::string path = dataset_cache_path<T>(cache_dir, shape, size, seed);
+    MappedDataset<T> dataset;
+    if (dataset.open(path, shape, size, seed)) return dataset;
+
+    std::error_code ignored;
+    std::filesystem::create_directories(cache_dir, ignored);
+    DatasetImpl::write_file(path, shape, seed, generate_dataset<T>(shape, size, seed));
+    if (!dataset.open(path, shape, size, seed)) throw std::runtime_error("dataset cache: cannot map " + path);
+    return dataset;
+}
+
+// map_dataset copied into a vector, for benchmarks that sort copies of the input anyway
+template<typename T>
+inline std::vector<T> load_dataset(const std::string& shape, std::size_t size, std::uint64_t seed = DATASET_DEFAULT_SEED,
+                                   const std::string& cache_dir = DATASET_CACHE_DIR) {
+    return map_dataset<T>(shape, size, seed, cache_dir).to_vector();
+}
+
+
+// STRING CORPORA (variable-length keys)
+//
+// generate_string_dataset(corpus, size, seed) is the string counterpart of generate_dataset,
+// seeded the same way. The corpora imitate keys that get sorted in bulk, each with its own
+// prefix structure:
+//   urls      https URLs on DATASET_URL_HOSTS Zipf-popular hosts, 1-4 path segments of words
+//             and a numeric query on one in four: long shared prefixes, many near-duplicates
+//   ids       "<kind>_" and 12 random base-36 characters: a short shared tag, then random
+//   uuids     random version-4 UUIDs: no shared prefix at all, fixed length 36
+//   log_keys  "<timestamp within one day> host-NNN <service>.<LEVEL>": an 11-byte shared
+//             date prefix, then a time of day that is almost unique
+//   words     Zipf-drawn words of a DATASET_STRING_VOCABULARY-word vocabulary: short keys,
+//             heavy duplicates
+// Words are made of random syllables, so every corpus is pure ASCII. String corpora are not
+// cached on disk: generating one costs about as much as reading it back.
+
+const std::size_t DATASET_STRING_VOCABULARY = 20000; // Distinct words behind words, urls and log_keys
+const std::size_t DATASET_URL_HOSTS = 2000;          // Distinct hosts behind urls
+
+inline const std::vector<std::string>& string_dataset_corpora() {
+    static const std::vector<std::string> corpora = {"urls", "ids", "uuids", "log_keys", "words"};
+    return corpora;
+}
+
+namespace DatasetImpl {
+
+// A lowercase word of 1-4 syllables, each a consonant, a vowel and sometimes a closing consonant
+inline std::string make_word(std::mt19937_64& rng) {
+    static const char consonants[] = "bcdfghjklmnprstvwz";
+    static const char vowels[] = "aeiou";
+    std::string word;
+    for (std::uint64_t syllables = 1 + bounded(rng, 4); syllables > 0; --syllables) {
+        word += consonants[bounded(rng, sizeof(consonants) - 1)];
+        word += vowels[bounded(rng, sizeof(vowels) - 1)];
+        if (bounded(rng, 3) == 0) word += consonants[bounded(rng, sizeof(consonants) - 1)];
+    }
+    return word;
+}
+
+inline std::vector<std::string> make_vocabulary(std::mt19937_64& rng) {
+    std::vector<std::string> words(DATASET_STRING_VOCABULARY);
+    for (auto& word : words) word = make_word(rng);
+    return words;
+}
+
+// value in decimal, zero-padded to width digits
+inline void append_decimal(std::string& out, std::uint64_t value, int width) {
+    char digits[20];
+    int count = 0;
+    do { digits[count++] = static_cast<char>('0' + value % 10); value /= 10; } while (value != 0);
+    for (int i = count; i < width; ++i) out += '0';
+    while (count > 0) out += digits[--count];
+}
+
+// count random characters of alphabet
+inline void append_random(std::string& out, const char* alphabet, std::size_t alphabet_size, int count, std::mt19937_64& rng) {
+    for (int i = 0; i < count; ++i) out += alphabet[bounded(rng, alphabet_size)];
+}
+
+} // namespace DatasetImpl
+
+// The corpus' size strings for this seed; throws std::invalid_argument for an unknown corpus
+inline std::vector<std::string> generate_string_dataset(const std::string& corpus, std::size_t size,
+                                                        std::uint64_t seed = DATASET_DEFAULT_SEED) {
+    static const char base36[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    std::vector<std::string> strings;
+    strings.reserve(size);
+    std::mt19937_64 rng(seed);
+
+    if (corpus == "urls") {
+        static const char* const domains[] = {".com", ".org", ".net", ".io", ".de"};
+        std::vector<std::string> words = DatasetImpl::make_vocabulary(rng);
+        DatasetImpl::ZipfSampler host_rank(DATASET_URL_HOSTS, DATASET_ZIPF_EXPONENT), word_rank(words.size(), DATASET_ZIPF_EXPONENT);
+        for (std::size_t i = 0; i < size; ++i) {
+            std::uint32_t host = DatasetImpl::scramble(host_rank(rng));
+            std::string url = host % 2 ? "https://www." : "https://";
+            url += words[host % words.size()];
+            url += domains[(host >> 16) % 5];
+            for (std::uint64_t segments = 1 + DatasetImpl::bounded(rng, 4); segments > 0; --segments) {
+                url += '/';
+                url += words[word_rank(rng)];
+            }
+            if (DatasetImpl::bounded(rng, 4) == 0) {
+                url += "?id=";
+                DatasetImpl::append_decimal(url, DatasetImpl::bounded(rng, 1'000'000), 0);
+            }
+            strings.push_back(std::move(url));
+        }
+    } else if (corpus == "ids") {
+        static const char* const kinds[] = {"user_", "order_", "session_", "invoice_"};
+        for (std::size_t i = 0; i < size; ++i) {
+            std::string id = kinds[DatasetImpl::bounded(rng, 4)];
+            DatasetImpl::append_random(id, base36, 36, 12, rng);
+            strings.push_back(std::move(id));
+        }
+    } else if (corpus == "uuids") {
+        for (std::size_t i = 0; i < size; ++i) {
+            std::string uuid;
+            DatasetImpl::append_random(uuid, base36, 16, 8, rng);
+            uuid += '-';
+            DatasetImpl::append_random(uuid, base36, 16, 4, rng);
+            uuid += "-4";
+            DatasetImpl::append_random(uuid, base36, 16, 3, rng);
+            uuid += '-';
+            uuid += "89ab"[DatasetImpl::bounded(rng, 4)];
+            DatasetImpl::append_random(uuid, base36, 16, 3, rng);
+            uuid += '-';
+            DatasetImpl::append_random(uuid, base36, 16, 12, rng);
+            strings.push_back(std::move(uuid));
+        }
+    } else if (corpus == "log_keys") {
+        static const char* const levels[] = {".INFO", ".INFO", ".INFO", ".DEBUG", ".WARN", ".ERROR"};
+        std::vector<std::string> services = DatasetImpl::make_vocabulary(rng);
+        services.resize(64);
+        for (std::size_t i = 0; i < size; ++i) {
+            std::uint64_t ms = DatasetImpl::bounded(rng, 86'400'000);
+            std::string key = "2026-10-17T";
+            DatasetImpl::append_decimal(key, ms / 3'600'000, 2);
+            key += ':';
+            DatasetImpl::append_decimal(key, ms / 60'000 % 60, 2);
+            key += ':';
+            DatasetImpl::append_decimal(key, ms / 1000 % 60, 2);
+            key += '.';
+            DatasetImpl::append_decimal(key, ms % 1000, 3);
+            key += "Z host-";
+            DatasetImpl::append_decimal(key, DatasetImpl::bounded(rng, 256), 3);
+            key += ' ';
+            key += services[DatasetImpl::bounded(rng, services.size())];
+            key += levels[DatasetImpl::bounded(rng, 6)];
+            strings.push_back(std::move(key));
+        }
+    } else if (corpus == "words") {
+        std::vector<std::string> words = DatasetImpl::make_vocabulary(rng);
+        DatasetImpl::ZipfSampler word_rank(words.size(), DATASET_ZIPF_EXPONENT);
+        for (std::size_t i = 0; i < size; ++i) strings.push_back(words[word_rank(rng)]);
+    } else {
+        throw std::invalid_argument("unknown string corpus: " + corpus);
+    }
+    return strings;
+}
+
+
+#endif
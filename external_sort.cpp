@@ -0,0 +1,120 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>    // std::strtoull
+#include <exception>  // for std::exception
+#include <filesystem>
+#include <iomanip>    //  std::setw, std::left (formatting output)
+
+#include "external_sort.h"
+
+// External sort driver.
+//
+//   external_sort <input> <output> [--type int32|int64|float] [--memory MiB] [--block KiB] [--temp DIR]
+//       Sorts a raw binary key file through temporary run files.
+//   external_sort --self-test [--elements N] [--memory MiB] [--block KiB] [--temp DIR]
+//       Writes N random int32 keys to a temp file, sorts them with the (deliberately small)
+//       memory budget, verifies the output against std::sort and removes the files.
+
+// Constants
+const std::uint64_t SELF_TEST_ELEMENTS = 16'000'000; // 64 MB of int32 keys
+const std::size_t SELF_TEST_MEMORY_MIB = 4;          // Forces ~48 runs and a multi-run merge
+
+
+void print_stats(const ExternalSortStats& stats) {
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::left << std::setw(20) << "Elements:" << stats.elements << "\n";
+    std::cout << std::left << std::setw(20) << "Runs:" << stats.runs << " (fan-in " << stats.fan_in << ", "
+              << stats.merge_passes << " merge pass" << (stats.merge_passes == 1 ? "" : "es") << ")\n";
+    std::cout << std::left << std::setw(20) << "Bytes read:" << stats.bytes_read << "\n";
+    std::cout << std::left << std::setw(20) << "Bytes written:" << stats.bytes_written << "\n";
+    std::cout << std::left << std::setw(20) << "Run generation:" << std::setw(12) << std::right << stats.run_generation_ms << " ms\n";
+    std::cout << std::left << std::setw(20) << "Merge:" << std::setw(12) << std::right << stats.merge_ms << " ms\n";
+}
+
+template <typename T>
+std::vector<T> read_file(const std::string& path) {
+    std::vector<T> keys(std::filesystem::file_size(path) / sizeof(T));
+    ExternalSortImpl::FileHandle f = ExternalSortImpl::open_file(path, "rb");
+    if (std::fread(keys.data(), sizeof(T), keys.size(), f.get()) != keys.size()) throw std::runtime_error("short read from " + path);
+    return keys;
+}
+
+int run_self_test(std::uint64_t elements, const ExternalSortOptions& options) {
+    std::filesystem::path dir = options.temp_dir.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(options.temp_dir);
+    std::string input = (dir / "external_sort_self_test.in").string();
+    std::string output = (dir / "external_sort_self_test.out").string();
+
+    std::cout << "Self-test: " << elements << " random int32 keys, memory budget " << (options.memory_budget >> 20) << " MiB\n" << std::flush;
+    std::vector<std::int32_t> keys(elements);
+    std::mt19937 rng(std::random_device{}());
+    for (auto& k : keys) k = static_cast<std::int32_t>(rng());
+    {
+        ExternalSortImpl::FileHandle f = ExternalSortImpl::open_file(input, "wb");
+        if (std::fwrite(keys.data(), sizeof(std::int32_t), keys.size(), f.get()) != keys.size()) throw std::runtime_error("cannot write " + input);
+    }
+
+    ExternalSortStats stats = external_sort<std::int32_t>(input, output, options);
+    print_stats(stats);
+
+    std::sort(keys.begin(), keys.end());
+    bool ok = read_file<std::int32_t>(output) == keys;
+    std::filesystem::remove(input);
+    std::filesystem::remove(output);
+    std::cout << (ok ? "Self-test passed." : "!!! Self-test FAILED: output differs from std::sort !!!") << std::endl;
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    ExternalSortOptions options;
+    std::vector<std::string> positional;
+    std::string type = "int32";
+    bool self_test = false;
+    bool memory_set = false;
+    std::uint64_t elements = SELF_TEST_ELEMENTS;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--self-test") self_test = true;
+        else if (arg == "--type" && has_value) type = argv[++i];
+        else if (arg == "--memory" && has_value) { options.memory_budget = std::strtoull(argv[++i], nullptr, 10) << 20; memory_set = true; }
+        else if (arg == "--block" && has_value) options.block_size = std::strtoull(argv[++i], nullptr, 10) << 10;
+        else if (arg == "--temp" && has_value) options.temp_dir = argv[++i];
+        else if (arg == "--elements" && has_value) elements = std::strtoull(argv[++i], nullptr, 10);
+        else if (!arg.empty() && arg[0] != '-') positional.push_back(arg);
+        else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return 2;
+        }
+    }
+
+    try {
+        if (self_test) {
+            if (!memory_set) options.memory_budget = SELF_TEST_MEMORY_MIB << 20;
+            return run_self_test(elements, options);
+        }
+        if (positional.size() != 2) {
+            std::cerr << "Usage: " << argv[0] << " <input> <output> [--type int32|int64|float] [--memory MiB] [--block KiB] [--temp DIR]\n"
+                      << "       " << argv[0] << " --self-test [--elements N] [--memory MiB] [--block KiB] [--temp DIR]" << std::endl;
+            return 2;
+        }
+
+        ExternalSortStats stats;
+        if (type == "int32") stats = external_sort<std::int32_t>(positional[0], positional[1], options);
+        else if (type == "int64") stats = external_sort<std::int64_t>(positional[0], positional[1], options);
+        else if (type == "float") stats = external_sort<float>(positional[0], positional[1], options);
+        else {
+            std::cerr << "Unknown key type: " << type << std::endl;
+            return 2;
+        }
+        print_stats(stats);
+    } catch (const std::exception& e) {
+        std::cerr << "!!! External sort failed: " << e.what() << " !!!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,346 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <algorithm>   // std::min, std::max
+#include <atomic>
+#include <chrono>
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint64_t
+#include <cstdio>      // std::FILE, std::fopen, std::fread, std::fwrite
+#include <filesystem>
+#include <functional>  // std::less
+#include <future>      // std::future, std::packaged_task
+#include <memory>      // std::shared_ptr, std::unique_ptr
+#include <stdexcept>   // std::invalid_argument, std::runtime_error
+#include <string>
+#include <type_traits> // std::is_trivially_copyable
+#include <utility>     // std::move, std::swap
+#include <vector>
+
+#include "task_pool.h"   // TaskPool (sort workers and the background IO thread)
+#include "sorting.h"     // quickSort (in-memory run sort)
+#include "loser_tree.h"  // LoserTree (k-way merge)
+
+
+// EXTERNAL-MEMORY SORT
+//
+// Sorts a binary file of fixed-width keys (native byte order, no header) that may be much
+// larger than RAM, in two phases:
+//  1. Run generation: the input is streamed in chunks that fit the memory budget, each chunk
+//     is sorted in memory with quickSort and written out as a sorted run file. Three chunk
+//     buffers rotate so that reading chunk i+1, sorting chunk i and writing chunk i-1 overlap.
+//  2. Merge: up to max fan-in runs are merged at a time through a LoserTree. Every run reader
+//     and the output writer are double-buffered: one block is consumed / filled while the
+//     other is read / written on a background IO thread. Runs that exceed the fan-in are
+//     merged in several passes through intermediate run files.
+// All disk traffic (input, temporary runs, output) is counted in ExternalSortStats.
+
+const std::size_t EXTERNAL_SORT_DEFAULT_MEMORY = std::size_t(256) << 20; // 256 MiB
+const std::size_t EXTERNAL_SORT_DEFAULT_BLOCK = std::size_t(1) << 20;    // 1 MiB IO blocks
+const std::size_t EXTERNAL_SORT_MIN_BLOCK = std::size_t(64) << 10;       // 64 KiB
+
+struct ExternalSortOptions {
+    std::size_t memory_budget = EXTERNAL_SORT_DEFAULT_MEMORY; // Bytes of key buffers in either phase
+    std::size_t block_size = EXTERNAL_SORT_DEFAULT_BLOCK;     // Bytes per merge IO buffer (shrunk to fit the budget)
+    std::string temp_dir;                                     // Run files; empty = system temp directory
+    TaskPool* pool = nullptr;                                 // In-memory sort workers; nullptr = default_task_pool()
+};
+
+struct ExternalSortStats {
+    std::uint64_t elements = 0;
+    std::uint64_t bytes_read = 0;    // Input plus run files read back
+    std::uint64_t bytes_written = 0; // Run files plus output
+    std::size_t runs = 0;            // Sorted runs produced by phase 1
+    std::size_t merge_passes = 0;    // Passes over the data in phase 2
+    std::size_t fan_in = 0;          // Runs merged at once
+    double run_generation_ms = 0;
+    double merge_ms = 0;
+};
+
+namespace ExternalSortImpl {
+
+// Run f on the IO pool and hand back its result through a future
+template<typename Func>
+inline auto run_async(TaskPool& io, Func f) -> std::future<decltype(f())> {
+    auto task = std::make_shared<std::packaged_task<decltype(f())()>>(std::move(f));
+    auto result = task->get_future();
+    io.submit([task]() { (*task)(); });
+    return result;
+}
+
+struct FileCloser {
+    void operator()(std::FILE* f) const { if (f) std::fclose(f); }
+};
+using FileHandle = std::unique_ptr<std::FILE, FileCloser>;
+
+inline FileHandle open_file(const std::string& path, const char* mode) {
+    FileHandle f(std::fopen(path.c_str(), mode));
+    if (!f) throw std::runtime_error("external_sort: cannot open " + path);
+    std::setvbuf(f.get(), nullptr, _IONBF, 0); // Blocks are already large; skip stdio's copy
+    return f;
+}
+
+// Read up to count keys; short only at end of file
+template<typename T>
+inline std::size_t read_keys(std::FILE* f, T* data, std::size_t count, std::atomic<std::uint64_t>& bytes_read) {
+    std::size_t got = std::fread(data, sizeof(T), count, f);
+    if (got < count && std::ferror(f)) throw std::runtime_error("external_sort: read error");
+    bytes_read += got * sizeof(T);
+    return got;
+}
+
+template<typename T>
+inline void write_keys(std::FILE* f, const T* data, std::size_t count, std::atomic<std::uint64_t>& bytes_written) {
+    if (std::fwrite(data, sizeof(T), count, f) != count) throw std::runtime_error("external_sort: write error");
+    bytes_written += count * sizeof(T);
+}
+
+// Deletes the run files it tracks, also when the sort throws
+class TempFiles {
+public:
+    explicit TempFiles(const std::string& dir) {
+        std::filesystem::path base = dir.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(dir);
+        auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        prefix_ = (base / ("external_sort_" + std::to_string(stamp) + "_" + std::to_string(reinterpret_cast<std::uintptr_t>(this)) + "_")).string();
+    }
+    ~TempFiles() {
+        for (const auto& path : paths_) remove(path);
+    }
+    TempFiles(const TempFiles&) = delete;
+    TempFiles& operator=(const TempFiles&) = delete;
+
+    std::string create() {
+        paths_.push_back(prefix_ + std::to_string(counter_++) + ".run");
+        return paths_.back();
+    }
+    void remove(const std::string& path) {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+    }
+
+private:
+    std::string prefix_;
+    std::size_t counter_ = 0;
+    std::vector<std::string> paths_;
+};
+
+// Sequential reader of one sorted run, refilling the idle block in the background
+template<typename T>
+class RunReader {
+public:
+    RunReader(const std::string& path, std::size_t block_keys, TaskPool& io, std::atomic<std::uint64_t>& bytes_read)
+        : file_(open_file(path, "rb")), block_keys_(block_keys), io_(io), bytes_read_(bytes_read) {
+        current_.resize(block_keys_);
+        next_.resize(block_keys_);
+        length_ = read_keys(file_.get(), current_.data(), block_keys_, bytes_read_);
+        prefetch();
+    }
+    ~RunReader() {
+        if (pending_.valid()) pending_.wait();
+    }
+
+    bool empty() const { return pos_ == length_; }
+    const T& front() const { return current_[pos_]; }
+
+    // Step to the next key; false once the run is exhausted
+    bool advance() {
+        if (++pos_ < length_) return true;
+        if (length_ < block_keys_) return false; // Short block: end of file
+        length_ = pending_.get();
+        std::swap(current_, next_);
+        pos_ = 0;
+        if (length_ == 0) return false;
+        prefetch();
+        return true;
+    }
+
+private:
+    void prefetch() {
+        if (length_ < block_keys_) return;
+        pending_ = run_async(io_, [this]() { return read_keys(file_.get(), next_.data(), block_keys_, bytes_read_); });
+    }
+
+    FileHandle file_;
+    std::size_t block_keys_;
+    TaskPool& io_;
+    std::atomic<std::uint64_t>& bytes_read_;
+    std::vector<T> current_, next_;
+    std::size_t pos_ = 0, length_ = 0;
+    std::future<std::size_t> pending_;
+};
+
+// Sequential writer: fills one block while the previous one is written in the background
+template<typename T>
+class RunWriter {
+public:
+    RunWriter(const std::string& path, std::size_t block_keys, TaskPool& io, std::atomic<std::uint64_t>& bytes_written)
+        : file_(open_file(path, "wb")), block_keys_(block_keys), io_(io), bytes_written_(bytes_written) {
+        current_.reserve(block_keys_);
+        flushing_.reserve(block_keys_);
+    }
+    ~RunWriter() {
+        if (pending_.valid()) pending_.wait();
+    }
+
+    void push(const T& key) {
+        current_.push_back(key);
+        if (current_.size() == block_keys_) flush_block();
+    }
+
+    // Write out everything buffered and wait for it; rethrows IO errors
+    void finish() {
+        flush_block();
+        if (pending_.valid()) pending_.get();
+        if (std::fflush(file_.get()) != 0) throw std::runtime_error("external_sort: write error");
+    }
+
+private:
+    void flush_block() {
+        if (pending_.valid()) pending_.get();
+        std::swap(current_, flushing_);
+        current_.clear();
+        if (flushing_.empty()) return;
+        pending_ = run_async(io_, [this]() { write_keys(file_.get(), flushing_.data(), flushing_.size(), bytes_written_); });
+    }
+
+    FileHandle file_;
+    std::size_t block_keys_;
+    TaskPool& io_;
+    std::atomic<std::uint64_t>& bytes_written_;
+    std::vector<T> current_, flushing_;
+    std::future<void> pending_;
+};
+
+// Merge the given sorted run files into one file with a LoserTree
+template<typename T, typename Compare>
+inline void merge_runs(const std::vector<std::string>& inputs, const std::string& output, std::size_t block_keys,
+                       Compare comp, TaskPool& io, std::atomic<std::uint64_t>& bytes_read, std::atomic<std::uint64_t>& bytes_written) {
+    std::vector<std::unique_ptr<RunReader<T>>> readers;
+    readers.reserve(inputs.size());
+    for (const auto& path : inputs) readers.emplace_back(new RunReader<T>(path, block_keys, io, bytes_read));
+
+    RunWriter<T> writer(output, block_keys, io, bytes_written);
+    LoserTree<T, Compare> tree(readers.size(), comp);
+    for (std::size_t i = 0; i < readers.size(); ++i) {
+        if (readers[i]->empty()) tree.set_exhausted(i);
+        else tree.set_source(i, readers[i]->front());
+    }
+    tree.build();
+
+    while (!tree.empty()) {
+        std::size_t source = tree.winner();
+        writer.push(tree.winner_key());
+        RunReader<T>& reader = *readers[source];
+        if (reader.advance()) tree.replace_winner(reader.front());
+        else tree.exhaust_winner();
+    }
+    writer.finish();
+}
+
+} // namespace ExternalSortImpl
+
+// Sort the keys in input_path into output_path (which may be the input file itself). Keys are
+// raw T values; the file size must be a multiple of sizeof(T). Throws std::invalid_argument for
+// a budget too small to work with and std::runtime_error on IO failures.
+template<typename T, typename Compare = std::less<>>
+inline ExternalSortStats external_sort(const std::string& input_path, const std::string& output_path,
+                                       const ExternalSortOptions& options = {}, Compare comp = {}) {
+    using namespace ExternalSortImpl;
+    using Clock = std::chrono::steady_clock;
+    static_assert(std::is_trivially_copyable<T>::value, "external_sort stores keys as raw bytes");
+
+    if (options.memory_budget < 4 * EXTERNAL_SORT_MIN_BLOCK) throw std::invalid_argument("external_sort: memory budget must be at least 256 KiB");
+    auto size = std::filesystem::file_size(input_path);
+    if (size % sizeof(T) != 0) throw std::invalid_argument("external_sort: input size is not a multiple of the key size");
+
+    TaskPool& pool = options.pool ? *options.pool : default_task_pool();
+    TaskPool io(1); // Background IO thread; blocking reads / writes stay off the sort workers
+    TempFiles temp(options.temp_dir);
+    std::atomic<std::uint64_t> bytes_read{0}, bytes_written{0};
+    ExternalSortStats stats;
+
+    // Phase 1: run generation with three rotating chunk buffers
+    auto phase_start = Clock::now();
+    std::vector<std::string> runs;
+    {
+        const std::size_t chunk_keys = options.memory_budget / (3 * sizeof(T));
+        FileHandle input = open_file(input_path, "rb");
+        std::vector<T> buffers[3];
+        std::future<void> writes[3];
+        for (auto& b : buffers) b.resize(chunk_keys);
+
+        std::future<std::size_t> next_read = run_async(io, [&]() { return read_keys(input.get(), buffers[0].data(), chunk_keys, bytes_read); });
+        // In-flight IO refers to the buffers above: let it finish before they go away
+        auto drain = [&]() {
+            if (next_read.valid()) next_read.wait();
+            for (auto& w : writes) {
+                if (w.valid()) w.wait();
+            }
+        };
+        try {
+            for (std::size_t i = 0;; ++i) {
+                std::size_t cur = i % 3, nxt = (i + 1) % 3;
+                std::size_t count = next_read.get();
+                if (count == 0) break;
+                stats.elements += count;
+                if (writes[nxt].valid()) writes[nxt].get(); // Chunk i-2 must be on disk before reuse
+                if (count == chunk_keys) {
+                    next_read = run_async(io, [&, nxt]() { return read_keys(input.get(), buffers[nxt].data(), chunk_keys, bytes_read); });
+                } else {
+                    next_read = run_async(io, []() { return std::size_t(0); }); // Short chunk: end of input
+                }
+
+                quickSort(buffers[cur].begin(), buffers[cur].begin() + count, comp, identity_projection(), pool);
+
+                runs.push_back(temp.create());
+                std::string path = runs.back();
+                writes[cur] = run_async(io, [&, cur, count, path]() {
+                    FileHandle out = open_file(path, "wb");
+                    write_keys(out.get(), buffers[cur].data(), count, bytes_written);
+                });
+            }
+            for (auto& w : writes) {
+                if (w.valid()) w.get();
+            }
+        } catch (...) {
+            drain();
+            throw;
+        }
+    }
+    stats.runs = runs.size();
+    stats.run_generation_ms = std::chrono::duration<double, std::milli>(Clock::now() - phase_start).count();
+
+    // Phase 2: loser-tree merges; each input and the output hold two blocks. Blocks shrink
+    // (down to EXTERNAL_SORT_MIN_BLOCK) so that, if possible, all runs merge in a single pass.
+    phase_start = Clock::now();
+    std::size_t single_pass_block = options.memory_budget / (2 * (runs.size() + 1));
+    std::size_t block_bytes = std::max(EXTERNAL_SORT_MIN_BLOCK, std::min(options.block_size, single_pass_block));
+    std::size_t block_keys = std::max<std::size_t>(1, block_bytes / sizeof(T));
+    std::size_t fan_in = std::max<std::size_t>(2, options.memory_budget / (2 * block_keys * sizeof(T)) - 1);
+    stats.fan_in = fan_in;
+
+    if (runs.empty()) {
+        open_file(output_path, "wb"); // Empty input, empty output
+    }
+    while (!runs.empty()) {
+        ++stats.merge_passes;
+        bool final_pass = runs.size() <= fan_in;
+        std::vector<std::string> merged;
+        for (std::size_t first = 0; first < runs.size(); first += fan_in) {
+            std::vector<std::string> group(runs.begin() + first, runs.begin() + std::min(runs.size(), first + fan_in));
+            std::string target = final_pass ? output_path : temp.create();
+            merge_runs<T>(group, target, block_keys, comp, io, bytes_read, bytes_written);
+            for (const auto& path : group) temp.remove(path);
+            if (!final_pass) merged.push_back(target);
+        }
+        runs.swap(merged);
+    }
+    stats.merge_ms = std::chrono::duration<double, std::milli>(Clock::now() - phase_start).count();
+
+    stats.bytes_read = bytes_read;
+    stats.bytes_written = bytes_written;
+    return stats;
+}
+
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef HEAP_ENGINE_H
+#define HEAP_ENGINE_H
+
+#include <algorithm>   // std::min, std::iter_swap
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <cstdint>     // std::uintptr_t
+#include <iterator>    // std::iterator_traits
+#include <memory>      // std::addressof
+#include <type_traits> // std::is_arithmetic
+#include <utility>     // std::move, std::swap
+
+#include "sort_counters.h" // SORT_COUNT_LOOP (no-op unless SORT_COUNTERS)
+
+
+// HEAP ENGINE (shared by heapSort, tournament_sort, heapify and the pdqsort heapsort fallback)
+//
+// Iterative max-heaps with Arity children per node (2, 4 or 8): node i's children are
+// Arity * i + 1 .. Arity * i + Arity, so a d-ary heap has log_d n levels and one child group
+// of d small keys sits in a single cache line. heap_sift_down is the classic top-down sift
+// (d comparisons per level). heap_pop_bottom_up is Floyd's variant for the sort phase: the
+// element moved to the root came from the bottom and almost always goes back there, so the
+// hole is first walked down to a leaf along the largest children (d - 1 comparisons per
+// level, no comparison against the sifted value) and the value then climbs the few levels it
+// needs. For binary heaps that is about half the comparisons of the top-down sift.
+//
+// Both sifts prefetch the grandchildren of the node they are at, which form one contiguous
+// block of d^2 elements, so the next level's cache miss overlaps the current comparisons.
+// heap_sort_range can also align the heap to the cache line: when d keys fill a divisor of
+// the line, up to d - 1 leading elements are peeled off (the smallest ones, found in one pass)
+// so that every child group starts on a group boundary and never straddles two lines.
+//
+// The default arity is 8 for arithmetic keys, where a comparison is cheap and every level is
+// a potential cache miss, and 2 otherwise, where the bottom-up binary heap needs the fewest
+// comparisons (about log2 n per pop against 7/3 log2 n for 8-ary).
+//
+// With -DSORT_COUNTERS each level a sift descends counts as one level of recursion depth, as
+// in the recursive heapify this engine replaced.
+
+const std::size_t HEAP_CACHELINE_SIZE = 64;
+
+template<typename T>
+constexpr int heap_default_arity() { return std::is_arithmetic<T>::value ? 8 : 2; }
+
+namespace HeapImpl {
+
+// Prefetch the children of the Arity nodes starting at child: one block of Arity^2 elements
+template<int Arity, typename RandomIt>
+inline void prefetch_grandchildren(RandomIt first, std::ptrdiff_t child, std::ptrdiff_t n) {
+#if defined(__GNUC__)
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    constexpr std::ptrdiff_t per_line = sizeof(T) < HEAP_CACHELINE_SIZE ? HEAP_CACHELINE_SIZE / sizeof(T) : 1;
+    std::ptrdiff_t begin = Arity * child + 1, end = std::min<std::ptrdiff_t>(begin + Arity * Arity, n);
+    for (std::ptrdiff_t i = begin; i < end; i += per_line) __builtin_prefetch(std::addressof(first[i]));
+#else
+    (void)first; (void)child; (void)n;
+#endif
+}
+
+// Index of the largest of first[base .. base + Count) as a tournament of pairs: the outcome
+// of each match becomes an index offset instead of a branch, which random keys would mispredict
+template<int Count, typename RandomIt, typename Compare>
+inline std::ptrdiff_t largest_of(RandomIt first, std::ptrdiff_t base, Compare& comp) {
+    if constexpr (Count == 1) {
+        (void)first; (void)comp;
+        return base;
+    } else {
+        std::ptrdiff_t a = largest_of<Count / 2>(first, base, comp);
+        std::ptrdiff_t b = largest_of<Count / 2>(first, base + Count / 2, comp);
+        return a + static_cast<std::ptrdiff_t>(comp(first[a], first[b])) * (b - a);
+    }
+}
+
+// The largest of the children starting at child (the last group may be partial)
+template<int Arity, typename RandomIt, typename Compare>
+inline std::ptrdiff_t largest_child(RandomIt first, std::ptrdiff_t child, std::ptrdiff_t n, Compare& comp) {
+    if (child + Arity <= n) return largest_of<Arity>(first, child, comp);
+    std::ptrdiff_t best = child;
+    for (std::ptrdiff_t c = child + 1; c < n; ++c) best = comp(first[best], first[c]) ? c : best;
+    return best;
+}
+
+// Leading elements to skip so that every child group of the remaining heap starts on an
+// Arity * sizeof(T) boundary; 0 when the groups do not divide a cache line
+template<int Arity, typename RandomIt>
+inline std::ptrdiff_t aligned_offset(RandomIt first, std::ptrdiff_t n) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    constexpr std::size_t group = Arity * sizeof(T);
+    if constexpr (Arity == 2 || HEAP_CACHELINE_SIZE % group != 0) {
+        (void)first; (void)n;
+        return 0;
+    } else {
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(std::addressof(*first));
+        if (address % sizeof(T) != 0) return 0;
+        // Children of element j start at element Arity * j + 1
+        std::ptrdiff_t offset = static_cast<std::ptrdiff_t>((Arity - (address / sizeof(T) + 1) % Arity) % Arity);
+        return std::min(offset, n);
+    }
+}
+
+// Move the k smallest elements into [first, first + k) in sorted order, one pass over the rest
+template<typename RandomIt, typename Compare>
+inline void select_smallest_prefix(RandomIt first, std::ptrdiff_t k, std::ptrdiff_t n, Compare& comp) {
+    auto sink = [&](std::ptrdiff_t j) { // Insertion step within the prefix
+        for (; j > 0 && comp(first[j], first[j - 1]); --j) std::iter_swap(first + j, first + j - 1);
+    };
+    for (std::ptrdiff_t i = 1; i < k; ++i) sink(i);
+    for (std::ptrdiff_t i = k; i < n; ++i) {
+        if (comp(first[i], first[k - 1])) {
+            std::iter_swap(first + i, first + k - 1);
+            sink(k - 1);
+        }
+    }
+}
+
+} // namespace HeapImpl
+
+// Top-down sift of first[i] within the heap [first, first + n)
+template<int Arity, typename RandomIt, typename Compare>
+inline void heap_sift_down(RandomIt first, std::ptrdiff_t n, std::ptrdiff_t i, Compare& comp) {
+    SORT_COUNT_LOOP();
+    auto value = std::move(first[i]);
+    for (std::ptrdiff_t child = Arity * i + 1; child < n; child = Arity * i + 1) {
+        HeapImpl::prefetch_grandchildren<Arity>(first, child, n);
+        std::ptrdiff_t c = HeapImpl::largest_child<Arity>(first, child, n, comp);
+        if (!comp(value, first[c])) break;
+        SORT_COUNT_LOOP_STEP();
+        first[i] = std::move(first[c]);
+        i = c;
+    }
+    first[i] = std::move(value);
+}
+
+// Floyd's heap construction: sift every internal node, the last one first
+template<int Arity, typename RandomIt, typename Compare>
+inline void heap_make(RandomIt first, std::ptrdiff_t n, Compare& comp) {
+    for (std::ptrdiff_t i = (n - 2) / Arity; n > 1 && i >= 0; --i) heap_sift_down<Arity>(first, n, i, comp);
+}
+
+// Move the maximum to first[n - 1] and restore the heap on [first, first + n - 1), bottom-up
+template<int Arity, typename RandomIt, typename Compare>
+inline void heap_pop_bottom_up(RandomIt first, std::ptrdiff_t n, Compare& comp) {
+    if (n < 2) return;
+    SORT_COUNT_LOOP();
+    auto value = std::move(first[n - 1]);
+    first[n - 1] = std::move(first[0]);
+    std::ptrdiff_t size = n - 1, hole = 0;
+    for (std::ptrdiff_t child = 1; child < size; child = Arity * hole + 1) { // Down to a leaf
+        HeapImpl::prefetch_grandchildren<Arity>(first, child, size);
+        std::ptrdiff_t c = HeapImpl::largest_child<Arity>(first, child, size, comp);
+        SORT_COUNT_LOOP_STEP();
+        first[hole] = std::move(first[c]);
+        hole = c;
+    }
+    while (hole > 0) { // Back up to where value belongs
+        std::ptrdiff_t parent = (hole - 1) / Arity;
+        if (!comp(first[parent], value)) break;
+        first[hole] = std::move(first[parent]);
+        hole = parent;
+    }
+    first[hole] = std::move(value);
+}
+
+// Heapsort of [first, last) with a d-ary heap (Arity 0: heap_default_arity), bottom-up pops
+// and, if align is set, the heap aligned to the cache line
+template<int Arity = 0, typename RandomIt, typename Compare>
+inline void heap_sort_range(RandomIt first, RandomIt last, Compare& comp, bool align = true) {
+    constexpr int arity = Arity != 0 ? Arity : heap_default_arity<typename std::iterator_traits<RandomIt>::value_type>();
+    static_assert(arity == 2 || arity == 4 || arity == 8, "heap arity must be 2, 4 or 8");
+    std::ptrdiff_t n = last - first;
+    if (n < 2) return;
+    if (align) {
+        std::ptrdiff_t offset = HeapImpl::aligned_offset<arity>(first, n);
+        if (offset > 0) {
+            HeapImpl::select_smallest_prefix(first, offset, n, comp);
+            first += offset;
+            n -= offset;
+        }
+    }
+    heap_make<arity>(first, n, comp);
+    for (std::ptrdiff_t size = n; size > 1; --size) heap_pop_bottom_up<arity>(first, size, comp);
+}
+
+
+#endif
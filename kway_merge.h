@@ -0,0 +1,181 @@
+#ifndef KWAY_MERGE_H
+#define KWAY_MERGE_H
+
+#include <algorithm>   // std::copy, std::lower_bound, std::upper_bound, std::sort
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <functional>  // std::less
+#include <iterator>    // std::iterator_traits
+#include <stdexcept>   // std::invalid_argument
+#include <utility>     // std::pair
+#include <vector>
+
+#include "task_pool.h"   // TaskPool, TaskGroup, default_task_pool
+#include "sort_common.h" // identity_projection, make_projected_compare
+#include "sort_tuning.h" // sort_tuning() (parallel merge threshold)
+#include "loser_tree.h"  // LoserTree
+
+
+// K-WAY MERGE OF PRESORTED RUNS
+//
+// kway_merge copies K sorted runs into one sorted output through a LoserTree holding a copy
+// of each run's head: ceil(log2 K) comparisons per output element, no re-sorting of data that is already
+// in order. Ties go to the earlier run, so the merge is stable in run order.
+//
+// multiway_split is exact multi-sequence selection: for a rank r it returns one split
+// position per run such that the split prefixes hold exactly the first r elements of the
+// stable merged order. Each round takes the weighted median of the medians of the runs' active
+// windows as pivot, ranks it with one binary search per run and drops at least a quarter of the
+// active elements: O(log n) rounds of O(K log n). parallel_kway_merge splits the output into one
+// range per pool thread with it and merges the ranges independently.
+
+// A sorted input run [first, second)
+template<typename RandomIt>
+using SortedRun = std::pair<RandomIt, RandomIt>;
+
+namespace KwayMergeImpl {
+
+template<typename RandomIt>
+inline std::ptrdiff_t total_size(const std::vector<SortedRun<RandomIt>>& runs) {
+    std::ptrdiff_t total = 0;
+    for (const auto& run : runs) {
+        if (run.second < run.first) throw std::invalid_argument("kway_merge: run ends before it begins");
+        total += run.second - run.first;
+    }
+    return total;
+}
+
+// Elements of run j that come before element (run i, position p) in the stable merged order
+template<typename RandomIt, typename Compare>
+inline std::ptrdiff_t position_before(const SortedRun<RandomIt>& run, std::size_t j, std::size_t i, RandomIt element, std::ptrdiff_t p, Compare& comp) {
+    if (j == i) return p;
+    if (j < i) return std::upper_bound(run.first, run.second, *element, comp) - run.first; // Equal keys of earlier runs come first
+    return std::lower_bound(run.first, run.second, *element, comp) - run.first;
+}
+
+template<typename RandomIt, typename OutIt, typename Compare>
+inline OutIt merge_runs(std::vector<SortedRun<RandomIt>> runs, OutIt out, Compare& comp) {
+    std::size_t k = runs.size();
+    if (k == 1) return std::copy(runs[0].first, runs[0].second, out);
+    LoserTree<typename std::iterator_traits<RandomIt>::value_type, Compare> tree(k, comp); // Head keys are copies
+    for (std::size_t s = 0; s < k; ++s) {
+        if (runs[s].first != runs[s].second) tree.set_source(s, *runs[s].first);
+    }
+    tree.build();
+    while (!tree.empty()) {
+        SortedRun<RandomIt>& run = runs[tree.winner()];
+        *out++ = *run.first;
+        if (++run.first == run.second) tree.exhaust_winner();
+        else tree.replace_winner(*run.first);
+    }
+    return out;
+}
+
+} // namespace KwayMergeImpl
+
+// Split positions (one per run, offsets from each run's start) of the first rank elements of the merge
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline std::vector<std::ptrdiff_t> multiway_split(const std::vector<SortedRun<RandomIt>>& runs, std::ptrdiff_t rank, Compare comp = {}, Proj proj = {}) {
+    auto cmp = make_projected_compare(comp, proj);
+    std::size_t k = runs.size();
+    std::ptrdiff_t total = KwayMergeImpl::total_size(runs);
+    if (rank < 0 || rank > total) throw std::invalid_argument("multiway_split: rank out of range");
+    std::vector<std::ptrdiff_t> split(k);
+    if (rank == total) {
+        for (std::size_t i = 0; i < k; ++i) split[i] = runs[i].second - runs[i].first;
+        return split;
+    }
+
+    // The element of merged rank `rank` stays inside the windows [lo, hi) until it is the pivot
+    std::vector<std::ptrdiff_t> lo(k, 0), hi(k);
+    for (std::size_t i = 0; i < k; ++i) hi[i] = runs[i].second - runs[i].first;
+    struct Median { std::size_t run; std::ptrdiff_t pos; std::ptrdiff_t weight; };
+    std::vector<Median> medians;
+    std::vector<std::ptrdiff_t> before(k);
+    for (;;) {
+        medians.clear();
+        std::ptrdiff_t active = 0;
+        for (std::size_t i = 0; i < k; ++i) {
+            if (lo[i] < hi[i]) {
+                medians.push_back({i, lo[i] + (hi[i] - lo[i]) / 2, hi[i] - lo[i]});
+                active += hi[i] - lo[i];
+            }
+        }
+        std::sort(medians.begin(), medians.end(), [&](const Median& a, const Median& b) {
+            if (cmp(runs[a.run].first[a.pos], runs[b.run].first[b.pos])) return true;
+            if (cmp(runs[b.run].first[b.pos], runs[a.run].first[a.pos])) return false;
+            return a.run < b.run;
+        });
+        std::size_t m = 0;
+        for (std::ptrdiff_t weight = medians[0].weight; 2 * weight < active; weight += medians[++m].weight);
+        std::size_t pivot_run = medians[m].run;
+        std::ptrdiff_t pivot_pos = medians[m].pos;
+
+        std::ptrdiff_t pivot_rank = 0;
+        for (std::size_t j = 0; j < k; ++j) {
+            before[j] = KwayMergeImpl::position_before(runs[j], j, pivot_run, runs[pivot_run].first + pivot_pos, pivot_pos, cmp);
+            pivot_rank += before[j];
+        }
+        if (pivot_rank == rank) return before;
+        for (std::size_t j = 0; j < k; ++j) {
+            if (pivot_rank < rank) lo[j] = std::max(lo[j], before[j] + (j == pivot_run ? 1 : 0));
+            else hi[j] = std::min(hi[j], before[j]);
+        }
+    }
+}
+
+// Merge the sorted runs into out (copies); returns the end of the output
+template<typename RandomIt, typename OutIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline OutIt kway_merge(const std::vector<SortedRun<RandomIt>>& runs, OutIt out, Compare comp = {}, Proj proj = {}) {
+    KwayMergeImpl::total_size(runs);
+    if (runs.empty()) return out;
+    auto cmp = make_projected_compare(comp, proj);
+    return KwayMergeImpl::merge_runs(runs, out, cmp);
+}
+inline std::vector<int> kway_merge(const std::vector<std::vector<int>>& runs) {
+    std::vector<SortedRun<std::vector<int>::const_iterator>> ranges;
+    std::size_t total = 0;
+    for (const auto& run : runs) { ranges.push_back({run.begin(), run.end()}); total += run.size(); }
+    std::vector<int> out(total);
+    kway_merge(ranges, out.begin());
+    return out;
+}
+
+// kway_merge with the output split into one independent range per pool thread
+template<typename RandomIt, typename OutIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline OutIt parallel_kway_merge(const std::vector<SortedRun<RandomIt>>& runs, OutIt out, Compare comp = {}, Proj proj = {}, TaskPool& pool = default_task_pool()) {
+    std::ptrdiff_t total = KwayMergeImpl::total_size(runs);
+    std::ptrdiff_t chunks = std::max<std::ptrdiff_t>(1, std::min<std::ptrdiff_t>(pool.thread_count(), total / sort_tuning().parallel_merge_sort_threshold));
+    if (runs.empty()) return out;
+    if (chunks == 1) return kway_merge(runs, out, comp, proj);
+    auto cmp = make_projected_compare(comp, proj);
+
+    std::vector<std::vector<std::ptrdiff_t>> splits(chunks + 1);
+    TaskGroup group(pool);
+    for (std::ptrdiff_t c = 0; c <= chunks; ++c) {
+        group.run([&, c]() { splits[c] = multiway_split(runs, total * c / chunks, cmp); });
+    }
+    group.wait();
+    for (std::ptrdiff_t c = 0; c < chunks; ++c) {
+        group.run([&, c]() {
+            std::vector<SortedRun<RandomIt>> part;
+            for (std::size_t i = 0; i < runs.size(); ++i) {
+                if (splits[c][i] < splits[c + 1][i]) part.push_back({runs[i].first + splits[c][i], runs[i].first + splits[c + 1][i]});
+            }
+            auto local = cmp;
+            if (!part.empty()) KwayMergeImpl::merge_runs(std::move(part), out + total * c / chunks, local);
+        });
+    }
+    group.wait();
+    return out + total;
+}
+inline std::vector<int> parallel_kway_merge(const std::vector<std::vector<int>>& runs, TaskPool& pool = default_task_pool()) {
+    std::vector<SortedRun<std::vector<int>::const_iterator>> ranges;
+    std::size_t total = 0;
+    for (const auto& run : runs) { ranges.push_back({run.begin(), run.end()}); total += run.size(); }
+    std::vector<int> out(total);
+    parallel_kway_merge(ranges, out.begin(), std::less<>(), identity_projection(), pool);
+    return out;
+}
+
+
+#endif
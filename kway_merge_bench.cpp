@@ -0,0 +1,73 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdlib>   // std::strtoll
+#include <iomanip>   //  std::setw (formatting output)
+
+#include "sorting.h"          // mergeSort
+#include "advanced_sorting.h" // tim_sort
+#include "kway_merge.h"       // kway_merge, parallel_kway_merge
+#include "benchmark_timing.h" // benchmark_average_ms, print_benchmark_cell
+
+// Benchmark: combining K presorted shards of random ints (total size fixed) by K-way merge
+// through the loser tree, by the parallel multiway-split merge, and by concatenating and
+// sorting again with mergeSort and tim_sort (which at least finds the K runs). Every output
+// is checked against the sorted input.
+// Usage: kway_merge_bench [total size]   (default 4M)
+
+// Constants
+const std::size_t DEFAULT_SIZE = 4'000'000;
+const int NUM_RUNS = 3;
+const std::size_t MAX_SHARDS = 1024;
+
+
+std::vector<SortedRun<std::vector<int>::const_iterator>> as_runs(const std::vector<std::vector<int>>& shards) {
+    std::vector<SortedRun<std::vector<int>::const_iterator>> runs;
+    for (const auto& shard : shards) runs.push_back({shard.begin(), shard.end()});
+    return runs;
+}
+
+void concatenate(const std::vector<std::vector<int>>& shards, std::vector<int>& out) {
+    auto it = out.begin();
+    for (const auto& shard : shards) it = std::copy(shard.begin(), shard.end(), it);
+}
+
+
+int main(int argc, char* argv[]) {
+    std::size_t size = argc > 1 ? static_cast<std::size_t>(std::strtoll(argv[1], nullptr, 10)) : DEFAULT_SIZE;
+    std::mt19937 rng(42);
+    std::vector<int> data(size);
+    for (auto& x : data) x = static_cast<int>(rng());
+    std::vector<int> expected = data;
+    std::sort(expected.begin(), expected.end());
+
+    std::cout << "Merging K sorted shards, " << size << " ints in total (avg ms over " << NUM_RUNS << " runs, "
+              << default_task_pool().thread_count() << " pool thread(s))\n\n";
+    std::cout << std::setw(6) << "K" << std::setw(14) << "kway_merge" << std::setw(14) << "parallel" << std::setw(14) << "cat+mergeSort"
+              << std::setw(14) << "cat+tim_sort" << "\n";
+    std::cout << std::fixed << std::setprecision(3);
+    for (std::size_t k = 2; k <= MAX_SHARDS; k *= 2) {
+        std::vector<std::vector<int>> shards(k);
+        for (std::size_t i = 0; i < size; ++i) shards[rng() % k].push_back(data[i]); // Uneven shard sizes
+        for (auto& shard : shards) std::sort(shard.begin(), shard.end());
+
+        // Each run merges into a fresh output array, allocated outside the timed region
+        auto merge_time = [&shards, &expected](auto combine) {
+            return benchmark_average_ms(NUM_RUNS, [&expected]() { return std::vector<int>(expected.size()); },
+                                        [&shards, combine](std::vector<int>& out) { combine(shards, out); },
+                                        [&expected](const std::vector<int>& out) { return out == expected; });
+        };
+        std::cout << std::setw(6) << k;
+        print_benchmark_cell(merge_time([](const std::vector<std::vector<int>>& s, std::vector<int>& out) {
+            kway_merge(as_runs(s), out.begin()); }), 14);
+        print_benchmark_cell(merge_time([](const std::vector<std::vector<int>>& s, std::vector<int>& out) {
+            parallel_kway_merge(as_runs(s), out.begin()); }), 14);
+        print_benchmark_cell(merge_time([](const std::vector<std::vector<int>>& s, std::vector<int>& out) {
+            concatenate(s, out); mergeSort(out.begin(), out.end()); }), 14);
+        print_benchmark_cell(merge_time([](const std::vector<std::vector<int>>& s, std::vector<int>& out) {
+            concatenate(s, out); tim_sort(out.begin(), out.end()); }), 14);
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+#ifndef LOSER_TREE_H
+#define LOSER_TREE_H
+
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint32_t, std::uint64_t
+#include <cstring>     // std::memcpy
+#include <functional>  // std::less
+#include <type_traits> // std::is_trivially_copyable
+#include <utility>     // std::move, std::swap
+#include <vector>
+
+
+// LOSER TREE (tournament tree for K-way merging)
+//
+// Holds the current head key of each of K sources. Every internal node remembers the loser
+// of the match played there and node 0 the overall winner, so replacing the winner's key
+// replays only the matches on its leaf-to-root path: ceil(log2 K) comparisons per element,
+// against roughly 2 log2 K for a binary heap. Ties go to the lower source index, which makes
+// a merge of sources given in input order stable. Exhausted sources lose every match.
+//
+// Nodes hold the loser's key itself, not its source index, so a replay reads only the nodes
+// on its path. Every match is one comparison, with the entry from the higher source on the
+// left so that a tie goes to the lower one. For keys of up to 8 trivially copyable bytes the
+// operands are picked and the result applied with selects rather than branches (the outcome
+// of a match between random keys is a coin flip). At most 2^31 sources.
+template<typename T, typename Compare = std::less<>>
+class LoserTree {
+public:
+    explicit LoserTree(std::size_t k, Compare comp = {})
+        : k_(k), comp_(comp), tree_(k == 0 ? 1 : k), leaves_(k) {
+        for (std::size_t i = 0; i < k; ++i) leaves_[i].tag = static_cast<std::uint32_t>(2 * i + 1);
+    }
+
+    // Set a source's first key (or mark it empty) before build()
+    void set_source(std::size_t source, T key) {
+        leaves_[source].key = std::move(key);
+        leaves_[source].tag = static_cast<std::uint32_t>(2 * source);
+    }
+    void set_exhausted(std::size_t source) { leaves_[source].tag = static_cast<std::uint32_t>(2 * source + 1); }
+
+    // Play the whole tournament once all sources are set
+    void build() {
+        if (k_ == 0) return;
+        std::vector<std::size_t> winners(2 * k_);
+        std::vector<std::size_t> losers(k_, 0);
+        for (std::size_t i = 0; i < k_; ++i) winners[k_ + i] = i;
+        for (std::size_t node = k_ - 1; node >= 1; --node) {
+            std::size_t a = winners[2 * node], b = winners[2 * node + 1];
+            bool a_wins = beats(leaves_[a], leaves_[b]);
+            winners[node] = a_wins ? a : b;
+            losers[node] = a_wins ? b : a;
+        }
+        losers[0] = (k_ == 1) ? 0 : winners[1];
+        for (std::size_t node = 0; node < k_; ++node) tree_[node] = std::move(leaves_[losers[node]]); // Each leaf exactly once
+    }
+
+    bool empty() const { return k_ == 0 || (tree_[0].tag & 1); }
+    std::size_t winner() const { return tree_[0].tag / 2; }
+    const T& winner_key() const { return tree_[0].key; }
+    std::size_t size() const { return k_; }
+
+    // The winner's source advanced to its next key
+    void replace_winner(T key) {
+        tree_[0].key = std::move(key);
+        replay();
+    }
+
+    // The winner's source ran dry
+    void exhaust_winner() {
+        tree_[0].tag |= 1;
+        replay();
+    }
+
+private:
+    static constexpr bool small_key = std::is_trivially_copyable<T>::value && sizeof(T) <= 8;
+
+    struct Entry {
+        T key{};
+        std::uint32_t tag = 1; // 2 * source + exhausted: an int key makes an 8-byte node
+    };
+
+    // cond ? x : y on the key's bytes through a mask; a ternary on the keys themselves is
+    // compiled to a branch, which mispredicts half the time here
+    static T select(bool cond, const T& x, const T& y) {
+        std::uint64_t bx = 0, by = 0;
+        std::memcpy(&bx, &x, sizeof(T));
+        std::memcpy(&by, &y, sizeof(T));
+        std::uint64_t mask = 0 - static_cast<std::uint64_t>(cond);
+        std::uint64_t bits = (bx & mask) | (by & ~mask);
+        T out;
+        std::memcpy(&out, &bits, sizeof(T));
+        return out;
+    }
+
+    // Does a come out before b? On equal keys the lower source index wins. An exhausted entry
+    // keeps its last (or default) key, which is compared but ignored.
+    bool beats(const Entry& a, const Entry& b) {
+        bool wins;
+        if constexpr (small_key) { // The same single comparison, operands picked without a branch
+            bool lower = a.tag < b.tag;
+            wins = comp_(select(lower, b.key, a.key), select(lower, a.key, b.key)) != lower;
+        } else {
+            wins = a.tag < b.tag ? !comp_(b.key, a.key) : comp_(a.key, b.key);
+        }
+        return ((a.tag & 1) == 0) & (((b.tag & 1) != 0) | wins);
+    }
+
+    // Replay the matches from the winner's leaf up with tree_[0] as the new contender
+    void replay() {
+        Entry current = std::move(tree_[0]);
+        for (std::size_t node = (k_ + current.tag / 2) / 2; node >= 1; node /= 2) {
+            if constexpr (small_key) { // Both updates as selects: no branch on the match outcome
+                Entry other = tree_[node];
+                bool other_wins = beats(other, current);
+                std::uint32_t mask = 0u - static_cast<std::uint32_t>(other_wins);
+                tree_[node].key = select(other_wins, current.key, other.key);
+                tree_[node].tag = (current.tag & mask) | (other.tag & ~mask);
+                current.key = select(other_wins, other.key, current.key);
+                current.tag = (other.tag & mask) | (current.tag & ~mask);
+            } else {
+                if (beats(tree_[node], current)) std::swap(tree_[node], current);
+            }
+        }
+        tree_[0] = std::move(current);
+    }
+
+    std::size_t k_;
+    Compare comp_;
+    std::vector<Entry> tree_;   // tree_[0]: winner, tree_[1..k-1]: loser of each match
+    std::vector<Entry> leaves_; // Initial keys, consumed by build()
+};
+
+
+#endif
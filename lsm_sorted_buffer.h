@@ -0,0 +1,228 @@
+#ifndef LSM_SORTED_BUFFER_H
+#define LSM_SORTED_BUFFER_H
+
+#include <algorithm>   // std::upper_bound, std::lower_bound
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <functional>  // std::less
+#include <stdexcept>   // std::invalid_argument
+#include <utility>     // std::move, std::pair
+#include <vector>
+
+#include "task_pool.h"        // TaskPool, default_task_pool
+#include "sorting.h"          // moveMerge, parallelMerge
+#include "advanced_sorting.h" // tim_sort
+#include "loser_tree.h"       // LoserTree (reads across levels)
+
+
+// LSM SORTED BUFFER (incremental sorted container)
+//
+// GappedSortedBuffer keeps one sorted array and shifts elements on every insert; this keeps
+// several. Inserts go into a small sorted batch (binary search plus a shift of at most
+// batch_size elements). A full batch is flushed into level 0; a level that would exceed its
+// capacity, batch_size * growth_factor^(i + 1), is merged together with the incoming run into
+// the next level instead (leveling, as in an LSM tree). Every level is a single sorted vector,
+// deeper levels hold older elements, and each element is moved O(growth_factor) times per level
+// it passes, so inserts cost O(growth_factor * log n) amortized. Merges use moveMerge, split
+// across the TaskPool with parallelMerge once they exceed parallel_merge_sort_threshold.
+//
+// Queries binary-search every level and the batch: count_less, lower_bound and contains cost
+// O(levels * log n); range queries and materialize merge the level slices through a LoserTree.
+// compact() merges everything into one level on demand, after which sorted() is the whole
+// content with no copy. Equal elements keep insertion order. Not thread-safe.
+
+const std::size_t LSM_BATCH_SIZE = 256;  // Sorted insert batch, flushed to level 0 when full
+const std::size_t LSM_GROWTH_FACTOR = 8; // Capacity ratio between consecutive levels
+
+template<typename T, typename Compare = std::less<>>
+class LsmSortedBuffer {
+public:
+    explicit LsmSortedBuffer(std::size_t batch_size = LSM_BATCH_SIZE, std::size_t growth_factor = LSM_GROWTH_FACTOR,
+                             Compare comp = {}, TaskPool& pool = default_task_pool())
+        : batch_size_(batch_size), growth_factor_(growth_factor), comp_(comp), pool_(&pool) {
+        if (batch_size == 0) throw std::invalid_argument("LsmSortedBuffer: batch_size must be > 0");
+        if (growth_factor < 2) throw std::invalid_argument("LsmSortedBuffer: growth_factor must be >= 2");
+        batch_.reserve(batch_size);
+    }
+
+    void insert(T value) {
+        batch_.insert(std::upper_bound(batch_.begin(), batch_.end(), value, comp_), std::move(value));
+        ++count_;
+        if (batch_.size() >= batch_size_) flush();
+    }
+
+    // Bulk insert: the values are sorted as one run (tim_sort, stable) and pushed into the levels
+    template<typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        std::vector<T> run(first, last);
+        if (run.empty()) return;
+        flush(); // Older elements first, so equal keys keep insertion order
+        tim_sort(run.begin(), run.end(), comp_);
+        count_ += run.size();
+        push_run(std::move(run));
+    }
+
+    // Move the batch into the levels now instead of when it fills up
+    void flush() {
+        if (batch_.empty()) return;
+        std::vector<T> run;
+        run.swap(batch_);
+        batch_.reserve(batch_size_);
+        push_run(std::move(run));
+    }
+
+    // Merge everything into a single sorted level; the reference stays valid until the next insert
+    const std::vector<T>& compact() {
+        flush();
+        std::size_t deepest = levels_.size();
+        while (deepest > 0 && levels_[deepest - 1].empty()) --deepest;
+        if (deepest == 0) return batch_; // Empty
+        std::vector<T> all;
+        for (std::size_t i = 0; i < deepest; ++i) { // Newest (shallowest) first, merged in as the newer side
+            if (levels_[i].empty()) continue;
+            all = all.empty() ? std::move(levels_[i]) : merge(std::move(levels_[i]), std::move(all));
+            levels_[i].clear();
+        }
+        levels_[deepest - 1] = std::move(all);
+        return levels_[deepest - 1];
+    }
+    const std::vector<T>& sorted() { return compact(); }
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    std::size_t level_count() const { return levels_.size(); }
+
+    void clear() {
+        batch_.clear();
+        levels_.clear();
+        count_ = 0;
+    }
+
+    // Elements less than value (its rank)
+    std::size_t count_less(const T& value) const {
+        std::size_t rank = 0;
+        for (const auto& slice : slices()) rank += std::lower_bound(slice.first, slice.second, value, comp_) - slice.first;
+        return rank;
+    }
+
+    // Smallest element not less than value, nullptr if there is none
+    const T* lower_bound(const T& value) const {
+        const T* best = nullptr;
+        for (const auto& slice : slices()) {
+            const T* it = std::lower_bound(slice.first, slice.second, value, comp_);
+            if (it != slice.second && (!best || comp_(*it, *best))) best = it;
+        }
+        return best;
+    }
+
+    bool contains(const T& value) const {
+        const T* it = lower_bound(value);
+        return it && !comp_(value, *it);
+    }
+
+    // Visit the elements in [lo, hi) in sorted order
+    template<typename Func>
+    void for_each_in_range(const T& lo, const T& hi, Func func) const {
+        std::vector<std::pair<const T*, const T*>> ranges;
+        for (const auto& slice : slices()) {
+            const T* begin = std::lower_bound(slice.first, slice.second, lo, comp_);
+            const T* end = std::lower_bound(begin, slice.second, hi, comp_);
+            ranges.push_back({begin, end});
+        }
+        merge_slices(std::move(ranges), func);
+    }
+
+    std::vector<T> range(const T& lo, const T& hi) const {
+        std::vector<T> out;
+        for_each_in_range(lo, hi, [&out](const T& value) { out.push_back(value); });
+        return out;
+    }
+
+    // Visit every element in sorted order
+    template<typename Func>
+    void for_each(Func func) const { merge_slices(slices(), func); }
+
+    // Fully sorted copy of the content; the buffer itself is not changed
+    std::vector<T> materialize() const {
+        std::vector<T> out;
+        out.reserve(count_);
+        for_each([&out](const T& value) { out.push_back(value); });
+        return out;
+    }
+
+private:
+    std::size_t capacity(std::size_t level) const {
+        std::size_t cap = batch_size_ * growth_factor_;
+        for (std::size_t i = 0; i < level; ++i) cap *= growth_factor_;
+        return cap;
+    }
+
+    // older and newer are sorted; ties keep older first
+    std::vector<T> merge(std::vector<T>&& older, std::vector<T>&& newer) {
+        std::vector<T> out(older.size() + newer.size());
+        std::ptrdiff_t total = static_cast<std::ptrdiff_t>(out.size());
+        if (total > sort_tuning().parallel_merge_sort_threshold && pool_->thread_count() > 1) {
+            parallelMerge(older.begin(), static_cast<std::ptrdiff_t>(older.size()), newer.begin(), static_cast<std::ptrdiff_t>(newer.size()),
+                          out.begin(), comp_, *pool_);
+        } else {
+            moveMerge(older.begin(), older.end(), newer.begin(), newer.end(), out.begin(), comp_);
+        }
+        return out;
+    }
+
+    // Cascade a sorted run down: it lands in the first level that has room for it together
+    // with what is already there; every fuller level on the way is merged into the run
+    void push_run(std::vector<T>&& run) {
+        for (std::size_t level = 0;; ++level) {
+            if (level == levels_.size()) levels_.emplace_back();
+            std::vector<T>& target = levels_[level];
+            if (!target.empty()) {
+                run = merge(std::move(target), std::move(run));
+                target.clear();
+            }
+            if (run.size() <= capacity(level)) {
+                target = std::move(run);
+                return;
+            }
+        }
+    }
+
+    // Oldest first (deepest level to the batch), as LoserTree breaks ties by source index
+    std::vector<std::pair<const T*, const T*>> slices() const {
+        std::vector<std::pair<const T*, const T*>> out;
+        for (std::size_t i = levels_.size(); i-- > 0;) {
+            if (!levels_[i].empty()) out.push_back({levels_[i].data(), levels_[i].data() + levels_[i].size()});
+        }
+        if (!batch_.empty()) out.push_back({batch_.data(), batch_.data() + batch_.size()});
+        return out;
+    }
+
+    template<typename Func>
+    void merge_slices(std::vector<std::pair<const T*, const T*>> ranges, Func& func) const {
+        if (ranges.size() == 1) {
+            for (const T* it = ranges[0].first; it != ranges[0].second; ++it) func(*it);
+            return;
+        }
+        LoserTree<T, Compare> tree(ranges.size(), comp_);
+        for (std::size_t s = 0; s < ranges.size(); ++s) {
+            if (ranges[s].first != ranges[s].second) tree.set_source(s, *ranges[s].first);
+        }
+        tree.build();
+        while (!tree.empty()) {
+            auto& cursor = ranges[tree.winner()];
+            func(*cursor.first);
+            if (++cursor.first == cursor.second) tree.exhaust_winner();
+            else tree.replace_winner(*cursor.first);
+        }
+    }
+
+    std::size_t batch_size_;
+    std::size_t growth_factor_;
+    Compare comp_;
+    TaskPool* pool_;
+    std::vector<T> batch_;               // Newest elements, sorted
+    std::vector<std::vector<T>> levels_; // levels_[i]: one sorted run of at most capacity(i) elements
+    std::size_t count_ = 0;
+};
+
+
+#endif
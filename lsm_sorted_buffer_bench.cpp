@@ -0,0 +1,179 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>   // std::strtoll
+#include <iomanip>   //  std::setw, std::left (formatting output)
+
+#include "lsm_sorted_buffer.h" // LsmSortedBuffer
+#include "advanced_sorting.h"  // GappedSortedBuffer (the one-array incremental buffer)
+#include "datasets.h"          // generate_dataset (the timed inserts)
+#include "benchmark_timing.h"  // benchmark_average_ms, print_benchmark_row
+
+// Benchmark and check for LsmSortedBuffer. First a fuzz check against a reference kept as a
+// plain vector in insertion order and stable-sorted by key: random single and bulk inserts,
+// flushes, compactions and clears on buffers with small batches and growth factors (so runs
+// cascade through many levels, on a one-thread and a four-thread pool), with the content,
+// stability among equal keys and every query (count_less, lower_bound, contains, range,
+// for_each, size) compared after each step, and the same queries on empty buffers. Then
+// inserts of random ints, timed against GappedSortedBuffer and a vector sorted at the end,
+// plus materialize and compact. Exits with status 1 if the check fails.
+// Usage: lsm_sorted_buffer_bench [inserts]   (default 2M)
+
+// Constants
+const std::size_t DEFAULT_INSERTS = 2000000;
+const int NUM_RUNS = 3;
+const int FUZZ_ROUNDS = 300;
+const int FUZZ_STEPS = 40;
+const int FUZZ_PROBES = 20;
+
+
+// Keys with few distinct values, tagged with their insertion order to check stability
+struct Record {
+    int key;
+    int seq;
+    bool operator==(const Record& other) const { return key == other.key && seq == other.seq; }
+};
+
+struct RecordLess {
+    bool operator()(const Record& a, const Record& b) const { return a.key < b.key; }
+};
+
+typedef LsmSortedBuffer<Record, RecordLess> RecordBuffer;
+
+// Compare every query of buffer with the reference (insertion order); false and a message on the first mismatch
+bool check_against(RecordBuffer& buffer, const std::vector<Record>& inserted, int key_range, std::mt19937_64& rng) {
+    std::vector<Record> expected = inserted;
+    std::stable_sort(expected.begin(), expected.end(), RecordLess());
+    auto fail = [](const std::string& what) {
+        std::cerr << "!!! LsmSortedBuffer: " << what << " differs from the reference !!!" << std::endl;
+        return false;
+    };
+
+    if (buffer.size() != expected.size() || buffer.empty() != expected.empty()) return fail("size");
+    if (buffer.materialize() != expected) return fail("materialize (content or order of equal keys)");
+    std::vector<Record> visited;
+    buffer.for_each([&visited](const Record& r) { visited.push_back(r); });
+    if (visited != expected) return fail("for_each");
+
+    for (int p = 0; p < FUZZ_PROBES; ++p) {
+        Record probe{static_cast<int>(rng() % (key_range + 2)) - 1, -1};
+        auto first = std::lower_bound(expected.begin(), expected.end(), probe, RecordLess());
+        if (buffer.count_less(probe) != static_cast<std::size_t>(first - expected.begin())) return fail("count_less");
+        const Record* found = buffer.lower_bound(probe);
+        if ((found == nullptr) != (first == expected.end()) || (found && !(*found == *first))) return fail("lower_bound");
+        if (buffer.contains(probe) != (first != expected.end() && first->key == probe.key)) return fail("contains");
+
+        Record hi{probe.key + static_cast<int>(rng() % 4), -1};
+        auto last = std::lower_bound(expected.begin(), expected.end(), hi, RecordLess());
+        std::vector<Record> in_range(first, std::max(first, last));
+        if (buffer.range(probe, hi) != in_range) return fail("range");
+    }
+    return true;
+}
+
+bool check_empty(RecordBuffer& buffer) {
+    Record probe{0, -1};
+    bool ok = buffer.empty() && buffer.size() == 0 && buffer.materialize().empty() && buffer.count_less(probe) == 0
+           && buffer.lower_bound(probe) == nullptr && !buffer.contains(probe) && buffer.range(probe, Record{10, -1}).empty();
+    int visits = 0;
+    buffer.for_each([&visits](const Record&) { ++visits; });
+    ok = ok && visits == 0 && buffer.compact().empty();
+    if (!ok) std::cerr << "!!! LsmSortedBuffer: an empty buffer answered a query wrong !!!" << std::endl;
+    return ok;
+}
+
+bool fuzz_check() {
+    std::mt19937_64 rng(42);
+    TaskPool pool(4); // Parallel merges once a level merge exceeds parallel_merge_sort_threshold
+    for (int round = 0; round < FUZZ_ROUNDS; ++round) {
+        std::size_t batch_size = 1 + rng() % 48;
+        std::size_t growth_factor = 2 + rng() % 5;
+        int key_range = 1 + static_cast<int>(rng() % 200);
+        RecordBuffer buffer(batch_size, growth_factor, RecordLess(), round % 2 ? pool : default_task_pool());
+        if (!check_empty(buffer)) return false;
+
+        std::vector<Record> inserted;
+        int seq = 0;
+        for (int step = 0; step < FUZZ_STEPS; ++step) {
+            std::uint64_t op = rng() % 20;
+            if (op < 12) { // Single inserts
+                for (int i = static_cast<int>(rng() % 100); i > 0; --i) {
+                    Record r{static_cast<int>(rng() % key_range), seq++};
+                    buffer.insert(r);
+                    inserted.push_back(r);
+                }
+            } else if (op < 17) { // Bulk insert, sometimes large enough for a parallel merge
+                std::vector<Record> run(rng() % 8 == 0 ? 3000 + rng() % 3000 : rng() % 300);
+                for (auto& r : run) r = Record{static_cast<int>(rng() % key_range), seq++};
+                buffer.insert(run.begin(), run.end());
+                inserted.insert(inserted.end(), run.begin(), run.end());
+            } else if (op < 18) {
+                buffer.flush();
+            } else if (op < 19) {
+                buffer.compact();
+            } else {
+                buffer.clear();
+                inserted.clear();
+                if (!check_empty(buffer)) return false;
+            }
+            if (!check_against(buffer, inserted, key_range, rng)) {
+                std::cerr << "    (round " << round << ", step " << step << ", batch " << batch_size
+                          << ", growth " << growth_factor << ", " << inserted.size() << " elements)" << std::endl;
+                return false;
+            }
+        }
+        std::vector<Record> expected = inserted;
+        std::stable_sort(expected.begin(), expected.end(), RecordLess());
+        if (buffer.sorted() != expected) {
+            std::cerr << "!!! LsmSortedBuffer: sorted() after compaction differs from the reference !!!" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+int main(int argc, char* argv[]) {
+    std::size_t inserts = argc > 1 ? static_cast<std::size_t>(std::strtoll(argv[1], nullptr, 10)) : DEFAULT_INSERTS;
+
+    bool ok = fuzz_check();
+    std::cout << "Fuzz check against a stable-sorted reference (" << FUZZ_ROUNDS << " rounds): " << (ok ? "passed" : "FAILED") << std::endl;
+    if (!ok) return 1;
+
+    std::vector<int> keys = generate_dataset<int>("random", inserts);
+    std::vector<int> expected = keys;
+    std::sort(expected.begin(), expected.end());
+
+    std::cout << "\n=== " << inserts << " random int inserts (avg over " << NUM_RUNS << " runs) ===\n"
+              << std::fixed << std::setprecision(2);
+    std::cout << "  " << std::left << std::setw(34) << "variant" << std::right << std::setw(12) << "ms" << std::setw(12) << "Mops/s" << "\n";
+    auto make_lsm = []() { return LsmSortedBuffer<int>(); };
+    auto unchecked = [](const auto&) { return true; }; // The content is checked once, below
+    print_benchmark_row("LsmSortedBuffer::insert", 34, benchmark_average_ms(NUM_RUNS, make_lsm, [&keys](LsmSortedBuffer<int>& b) {
+        for (int k : keys) b.insert(k); }, unchecked), inserts, 12);
+    print_benchmark_row("LsmSortedBuffer bulk insert", 34, benchmark_average_ms(NUM_RUNS, make_lsm, [&keys](LsmSortedBuffer<int>& b) {
+        b.insert(keys.begin(), keys.end()); }, unchecked), inserts, 12);
+    print_benchmark_row("GappedSortedBuffer::insert", 34, benchmark_average_ms(NUM_RUNS, []() { return GappedSortedBuffer<int>(); }, [&keys](GappedSortedBuffer<int>& b) {
+        for (int k : keys) b.insert(k); }, unchecked), inserts, 12);
+    print_benchmark_row("vector push_back + std::sort", 34, benchmark_average_ms(NUM_RUNS, []() { return std::vector<int>(); }, [&keys](std::vector<int>& v) {
+        for (int k : keys) v.push_back(k);
+        std::sort(v.begin(), v.end()); }, unchecked), inserts, 12);
+
+    LsmSortedBuffer<int> filled;
+    for (int k : keys) filled.insert(k);
+    std::cout << "  (" << filled.level_count() << " levels after the inserts)\n";
+    std::vector<int> materialized;
+    print_benchmark_row("materialize", 34, benchmark_average_ms(NUM_RUNS, []() { return 0; }, [&](int) { materialized = filled.materialize(); }, unchecked), inserts, 12);
+    auto start = std::chrono::high_resolution_clock::now();
+    bool compact_ok = filled.compact() == expected;
+    double compact_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    print_benchmark_row("compact (once)", 34, compact_ms, inserts, 12);
+    if (materialized != expected || !compact_ok) {
+        std::cerr << "!!! LsmSortedBuffer: timed output differs from std::sort !!!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
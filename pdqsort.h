@@ -0,0 +1,405 @@
+#ifndef PDQSORT_H
+#define PDQSORT_H
+
+#include <algorithm>   // std::iter_swap, std::min, std::max
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <cstdint>     // std::uintptr_t
+#include <functional>  // std::less, std::greater
+#include <iterator>    // std::iterator_traits
+#include <type_traits> // std::is_arithmetic
+#include <utility>     // std::pair, std::move
+
+#include "simd_sort.h"     // sorting-network leaves for int32/int64/float keys
+#include "sorting_network.h" // fixed_sort_leaf (scalar network leaves for other arithmetic keys)
+#include "sort_counters.h" // SORT_COUNT_RECURSION (no-op unless SORT_COUNTERS)
+#include "heap_engine.h"   // heap_sort_range (heapsort fallback)
+
+
+// PATTERN-DEFEATING QUICKSORT ENGINE (shared by quickSort and introsort)
+//
+// After Orson Peters' pdqsort, with BlockQuicksort-style partitioning (Edelkamp & Weiss):
+//  - pivot is the median of three, or a ninther (median of three medians) for large ranges;
+//  - for arithmetic keys under std::less/std::greater, partitioning fills offset buffers of
+//    misplaced elements without branching on comparisons, then swaps them in bulk;
+//  - a range that was already partitioned and then needs only a few insertion moves on
+//    both sides is finished right away (sorted / nearly sorted input is O(n));
+//  - when the pivot equals the element just before the range (the previous pivot), every
+//    element equal to it is split off in one pass, so few-distinct-keys input is O(n log k);
+//  - a highly unbalanced partition swaps a few elements around to break adversarial
+//    patterns, and after log2(n) such partitions the range falls back to heapsort,
+//    so the worst case is O(n log n).
+// Small ranges go to the SIMD networks (int32 / int64 / float under std::less), else to the
+// scalar fixed-size networks (other arithmetic keys under std::less / std::greater), else to
+// insertion sort.
+
+const std::ptrdiff_t PDQSORT_INSERTION_THRESHOLD = 24;
+const std::ptrdiff_t PDQSORT_MIN_INSERTION_THRESHOLD = 4; // break_patterns swaps at distance side / 4 and needs that >= 1
+const std::ptrdiff_t PDQSORT_NINTHER_THRESHOLD = 128;
+const std::ptrdiff_t PDQSORT_PARTIAL_INSERTION_LIMIT = 8;
+const std::size_t PDQSORT_BLOCK_SIZE = 64;
+const std::size_t PDQSORT_CACHELINE_SIZE = 64;
+
+namespace PdqsortImpl {
+
+template<typename T> struct is_default_compare : std::false_type {};
+template<typename T> struct is_default_compare<std::less<T>> : std::true_type {};
+template<typename T> struct is_default_compare<std::greater<T>> : std::true_type {};
+
+// Branchless partitioning only pays off for cheap comparisons with no side effects
+template<typename RandomIt, typename Compare>
+struct use_branchless : std::integral_constant<bool,
+    is_default_compare<Compare>::value &&
+    std::is_arithmetic<typename std::iterator_traits<RandomIt>::value_type>::value> {};
+
+inline int log2(std::ptrdiff_t n) {
+    int log = 0;
+    while (n >>= 1) ++log;
+    return log;
+}
+
+template<typename RandomIt, typename Compare>
+inline void insertion_sort(RandomIt begin, RandomIt end, Compare& comp) {
+    if (begin == end) return;
+    for (RandomIt cur = begin + 1; cur != end; ++cur) {
+        RandomIt sift = cur;
+        RandomIt sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            auto tmp = std::move(*sift);
+            do { *sift-- = std::move(*sift_1); } while (sift != begin && comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// Requires *(begin - 1) to be no greater than any element of [begin, end)
+template<typename RandomIt, typename Compare>
+inline void unguarded_insertion_sort(RandomIt begin, RandomIt end, Compare& comp) {
+    if (begin == end) return;
+    for (RandomIt cur = begin + 1; cur != end; ++cur) {
+        RandomIt sift = cur;
+        RandomIt sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            auto tmp = std::move(*sift);
+            do { *sift-- = std::move(*sift_1); } while (comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// Insertion sort that gives up (returning false) after PDQSORT_PARTIAL_INSERTION_LIMIT moves
+template<typename RandomIt, typename Compare>
+inline bool partial_insertion_sort(RandomIt begin, RandomIt end, Compare& comp) {
+    if (begin == end) return true;
+    std::ptrdiff_t limit = 0;
+    for (RandomIt cur = begin + 1; cur != end; ++cur) {
+        RandomIt sift = cur;
+        RandomIt sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            auto tmp = std::move(*sift);
+            do { *sift-- = std::move(*sift_1); } while (sift != begin && comp(tmp, *--sift_1));
+            *sift = std::move(tmp);
+            limit += cur - sift;
+        }
+        if (limit > PDQSORT_PARTIAL_INSERTION_LIMIT) return false;
+    }
+    return true;
+}
+
+template<typename RandomIt, typename Compare>
+inline void sort2(RandomIt a, RandomIt b, Compare& comp) {
+    if (comp(*b, *a)) std::iter_swap(a, b);
+}
+
+template<typename RandomIt, typename Compare>
+inline void sort3(RandomIt a, RandomIt b, RandomIt c, Compare& comp) {
+    sort2(a, b, comp);
+    sort2(b, c, comp);
+    sort2(a, b, comp);
+}
+
+// Move the chosen pivot to *begin. Also leaves an element >= pivot at end - 1,
+// which the unguarded scans in the partitions rely on. Requires end - begin >= 3.
+template<typename RandomIt, typename Compare>
+inline void choose_pivot(RandomIt begin, RandomIt end, Compare& comp) {
+    std::ptrdiff_t size = end - begin;
+    std::ptrdiff_t s2 = size / 2;
+    if (size > PDQSORT_NINTHER_THRESHOLD) {
+        sort3(begin, begin + s2, end - 1, comp);
+        sort3(begin + 1, begin + (s2 - 1), end - 2, comp);
+        sort3(begin + 2, begin + (s2 + 1), end - 3, comp);
+        sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp);
+        std::iter_swap(begin, begin + s2);
+    } else {
+        sort3(begin + s2, begin, end - 1, comp);
+    }
+}
+
+template<typename T>
+inline T* align_cacheline(T* p) {
+    std::uintptr_t ip = reinterpret_cast<std::uintptr_t>(p);
+    ip = (ip + PDQSORT_CACHELINE_SIZE - 1) & ~std::uintptr_t(PDQSORT_CACHELINE_SIZE - 1);
+    return reinterpret_cast<T*>(ip);
+}
+
+// Exchange num misplaced pairs: first + offsets_l[i] with last - offsets_r[i]. Unless both
+// blocks have the same count, a cyclic permutation is used (one move per element, not three).
+template<typename RandomIt>
+inline void swap_offsets(RandomIt first, RandomIt last, unsigned char* offsets_l, unsigned char* offsets_r,
+                         std::size_t num, bool use_swaps) {
+    if (use_swaps) {
+        for (std::size_t i = 0; i < num; ++i) std::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+    } else if (num > 0) {
+        RandomIt l = first + offsets_l[0];
+        RandomIt r = last - offsets_r[0];
+        auto tmp = std::move(*l);
+        *l = std::move(*r);
+        for (std::size_t i = 1; i < num; ++i) {
+            l = first + offsets_l[i]; *r = std::move(*l);
+            r = last - offsets_r[i]; *l = std::move(*r);
+        }
+        *r = std::move(tmp);
+    }
+}
+
+// Partition [begin, end) around the pivot at *begin: elements < pivot to the left, >= pivot to
+// the right. Returns the pivot's final position and whether the range was already partitioned.
+template<typename RandomIt, typename Compare>
+inline std::pair<RandomIt, bool> partition_right(RandomIt begin, RandomIt end, Compare& comp) {
+    auto pivot = std::move(*begin);
+    RandomIt first = begin;
+    RandomIt last = end;
+
+    // Guarded by the >= pivot element choose_pivot left at end - 1
+    while (comp(*++first, pivot));
+    // If nothing was < pivot, guard this scan; otherwise the element before first stops it
+    if (first - 1 == begin) while (first < last && !comp(*--last, pivot));
+    else                    while (!comp(*--last, pivot));
+
+    bool already_partitioned = first >= last;
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(*++first, pivot));
+        while (!comp(*--last, pivot));
+    }
+
+    RandomIt pivot_pos = first - 1;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return std::make_pair(pivot_pos, already_partitioned);
+}
+
+// Same contract as partition_right, but comparisons only feed offset counters, never branches
+template<typename RandomIt, typename Compare>
+inline std::pair<RandomIt, bool> partition_right_branchless(RandomIt begin, RandomIt end, Compare& comp) {
+    auto pivot = std::move(*begin);
+    RandomIt first = begin;
+    RandomIt last = end;
+
+    while (comp(*++first, pivot));
+    if (first - 1 == begin) while (first < last && !comp(*--last, pivot));
+    else                    while (!comp(*--last, pivot));
+
+    bool already_partitioned = first >= last;
+    if (!already_partitioned) {
+        std::iter_swap(first, last);
+        ++first;
+
+        unsigned char offsets_l_storage[PDQSORT_BLOCK_SIZE + PDQSORT_CACHELINE_SIZE];
+        unsigned char offsets_r_storage[PDQSORT_BLOCK_SIZE + PDQSORT_CACHELINE_SIZE];
+        unsigned char* offsets_l = align_cacheline(offsets_l_storage);
+        unsigned char* offsets_r = align_cacheline(offsets_r_storage);
+
+        RandomIt offsets_l_base = first;
+        RandomIt offsets_r_base = last;
+        std::size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+        while (first < last) {
+            // Split what is left between the blocks that are currently empty
+            std::size_t num_unknown = last - first;
+            std::size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+            std::size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+            // Record offsets of elements on the wrong side; the count only advances on a match
+            if (left_split >= PDQSORT_BLOCK_SIZE) {
+                for (std::size_t i = 0; i < PDQSORT_BLOCK_SIZE;) {
+                    offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                    offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                    offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                    offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                    offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                    offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                    offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                    offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                }
+            } else {
+                for (std::size_t i = 0; i < left_split;) {
+                    offsets_l[num_l] = static_cast<unsigned char>(i++); num_l += !comp(*first, pivot); ++first;
+                }
+            }
+
+            if (right_split >= PDQSORT_BLOCK_SIZE) {
+                for (std::size_t i = 0; i < PDQSORT_BLOCK_SIZE;) {
+                    offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                    offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                    offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                    offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                    offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                    offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                    offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                    offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                }
+            } else {
+                for (std::size_t i = 0; i < right_split;) {
+                    offsets_r[num_r] = static_cast<unsigned char>(++i); num_r += comp(*--last, pivot);
+                }
+            }
+
+            // Swap as many pairs as both blocks allow, then refill whichever block ran empty
+            std::size_t num = std::min(num_l, num_r);
+            swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r, num, num_l == num_r);
+            num_l -= num; num_r -= num;
+            start_l += num; start_r += num;
+            if (num_l == 0) { start_l = 0; offsets_l_base = first; }
+            if (num_r == 0) { start_r = 0; offsets_r_base = last; }
+        }
+
+        // Leftover misplaced elements of one block go to the boundary
+        if (num_l) {
+            offsets_l += start_l;
+            while (num_l--) std::iter_swap(offsets_l_base + offsets_l[num_l], --last);
+            first = last;
+        }
+        if (num_r) {
+            offsets_r += start_r;
+            while (num_r--) { std::iter_swap(offsets_r_base - offsets_r[num_r], first); ++first; }
+            last = first;
+        }
+    }
+
+    RandomIt pivot_pos = first - 1;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return std::make_pair(pivot_pos, already_partitioned);
+}
+
+// Partition around the pivot at *begin with elements equal to it on the left. Used when the
+// pivot equals the previous pivot, so the whole left side is the equal-key run and is done.
+template<typename RandomIt, typename Compare>
+inline RandomIt partition_left(RandomIt begin, RandomIt end, Compare& comp) {
+    auto pivot = std::move(*begin);
+    RandomIt first = begin;
+    RandomIt last = end;
+
+    while (comp(pivot, *--last));
+    if (last + 1 == end) while (first < last && !comp(pivot, *++first));
+    else                 while (!comp(pivot, *++first));
+
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(pivot, *--last));
+        while (!comp(pivot, *++first));
+    }
+
+    RandomIt pivot_pos = last;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return pivot_pos;
+}
+
+// Swap a few elements of each side of an unbalanced partition to break up patterns
+template<typename RandomIt>
+inline void break_patterns(RandomIt begin, RandomIt pivot_pos, RandomIt end, std::ptrdiff_t insertion_threshold) {
+    std::ptrdiff_t l_size = pivot_pos - begin;
+    std::ptrdiff_t r_size = end - (pivot_pos + 1);
+    if (l_size >= insertion_threshold) {
+        std::iter_swap(begin, begin + l_size / 4);
+        std::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+        if (l_size > PDQSORT_NINTHER_THRESHOLD) {
+            std::iter_swap(begin + 1, begin + (l_size / 4 + 1));
+            std::iter_swap(begin + 2, begin + (l_size / 4 + 2));
+            std::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+            std::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+        }
+    }
+    if (r_size >= insertion_threshold) {
+        std::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+        std::iter_swap(end - 1, end - r_size / 4);
+        if (r_size > PDQSORT_NINTHER_THRESHOLD) {
+            std::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+            std::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+            std::iter_swap(end - 2, end - (1 + r_size / 4));
+            std::iter_swap(end - 3, end - (2 + r_size / 4));
+        }
+    }
+}
+
+// Main loop. Sorts the right side of each partition iteratively and hands the left side to
+// sort_left(begin, end, bad_allowed, leftmost), so callers can recurse inline or fork it.
+// leftmost == false means *(begin - 1) is a previous pivot no greater than the whole range.
+template<typename RandomIt, typename Compare, typename SortLeft>
+inline void pdqsort_loop(RandomIt begin, RandomIt end, Compare& comp, int bad_allowed, bool leftmost,
+                         std::ptrdiff_t insertion_threshold, SortLeft&& sort_left) {
+    SORT_COUNT_RECURSION();
+    const std::ptrdiff_t simd_leaf = simd_sort_leaf_size<RandomIt, Compare>();
+    insertion_threshold = std::max(insertion_threshold, PDQSORT_MIN_INSERTION_THRESHOLD);
+    for (;;) {
+        std::ptrdiff_t size = end - begin;
+        if (size <= simd_leaf && simd_sort_leaf<RandomIt, Compare>(begin, end)) return;
+        if (size < insertion_threshold || size < 3) {
+            if constexpr (use_fixed_sort_leaf<RandomIt, Compare>::value) {
+                if (fixed_sort_leaf(begin, size, comp)) return;
+            }
+            if (leftmost) PdqsortImpl::insertion_sort(begin, end, comp);
+            else unguarded_insertion_sort(begin, end, comp);
+            return;
+        }
+
+        choose_pivot(begin, end, comp);
+
+        // Pivot equal to the previous pivot: split off the equal keys, they are in place
+        if (!leftmost && !comp(*(begin - 1), *begin)) {
+            begin = partition_left(begin, end, comp) + 1;
+            continue;
+        }
+
+        std::pair<RandomIt, bool> part = use_branchless<RandomIt, Compare>::value
+            ? partition_right_branchless(begin, end, comp)
+            : partition_right(begin, end, comp);
+        RandomIt pivot_pos = part.first;
+        bool already_partitioned = part.second;
+
+        std::ptrdiff_t l_size = pivot_pos - begin;
+        std::ptrdiff_t r_size = end - (pivot_pos + 1);
+        bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+        if (highly_unbalanced) {
+            if (--bad_allowed == 0) {
+                heap_sort_range(begin, end, comp); // Heapsort fallback (heap_engine.h)
+                return;
+            }
+            break_patterns(begin, pivot_pos, end, insertion_threshold);
+        } else if (already_partitioned && partial_insertion_sort(begin, pivot_pos, comp)
+                                       && partial_insertion_sort(pivot_pos + 1, end, comp)) {
+            return; // Nearly sorted already
+        }
+
+        sort_left(begin, pivot_pos, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+// Single-threaded pdqsort of [begin, end)
+template<typename RandomIt, typename Compare>
+inline void pdqsort_sequential(RandomIt begin, RandomIt end, Compare& comp, int bad_allowed, bool leftmost,
+                               std::ptrdiff_t insertion_threshold = PDQSORT_INSERTION_THRESHOLD) {
+    pdqsort_loop(begin, end, comp, bad_allowed, leftmost, insertion_threshold,
+        [&comp, insertion_threshold](RandomIt b, RandomIt e, int bad, bool lm) {
+            pdqsort_sequential(b, e, comp, bad, lm, insertion_threshold);
+        });
+}
+
+} // namespace PdqsortImpl
+
+
+#endif
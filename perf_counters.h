@@ -0,0 +1,167 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <array>
+#include <cerrno>
+#include <cstdint>   // std::uint64_t
+#include <cstring>   // std::strerror, std::memset
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h> // getrusage (page-fault fallback)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+// HARDWARE PERFORMANCE COUNTERS (Linux perf_event_open)
+//
+// Counts cycles, instructions, branch misses, L1D read misses, LLC misses and page faults
+// around a region of code. Each event is opened on its own rather than as a group, so one
+// event the PMU (or a VM) does not expose leaves the others usable. Counters are opened with
+// inherit set: threads created afterwards (e.g. the default TaskPool's workers, when the
+// counters are constructed before the pool's first use) are counted too. Kernel-side counting
+// is tried first and dropped when perf_event_paranoid forbids it. Multiplexed counters are
+// scaled by the time_enabled / time_running deltas of the measured region.
+//
+// Nothing here throws: unavailable events simply report valid = false, and page faults fall
+// back to getrusage() when the software event is refused. On other platforms every event is
+// unavailable.
+
+enum PerfEvent {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_PAGE_FAULTS,
+    PERF_EVENT_COUNT
+};
+
+inline const char* perf_event_name(int event) {
+    static const char* const names[PERF_EVENT_COUNT] = {
+        "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses", "page_faults"};
+    return names[event];
+}
+
+struct PerfReading {
+    std::array<double, PERF_EVENT_COUNT> values{};
+    std::array<bool, PERF_EVENT_COUNT> valid{};
+};
+
+class PerfCounters {
+public:
+    PerfCounters() {
+        fds_.fill(-1);
+#ifdef __linux__
+        const std::uint32_t types[PERF_EVENT_COUNT] = {
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+            PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE, PERF_TYPE_SOFTWARE};
+        const std::uint64_t configs[PERF_EVENT_COUNT] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES,
+            PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_SW_PAGE_FAULTS};
+        int first_errno = 0;
+        std::string missing;
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            fds_[e] = open_event(types[e], configs[e], false);
+            if (fds_[e] < 0) fds_[e] = open_event(types[e], configs[e], true); // User space only
+            if (fds_[e] >= 0) continue;
+            if (first_errno == 0) first_errno = errno;
+            missing += missing.empty() ? perf_event_name(e) : std::string(", ") + perf_event_name(e);
+        }
+        if (first_errno != 0) status_ = "unavailable: " + missing + " (" + std::strerror(first_errno) + ")";
+#else
+        status_ = "perf_event_open is Linux-only";
+#endif
+        if (fds_[PERF_PAGE_FAULTS] < 0) status_ += status_.empty() ? "page faults from getrusage" : "; page faults from getrusage";
+    }
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int fd : fds_) if (fd >= 0) close(fd);
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Any hardware event usable?
+    bool available() const {
+        for (int e = 0; e < PERF_PAGE_FAULTS; ++e) if (fds_[e] >= 0) return true;
+        return false;
+    }
+    bool available(PerfEvent event) const { return event == PERF_PAGE_FAULTS || fds_[event] >= 0; }
+
+    // Empty when every counter opened, otherwise which did not and why
+    const std::string& status() const { return status_; }
+
+    void start() {
+#ifdef __linux__
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            if (fds_[e] >= 0) read_raw(e, start_[e]);
+        }
+        rusage_faults_ = rusage_page_faults();
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) if (fds_[e] >= 0) ioctl(fds_[e], PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    PerfReading stop() {
+        PerfReading reading;
+#ifdef __linux__
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) if (fds_[e] >= 0) ioctl(fds_[e], PERF_EVENT_IOC_DISABLE, 0);
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            RawCount end;
+            if (fds_[e] < 0 || !read_raw(e, end)) continue;
+            std::uint64_t value = end[0] - start_[e][0];
+            std::uint64_t enabled = end[1] - start_[e][1], running = end[2] - start_[e][2];
+            reading.values[e] = running == 0 ? 0.0 : static_cast<double>(value) * (static_cast<double>(enabled) / static_cast<double>(running));
+            reading.valid[e] = true;
+        }
+        if (fds_[PERF_PAGE_FAULTS] < 0) {
+            reading.values[PERF_PAGE_FAULTS] = static_cast<double>(rusage_page_faults() - rusage_faults_);
+            reading.valid[PERF_PAGE_FAULTS] = true;
+        }
+#endif
+        return reading;
+    }
+
+private:
+#ifdef __linux__
+    static int open_event(std::uint32_t type, std::uint64_t config, bool user_only) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = user_only;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    using RawCount = std::array<std::uint64_t, 3>; // value, time_enabled, time_running
+
+    bool read_raw(int e, RawCount& count) const {
+        return read(fds_[e], count.data(), sizeof(count)) == static_cast<ssize_t>(sizeof(count));
+    }
+
+    static long rusage_page_faults() {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_minflt + usage.ru_majflt;
+    }
+
+    std::array<RawCount, PERF_EVENT_COUNT> start_{};
+    long rusage_faults_ = 0;
+#endif
+    std::array<int, PERF_EVENT_COUNT> fds_;
+    std::string status_;
+};
+
+
+#endif
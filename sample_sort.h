@@ -0,0 +1,480 @@
+#ifndef SAMPLE_SORT_H
+#define SAMPLE_SORT_H
+
+#include <algorithm>   // std::min, std::max, std::swap_ranges
+#include <atomic>
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <cstdint>     // std::uint64_t
+#include <functional>  // std::less
+#include <iterator>    // std::iterator_traits
+#include <memory>      // std::unique_ptr
+#include <random>      // std::minstd_rand
+#include <thread>      // std::this_thread::yield
+#include <utility>     // std::move, std::swap
+#include <vector>
+
+#include "task_pool.h"   // TaskPool, TaskGroup, default_task_pool
+#include "sort_common.h" // identity_projection, make_projected_compare
+#include "pdqsort.h"     // PdqsortImpl (base case)
+#include "sort_counters.h" // SORT_COUNT_RECURSION (no-op unless SORT_COUNTERS)
+#include "sort_tuning.h"   // sort_tuning() (base case size)
+
+
+// PARALLEL IN-PLACE SAMPLE SORT (after IPS4o, Axtmann, Witt, Ferizovic & Sanders)
+//
+// Each partitioning step splits a range into up to 256 buckets at once:
+//  - splitters come from a sorted random sample, oversampled by ~0.2 log2 n per bucket; if the
+//    sample has duplicate splitters, every splitter gets its own equality bucket, which is
+//    never recursed on (many-duplicates input finishes in a few levels);
+//  - elements are classified by descending an implicit search tree of splitters without
+//    branching on comparisons, several elements interleaved to keep the pipeline full;
+//  - every thread classifies its stripe into one block buffer per bucket and writes full blocks
+//    back to the start of its stripe, so the stripe holds only complete single-bucket blocks;
+//  - the blocks are then permuted into their buckets in place: threads swap blocks along
+//    cycles, coordinating through one atomic read/write pointer pair per bucket;
+//  - the partially filled buffers finally fill the unaligned head and tail of every bucket.
+// Buckets are then sorted recursively, in parallel; small ones go to pdqsort. Extra memory is
+// the per-thread buffers, O(p * buckets * block), independent of n. Ranges of at most
+// sort_tuning().sample_sort_base_case_size (default 4096) go straight to pdqsort.
+
+const int SAMPLE_SORT_MAX_LOG_BUCKETS = 8;                     // At most 256 buckets per step
+const std::size_t SAMPLE_SORT_BLOCK_BYTES = 2048;              // Block size of the permutation
+const std::ptrdiff_t SAMPLE_SORT_MIN_PARALLEL_SIZE = 1 << 16;  // Elements per thread of a parallel step
+
+namespace SampleSortImpl {
+
+const int CLASSIFY_BATCH = 8; // Elements classified side by side
+
+template<typename T>
+constexpr std::ptrdiff_t block_size() {
+    return sizeof(T) >= SAMPLE_SORT_BLOCK_BYTES ? 1 : static_cast<std::ptrdiff_t>(SAMPLE_SORT_BLOCK_BYTES / sizeof(T));
+}
+
+// Branchless bucket lookup in a complete binary search tree of splitters
+template<typename T, typename Compare>
+class Classifier {
+public:
+    // sorted_splitters: ascending, may contain duplicates. duplicate_keys forces equality buckets.
+    Classifier(std::vector<T> sorted_splitters, bool duplicate_keys, Compare& comp) : comp_(comp) {
+        std::vector<T> unique;
+        for (auto& s : sorted_splitters) {
+            if (unique.empty() || comp_(unique.back(), s)) unique.push_back(std::move(s));
+        }
+        equal_buckets_ = duplicate_keys || unique.size() < sorted_splitters.size();
+        if (equal_buckets_) {
+            // Keep 2 * buckets within the limit by thinning the splitters
+            while (unique.size() >= (std::size_t(1) << (SAMPLE_SORT_MAX_LOG_BUCKETS - 1))) {
+                std::vector<T> thinned;
+                for (std::size_t i = 1; i < unique.size(); i += 2) thinned.push_back(std::move(unique[i]));
+                unique.swap(thinned);
+            }
+        }
+        log_buckets_ = 1;
+        while ((std::size_t(1) << log_buckets_) < unique.size() + 1) ++log_buckets_;
+        buckets_ = std::size_t(1) << log_buckets_;
+
+        // Pad with copies of the largest splitter: the extra buckets just stay empty
+        sorted_ = unique;
+        while (sorted_.size() < buckets_) sorted_.push_back(sorted_.back());
+        tree_.resize(buckets_);
+        build_tree(1, 0, buckets_ - 1);
+    }
+
+    std::size_t num_buckets() const { return equal_buckets_ ? 2 * buckets_ : buckets_; }
+    bool is_equality_bucket(std::size_t bucket) const { return equal_buckets_ && (bucket & 1); }
+
+    template<typename Key>
+    std::size_t classify(const Key& key) {
+        std::size_t b = 1;
+        for (int level = 0; level < log_buckets_; ++level) b = 2 * b + static_cast<std::size_t>(comp_(tree_[b], key));
+        return finish(b - buckets_, key);
+    }
+
+    // Classify CLASSIFY_BATCH consecutive elements, interleaving their tree descents
+    template<typename RandomIt>
+    void classify_batch(RandomIt first, std::size_t* out) {
+        const T* tree = tree_.data();
+        Compare comp = comp_;
+        std::size_t b[CLASSIFY_BATCH];
+        for (int u = 0; u < CLASSIFY_BATCH; ++u) b[u] = 1;
+        for (int level = 0; level < log_buckets_; ++level) {
+            for (int u = 0; u < CLASSIFY_BATCH; ++u) b[u] = 2 * b[u] + static_cast<std::size_t>(comp(tree[b[u]], first[u]));
+        }
+        for (int u = 0; u < CLASSIFY_BATCH; ++u) out[u] = finish(b[u] - buckets_, first[u]);
+    }
+
+private:
+    // In-order layout of sorted_[lo, hi) as the implicit tree rooted at node
+    void build_tree(std::size_t node, std::size_t lo, std::size_t hi) {
+        if (node >= buckets_ || lo >= hi) return;
+        std::size_t mid = lo + (hi - lo) / 2;
+        tree_[node] = sorted_[mid];
+        build_tree(2 * node, lo, mid);
+        build_tree(2 * node + 1, mid + 1, hi);
+    }
+
+    // b = number of splitters below the key; with equality buckets, key == splitter b goes to 2b + 1
+    template<typename Key>
+    std::size_t finish(std::size_t b, const Key& key) {
+        if (!equal_buckets_) return b;
+        std::size_t equal = static_cast<std::size_t>(!comp_(key, sorted_[b])) & static_cast<std::size_t>(b + 1 < buckets_);
+        return 2 * b + equal;
+    }
+
+    Compare& comp_;
+    std::vector<T> tree_;   // tree_[1 .. buckets_ - 1]
+    std::vector<T> sorted_; // Padded splitters, sorted_[b] bounds bucket b from above
+    std::size_t buckets_ = 0;
+    int log_buckets_ = 0;
+    bool equal_buckets_ = false;
+};
+
+// Pick splitters from an oversampled random sample moved to the front of the range. Sets
+// duplicate_keys when a splitter occurs more than once in the sample: without equality buckets
+// such a key could keep a whole range in one bucket.
+template<typename RandomIt, typename Compare>
+inline std::vector<typename std::iterator_traits<RandomIt>::value_type> choose_splitters(RandomIt begin, RandomIt end, Compare& comp, bool& duplicate_keys) {
+    std::ptrdiff_t n = end - begin;
+    int log_n = PdqsortImpl::log2(n);
+    int log_buckets = std::min(SAMPLE_SORT_MAX_LOG_BUCKETS, std::max(1, PdqsortImpl::log2(n / sort_tuning().sample_sort_base_case_size) + 1));
+    std::ptrdiff_t buckets = std::ptrdiff_t(1) << log_buckets;
+    std::ptrdiff_t oversampling = std::max(1, static_cast<int>(0.2 * log_n));
+    std::ptrdiff_t sample = std::min(n / 2, oversampling * buckets - 1);
+
+    std::minstd_rand rng(static_cast<unsigned>(n));
+    for (std::ptrdiff_t i = 0; i < sample; ++i) {
+        std::ptrdiff_t j = i + static_cast<std::ptrdiff_t>(rng() % static_cast<unsigned long>(n - i));
+        std::iter_swap(begin + i, begin + j);
+    }
+    PdqsortImpl::pdqsort_sequential(begin, begin + sample, comp, PdqsortImpl::log2(sample + 1), true);
+
+    std::vector<typename std::iterator_traits<RandomIt>::value_type> splitters;
+    std::ptrdiff_t step = std::max<std::ptrdiff_t>(1, (sample + 1) / buckets);
+    duplicate_keys = false;
+    for (std::ptrdiff_t i = step - 1; i < sample && static_cast<std::ptrdiff_t>(splitters.size()) < buckets - 1; i += step) {
+        splitters.push_back(begin[i]);
+        bool equals_next = i + 1 >= sample || !comp(begin[i], begin[i + 1]);
+        bool equals_prev = i > 0 && !comp(begin[i - 1], begin[i]);
+        duplicate_keys = duplicate_keys || equals_next || equals_prev;
+    }
+    return splitters;
+}
+
+// Per-thread classification state: one block buffer per bucket
+template<typename T>
+struct LocalBuffers {
+    std::vector<T> blocks;                // num_buckets * block_size()
+    std::vector<std::ptrdiff_t> fill;     // Elements currently buffered per bucket
+    std::vector<std::ptrdiff_t> counts;   // Elements of the stripe per bucket
+    std::ptrdiff_t stripe_begin = 0, stripe_end = 0;
+    std::ptrdiff_t write = 0;             // End of the full blocks written back to the stripe
+
+    void reset(std::size_t buckets) {
+        blocks.resize(buckets * block_size<T>());
+        fill.assign(buckets, 0);
+        counts.assign(buckets, 0);
+    }
+};
+
+// Step 1: classify [stripe_begin, stripe_end), flushing full buffers to the front of the stripe
+template<typename RandomIt, typename Classifier, typename T>
+inline void classify_stripe(RandomIt begin, Classifier& classifier, LocalBuffers<T>& local) {
+    const std::ptrdiff_t block = block_size<T>();
+    std::ptrdiff_t i = local.stripe_begin;
+    local.write = local.stripe_begin;
+    std::size_t buckets[CLASSIFY_BATCH];
+
+    auto push = [&](std::size_t b, T&& value) {
+        if (local.fill[b] == block) { // Enough elements consumed that the block fits before i
+            std::move(local.blocks.begin() + b * block, local.blocks.begin() + (b + 1) * block, begin + local.write);
+            local.write += block;
+            local.fill[b] = 0;
+        }
+        local.blocks[b * block + local.fill[b]++] = std::move(value);
+        ++local.counts[b];
+    };
+
+    for (; i + CLASSIFY_BATCH <= local.stripe_end; i += CLASSIFY_BATCH) {
+        classifier.classify_batch(begin + i, buckets);
+        for (int u = 0; u < CLASSIFY_BATCH; ++u) push(buckets[u], std::move(begin[i + u]));
+    }
+    for (; i < local.stripe_end; ++i) {
+        std::size_t b = classifier.classify(begin[i]);
+        push(b, std::move(begin[i]));
+    }
+}
+
+// Read / write pointers of one bucket, in blocks, packed as (write << 32) | read so both move
+// in a single atomic step. [write, read) holds blocks not yet permuted.
+struct BucketPointers {
+    std::atomic<std::uint64_t> write_read{0};
+    std::atomic<int> reading{0}; // Threads copying a block out of this bucket right now
+
+    static std::uint64_t pack(std::uint64_t w, std::uint64_t r) { return (w << 32) | r; }
+    static std::ptrdiff_t write_of(std::uint64_t v) { return static_cast<std::ptrdiff_t>(v >> 32); }
+    static std::ptrdiff_t read_of(std::uint64_t v) { return static_cast<std::ptrdiff_t>(v & 0xffffffffu); }
+};
+
+// Shared state of one partitioning step
+template<typename RandomIt, typename T>
+struct PartitionState {
+    RandomIt begin;
+    std::ptrdiff_t n = 0;
+    std::size_t buckets = 0;
+    std::vector<std::ptrdiff_t> bucket_start;  // buckets + 1 element offsets
+    std::vector<std::ptrdiff_t> full_blocks;   // Complete blocks per bucket
+    std::unique_ptr<BucketPointers[]> pointers;
+    std::vector<T> overflow;                   // Receives a block whose slot runs past the end of the array
+    std::vector<T> spill;                      // Block tails written past their bucket's end, per bucket
+
+    std::ptrdiff_t block_begin(std::size_t b) const { // First block slot of bucket b
+        const std::ptrdiff_t block = block_size<T>();
+        return (bucket_start[b] + block - 1) / block;
+    }
+};
+
+// Copy block slot `slot` into out, reading the overflow block for the slot past the array end
+template<typename RandomIt, typename T>
+inline void load_block(PartitionState<RandomIt, T>& state, std::ptrdiff_t slot, typename std::vector<T>::iterator out) {
+    const std::ptrdiff_t block = block_size<T>();
+    std::move(state.begin + slot * block, state.begin + (slot + 1) * block, out);
+}
+
+template<typename RandomIt, typename T>
+inline void store_block(PartitionState<RandomIt, T>& state, std::ptrdiff_t slot, typename std::vector<T>::iterator in) {
+    const std::ptrdiff_t block = block_size<T>();
+    if ((slot + 1) * block > state.n) std::move(in, in + block, state.overflow.begin());
+    else std::move(in, in + block, state.begin + slot * block);
+}
+
+// Step 3: move blocks along cycles until every bucket holds exactly its own blocks
+template<typename RandomIt, typename T, typename Classifier>
+inline void permute_blocks(PartitionState<RandomIt, T>& state, Classifier& classifier, std::size_t first_bucket) {
+    const std::ptrdiff_t block = block_size<T>();
+    std::vector<T> in_hand(block), swapped(block);
+
+    for (std::size_t k = 0; k < state.buckets; ++k) {
+        std::size_t b = (first_bucket + k) % state.buckets;
+        for (;;) {
+            // Claim the last unpermuted block of bucket b
+            BucketPointers& src = state.pointers[b];
+            src.reading.fetch_add(1);
+            std::uint64_t v = src.write_read.load();
+            bool claimed = false;
+            while (BucketPointers::read_of(v) > BucketPointers::write_of(v)) {
+                if (src.write_read.compare_exchange_weak(v, v - 1)) {
+                    claimed = true;
+                    break;
+                }
+            }
+            if (!claimed) {
+                src.reading.fetch_sub(1);
+                break;
+            }
+            load_block(state, BucketPointers::read_of(v) - 1, in_hand.begin());
+            src.reading.fetch_sub(1);
+
+            // Carry it to its bucket, swapping out whatever unpermuted block sits there
+            for (;;) {
+                std::size_t dest = classifier.classify(in_hand[0]);
+                BucketPointers& dst = state.pointers[dest];
+                std::uint64_t slot_v = dst.write_read.fetch_add(std::uint64_t(1) << 32);
+                std::ptrdiff_t slot = BucketPointers::write_of(slot_v);
+                if (slot < BucketPointers::read_of(slot_v)) {
+                    if (classifier.classify(state.begin[slot * block]) == dest) continue; // Already in place
+                    load_block(state, slot, swapped.begin());
+                    store_block(state, slot, in_hand.begin());
+                    in_hand.swap(swapped);
+                } else {
+                    while (dst.reading.load() != 0) std::this_thread::yield(); // Slot may still be read out
+                    store_block(state, slot, in_hand.begin());
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Step 4a: save the part of each bucket's last block that lies past the bucket's end
+template<typename RandomIt, typename T>
+inline void save_spill(PartitionState<RandomIt, T>& state, std::size_t b) {
+    const std::ptrdiff_t block = block_size<T>();
+    if (state.full_blocks[b] == 0) return;
+    std::ptrdiff_t blocks_end = (state.block_begin(b) + state.full_blocks[b]) * block;
+    std::ptrdiff_t bucket_end = state.bucket_start[b + 1];
+    if (blocks_end <= bucket_end) return;
+    std::ptrdiff_t last_slot = blocks_end - block;
+    auto spill = state.spill.begin() + b * block;
+    if (blocks_end > state.n) { // The slot went to the overflow block: its head belongs in the array
+        std::move(state.overflow.begin(), state.overflow.begin() + (state.n - last_slot), state.begin + last_slot);
+        std::move(state.overflow.begin() + (bucket_end - last_slot), state.overflow.end(), spill);
+    } else {
+        std::move(state.begin + bucket_end, state.begin + blocks_end, spill);
+    }
+}
+
+// Step 4b: fill the head and tail of bucket b from the spill and every thread's buffer
+template<typename RandomIt, typename T>
+inline void fill_bucket(PartitionState<RandomIt, T>& state, std::vector<LocalBuffers<T>>& locals, std::size_t b) {
+    const std::ptrdiff_t block = block_size<T>();
+    std::ptrdiff_t start = state.bucket_start[b], end = state.bucket_start[b + 1];
+    std::ptrdiff_t head_end = end, tail_begin = end, spilled = 0;
+    if (state.full_blocks[b] > 0) {
+        std::ptrdiff_t blocks_end = (state.block_begin(b) + state.full_blocks[b]) * block;
+        head_end = state.block_begin(b) * block;
+        tail_begin = std::min(blocks_end, end);
+        spilled = std::max<std::ptrdiff_t>(0, blocks_end - end);
+    }
+
+    std::ptrdiff_t pos = start;
+    auto place = [&](auto first, std::ptrdiff_t count) {
+        while (count > 0) {
+            if (pos == head_end) pos = tail_begin;
+            std::ptrdiff_t run = std::min(count, (pos < head_end ? head_end : end) - pos);
+            std::move(first, first + run, state.begin + pos);
+            first += run;
+            pos += run;
+            count -= run;
+        }
+    };
+    place(state.spill.begin() + b * block, spilled);
+    for (auto& local : locals) place(local.blocks.begin() + b * block, local.fill[b]);
+}
+
+// One partitioning step of [begin, begin + n) with `threads` threads; returns bucket offsets
+// (num_buckets + 1 entries) and leaves every element in its bucket
+template<typename RandomIt, typename Compare>
+inline std::vector<std::ptrdiff_t> partition(RandomIt begin, std::ptrdiff_t n, Classifier<typename std::iterator_traits<RandomIt>::value_type, Compare>& classifier,
+                                             TaskPool& pool, unsigned threads) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    const std::ptrdiff_t block = block_size<T>();
+    const std::size_t buckets = classifier.num_buckets();
+    const std::ptrdiff_t slots = n / block; // Complete block slots
+
+    auto parallel_for = [&](unsigned tasks, auto&& body) {
+        if (tasks <= 1) {
+            for (unsigned t = 0; t < tasks; ++t) body(t);
+            return;
+        }
+        TaskGroup group(pool);
+        for (unsigned t = 1; t < tasks; ++t) group.run([&body, t]() { body(t); });
+        body(0);
+        group.wait();
+    };
+
+    // Step 1: classify block-aligned stripes into the local buffers
+    std::vector<LocalBuffers<T>> locals(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        locals[t].stripe_begin = std::min(n, (slots * t / threads) * block);
+        locals[t].stripe_end = (t + 1 == threads) ? n : (slots * (t + 1) / threads) * block;
+    }
+    parallel_for(threads, [&](unsigned t) {
+        locals[t].reset(buckets);
+        classify_stripe(begin, classifier, locals[t]);
+    });
+
+    // Step 2: bucket boundaries, then gather the full blocks into slots [0, total_full)
+    PartitionState<RandomIt, T> state;
+    state.begin = begin;
+    state.n = n;
+    state.buckets = buckets;
+    state.bucket_start.assign(buckets + 1, 0);
+    state.full_blocks.assign(buckets, 0);
+    for (std::size_t b = 0; b < buckets; ++b) {
+        std::ptrdiff_t size = 0;
+        for (auto& local : locals) {
+            size += local.counts[b];
+            state.full_blocks[b] += (local.counts[b] - local.fill[b]) / block;
+        }
+        state.bucket_start[b + 1] = state.bucket_start[b] + size;
+    }
+
+    std::ptrdiff_t total_full = 0;
+    for (auto& local : locals) total_full += (local.write - local.stripe_begin) / block;
+    // Empty slots below total_full pair up with full slots at or above it
+    std::vector<std::ptrdiff_t> holes, strays;
+    for (auto& local : locals) {
+        std::ptrdiff_t full_end = local.write / block, stripe_end = (local.stripe_end + block - 1) / block;
+        for (std::ptrdiff_t s = full_end; s < std::min(stripe_end, total_full); ++s) holes.push_back(s);
+        for (std::ptrdiff_t s = std::max(local.stripe_begin / block, total_full); s < full_end; ++s) strays.push_back(s);
+    }
+    unsigned move_tasks = std::min<unsigned>(threads, static_cast<unsigned>(holes.size()));
+    parallel_for(move_tasks, [&](unsigned t) {
+        for (std::size_t i = holes.size() * t / move_tasks; i < holes.size() * (t + 1) / move_tasks; ++i) {
+            std::move(begin + strays[i] * block, begin + (strays[i] + 1) * block, begin + holes[i] * block);
+        }
+    });
+
+    // Step 3: block permutation. Bucket b owns slots [block_begin(b), block_begin(b + 1)); the
+    // full blocks among them (those below total_full) are its unpermuted ones.
+    state.pointers.reset(new BucketPointers[buckets]);
+    for (std::size_t b = 0; b < buckets; ++b) {
+        std::ptrdiff_t first = state.block_begin(b);
+        std::ptrdiff_t last = std::max(first, std::min(state.block_begin(b + 1), total_full));
+        state.pointers[b].write_read.store(BucketPointers::pack(first, last));
+    }
+    state.overflow.resize(block);
+    parallel_for(threads, [&](unsigned t) { permute_blocks(state, classifier, buckets * t / threads); });
+
+    // Step 4: put the partial buffers and block overhangs in the bucket heads and tails
+    state.spill.resize(buckets * block);
+    for (std::size_t b = 0; b < buckets; ++b) save_spill(state, b);
+    parallel_for(threads, [&](unsigned t) {
+        for (std::size_t b = buckets * t / threads; b < buckets * (t + 1) / threads; ++b) fill_bucket(state, locals, b);
+    });
+
+    return state.bucket_start;
+}
+
+template<typename RandomIt, typename Compare>
+inline void sample_sort_recursive(RandomIt begin, RandomIt end, Compare comp, TaskPool& pool, bool parallel) {
+    SORT_COUNT_RECURSION();
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    std::ptrdiff_t n = end - begin;
+    const std::ptrdiff_t base_case_size = sort_tuning().sample_sort_base_case_size;
+    if (n <= base_case_size) {
+        if (n > 1) PdqsortImpl::pdqsort_sequential(begin, end, comp, PdqsortImpl::log2(n), true);
+        return;
+    }
+
+    unsigned threads = 1;
+    if (parallel) {
+        std::ptrdiff_t by_size = n / SAMPLE_SORT_MIN_PARALLEL_SIZE;
+        threads = static_cast<unsigned>(std::max<std::ptrdiff_t>(1, std::min<std::ptrdiff_t>(pool.thread_count(), by_size)));
+    }
+
+    bool duplicate_keys = false;
+    std::vector<T> splitters = choose_splitters(begin, end, comp, duplicate_keys);
+    Classifier<T, Compare> classifier(std::move(splitters), duplicate_keys, comp);
+    std::vector<std::ptrdiff_t> bounds = partition(begin, n, classifier, pool, threads);
+
+    // Buckets big enough to keep several threads busy partition in parallel again
+    TaskGroup group(pool);
+    for (std::size_t b = 0; b + 1 < bounds.size(); ++b) {
+        std::ptrdiff_t size = bounds[b + 1] - bounds[b];
+        if (size <= 1 || classifier.is_equality_bucket(b)) continue;
+        RandomIt first = begin + bounds[b], last = begin + bounds[b + 1];
+        bool parallel_bucket = parallel && size >= 2 * SAMPLE_SORT_MIN_PARALLEL_SIZE;
+        if (parallel && size > base_case_size) {
+            group.run([=, &pool]() { sample_sort_recursive(first, last, comp, pool, parallel_bucket); });
+        } else {
+            sample_sort_recursive(first, last, comp, pool, false);
+        }
+    }
+    group.wait();
+}
+
+} // namespace SampleSortImpl
+
+// Parallel in-place sample sort on the given TaskPool (unstable)
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void sample_sort(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}, TaskPool& pool = default_task_pool()) {
+    if (last - first < 2) return;
+    SampleSortImpl::sample_sort_recursive(first, last, make_projected_compare(comp, proj), pool, true);
+}
+inline void sample_sort(std::vector<int>& arr, TaskPool& pool = default_task_pool()) {
+    sample_sort(arr.begin(), arr.end(), std::less<>(), identity_projection(), pool);
+}
+
+
+#endif
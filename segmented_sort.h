@@ -0,0 +1,151 @@
+#ifndef SEGMENTED_SORT_H
+#define SEGMENTED_SORT_H
+
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <functional>  // std::less
+#include <stdexcept>   // std::invalid_argument
+#include <string>
+#include <utility>     // std::pair, std::make_pair
+#include <vector>
+
+#include "task_pool.h"      // TaskPool, TaskGroup, default_task_pool
+#include "sort_common.h"    // identity_projection, make_projected_compare
+#include "sort_tuning.h"    // sort_tuning() (insertion sort threshold)
+#include "simd_sort.h"      // simd_sort_leaf, SIMD_SORT_LEAF_THRESHOLD
+#include "sorting_network.h" // fixed_sort_leaf, FIXED_SORT_LEAF_MAX
+#include "pdqsort.h"        // PdqsortImpl (per-segment sort)
+#include "sorting.h"        // quickSortRecursive (segments large enough for the whole pool)
+
+
+// SEGMENTED / BATCHED SORT (many independent small arrays)
+//
+// segmented_sort sorts every segment [first + offsets[i], first + offsets[i + 1]) of one flat
+// buffer; batched_sort does the same for a vector of vectors. Each segment goes to the kernel
+// of its size class, with none of the per-call setup (depth limit, projection wrapper) of a
+// separate introsort call:
+//  - up to FIXED_SORT_LEAF_MAX arithmetic keys under std::less / std::greater: the scalar
+//    network for exactly that size (3x the segments per second of insertion sort at 10);
+//  - otherwise 2 elements: one compare-exchange; up to SEGMENTED_SORT_INSERTION_MAX: insertion sort;
+//  - up to SIMD_SORT_LEAF_THRESHOLD int32 / int64 / float keys under std::less: the SIMD
+//    sorting networks, otherwise insertion sort up to the introsort threshold;
+//  - larger: the sequential pdqsort engine;
+//  - SEGMENTED_SORT_LARGE_SEGMENT and up, on a pool of several threads: the parallel quickSort
+//    engine on the whole pool, one such segment at a time.
+// The segments are swept in memory order. Grouping them by size class first (a counting sort
+// of the segment indices, per L2-sized window) was measured slower for every mix of sizes: the
+// kernel choice is cheap to predict, the indirection and the extra passes are not.
+// With more than one pool thread and at least SEGMENTED_SORT_PARALLEL_MIN elements in all, the
+// segments are cut into runs of consecutive segments of about equal element count (a few per
+// thread) that sort as pool tasks. Nothing is allocated apart from those tasks.
+
+const std::ptrdiff_t SEGMENTED_SORT_PARALLEL_MIN = 1 << 15;  // Fewer elements in all: the caller's thread only
+const std::ptrdiff_t SEGMENTED_SORT_LARGE_SEGMENT = 1 << 16; // Segments this large get the whole pool
+const int SEGMENTED_SORT_CHUNKS_PER_THREAD = 4;               // Balances segments of uneven cost
+const std::ptrdiff_t SEGMENTED_SORT_INSERTION_MAX = 6;       // Insertion sort beats a mostly padded network up to here
+
+namespace SegmentedSortImpl {
+
+template<typename RandomIt, typename Compare>
+inline void sort_segment(RandomIt first, RandomIt last, Compare& comp) {
+    std::ptrdiff_t n = last - first;
+    if constexpr (use_fixed_sort_leaf<RandomIt, Compare>::value) {
+        if (fixed_sort_leaf(first, n, comp)) return;
+    }
+    if (n < 2) {
+        return;
+    } else if (n == 2) {
+        PdqsortImpl::sort2(first, first + 1, comp);
+    } else if (n <= SEGMENTED_SORT_INSERTION_MAX) {
+        PdqsortImpl::insertion_sort(first, last, comp);
+    } else if (n <= SIMD_SORT_LEAF_THRESHOLD && simd_sort_leaf<RandomIt, Compare>(first, last)) {
+        return;
+    } else if (n <= sort_tuning().introsort_insertion_threshold) {
+        PdqsortImpl::insertion_sort(first, last, comp);
+    } else {
+        PdqsortImpl::pdqsort_sequential(first, last, comp, PdqsortImpl::log2(n), true, sort_tuning().introsort_insertion_threshold);
+    }
+}
+
+// Sort segments [begin, end) one after another
+template<typename Segment, typename Compare>
+inline void sort_run(std::size_t begin, std::size_t end, const Segment& segment, Compare& comp) {
+    for (std::size_t i = begin; i < end; ++i) {
+        auto range = segment(i);
+        sort_segment(range.first, range.second, comp);
+    }
+}
+
+// segment(i) returns the iterator pair of segment i < count
+template<typename Segment, typename Compare>
+inline void sort_segments(std::size_t count, const Segment& segment, Compare& comp, TaskPool& pool) {
+    std::ptrdiff_t total = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto range = segment(i);
+        if (range.second < range.first) throw std::invalid_argument("segmented_sort: segment " + std::to_string(i) + " ends before it begins");
+        total += range.second - range.first;
+    }
+    if (pool.thread_count() < 2 || total < SEGMENTED_SORT_PARALLEL_MIN) {
+        sort_run(0, count, segment, comp);
+        return;
+    }
+
+    TaskGroup group(pool);
+    auto fork = [&](std::size_t begin, std::size_t end) {
+        if (begin < end) group.run([begin, end, &segment, comp]() mutable { sort_run(begin, end, segment, comp); });
+    };
+    std::ptrdiff_t chunk = total / (static_cast<std::ptrdiff_t>(pool.thread_count()) * SEGMENTED_SORT_CHUNKS_PER_THREAD) + 1;
+    std::ptrdiff_t filled = 0;
+    std::size_t begin = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto range = segment(i);
+        std::ptrdiff_t n = range.second - range.first;
+        if (n >= SEGMENTED_SORT_LARGE_SEGMENT) {
+            fork(begin, i);
+            quickSortRecursive(range.first, range.second, comp, PdqsortImpl::log2(n), true, pool);
+            begin = i + 1;
+            filled = 0;
+        } else if ((filled += n) >= chunk) {
+            fork(begin, i + 1);
+            begin = i + 1;
+            filled = 0;
+        }
+    }
+    fork(begin, count);
+    group.wait();
+}
+
+} // namespace SegmentedSortImpl
+
+// Sort each segment [first + offsets[i], first + offsets[i + 1]) of a flat buffer: offsets_last -
+// offsets_first bounds describe one segment fewer. Offsets must not decrease (std::invalid_argument).
+template<typename RandomIt, typename OffsetIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void segmented_sort(RandomIt first, OffsetIt offsets_first, OffsetIt offsets_last, Compare comp = {}, Proj proj = {},
+                           TaskPool& pool = default_task_pool()) {
+    std::ptrdiff_t bounds = offsets_last - offsets_first;
+    if (bounds < 2) return;
+    auto cmp = make_projected_compare(comp, proj);
+    auto segment = [first, offsets_first](std::size_t i) {
+        return std::make_pair(first + static_cast<std::ptrdiff_t>(offsets_first[i]), first + static_cast<std::ptrdiff_t>(offsets_first[i + 1]));
+    };
+    SegmentedSortImpl::sort_segments(static_cast<std::size_t>(bounds - 1), segment, cmp, pool);
+}
+inline void segmented_sort(std::vector<int>& data, const std::vector<std::size_t>& offsets,
+                           TaskPool& pool = default_task_pool()) {
+    if (!offsets.empty() && offsets.back() > data.size()) throw std::invalid_argument("segmented_sort: offsets run past the data");
+    segmented_sort(data.begin(), offsets.begin(), offsets.end(), std::less<>(), identity_projection(), pool);
+}
+
+// Sort every vector of arrays, with the same kernels and parallel split as segmented_sort
+template<typename T, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void batched_sort(std::vector<std::vector<T>>& arrays, Compare comp = {}, Proj proj = {},
+                         TaskPool& pool = default_task_pool()) {
+    auto cmp = make_projected_compare(comp, proj);
+    auto segment = [&arrays](std::size_t i) { return std::make_pair(arrays[i].begin(), arrays[i].end()); };
+    SegmentedSortImpl::sort_segments(arrays.size(), segment, cmp, pool);
+}
+inline void batched_sort(std::vector<std::vector<int>>& arrays, TaskPool& pool = default_task_pool()) {
+    batched_sort(arrays, std::less<>(), identity_projection(), pool);
+}
+
+
+#endif
@@ -0,0 +1,73 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <cstdlib>   // std::strtoll
+#include <iomanip>   //  std::setw, std::left (formatting output)
+
+#include "segmented_sort.h"   // segmented_sort
+#include "advanced_sorting.h" // introsort (the per-array loop it replaces)
+#include "datasets.h"         // load_dataset (the flat key buffer)
+#include "benchmark_timing.h" // benchmark_sort_average_ms, print_benchmark_row
+
+// Benchmark: sorting many independent small arrays held in one flat buffer with segment
+// offsets. A loop of introsort / std::sort calls, one per segment, against segmented_sort on
+// the caller's thread only (a pool of one) and on the default pool. Segment sizes are fixed
+// at 10, 100 and 1000 or drawn uniformly from 1..16 or 10..1000. Reports the average over
+// NUM_RUNS in ms and in segments per second; every output is checked against per-segment
+// std::sort.
+// Usage: segmented_sort_bench [total_elements]   (default 10M)
+
+// Constants
+const std::size_t DEFAULT_TOTAL = 10000000;
+const int NUM_RUNS = 3;
+
+
+// Segment offsets covering total elements, sizes from size_of()
+template <typename SizeOf>
+std::vector<std::size_t> make_offsets(std::size_t total, SizeOf size_of) {
+    std::vector<std::size_t> offsets = {0};
+    while (offsets.back() < total) offsets.push_back(std::min(total, offsets.back() + size_of()));
+    return offsets;
+}
+
+
+int main(int argc, char* argv[]) {
+    std::size_t total = argc > 1 ? static_cast<std::size_t>(std::strtoll(argv[1], nullptr, 10)) : DEFAULT_TOTAL;
+    std::vector<int> data = load_dataset<int>("random", total);
+    std::mt19937_64 rng(DATASET_DEFAULT_SEED);
+    TaskPool single(1);
+    TaskPool& pool = default_task_pool();
+
+    struct Layout { std::string name; std::vector<std::size_t> offsets; };
+    std::vector<Layout> layouts = {
+        {"1..16 mixed", make_offsets(total, [&rng] { return std::size_t(1 + rng() % 16); })},
+        {"10 each", make_offsets(total, [] { return std::size_t(10); })},
+        {"100 each", make_offsets(total, [] { return std::size_t(100); })},
+        {"1000 each", make_offsets(total, [] { return std::size_t(1000); })},
+        {"10..1000 mixed", make_offsets(total, [&rng] { return std::size_t(10 + rng() % 991); })},
+    };
+
+    std::cout << "Segmented sort of " << total << " random ints (avg over " << NUM_RUNS << " runs, "
+              << pool.thread_count() << " pool thread(s))\n" << std::fixed << std::setprecision(3);
+    for (const Layout& layout : layouts) {
+        const std::vector<std::size_t>& offsets = layout.offsets;
+        std::size_t segments = offsets.size() - 1;
+        std::vector<int> expected = data;
+        for (std::size_t s = 0; s < segments; ++s) std::sort(expected.begin() + offsets[s], expected.begin() + offsets[s + 1]);
+
+        std::cout << "\n=== " << layout.name << ": " << segments << " segments ===\n";
+        std::cout << "  " << std::left << std::setw(30) << "variant" << std::right << std::setw(12) << "ms"
+                  << std::setw(14) << "Msegments/s" << "\n";
+        print_benchmark_row("introsort per segment", 30, benchmark_sort_average_ms(NUM_RUNS, data, expected, [&](std::vector<int>& d) {
+            for (std::size_t s = 0; s < segments; ++s) introsort(d.begin() + offsets[s], d.begin() + offsets[s + 1]); }), segments, 14);
+        print_benchmark_row("std::sort per segment", 30, benchmark_sort_average_ms(NUM_RUNS, data, expected, [&](std::vector<int>& d) {
+            for (std::size_t s = 0; s < segments; ++s) std::sort(d.begin() + offsets[s], d.begin() + offsets[s + 1]); }), segments, 14);
+        print_benchmark_row("segmented_sort, 1 thread", 30, benchmark_sort_average_ms(NUM_RUNS, data, expected, [&](std::vector<int>& d) {
+            segmented_sort(d, offsets, single); }), segments, 14);
+        print_benchmark_row("segmented_sort, pool", 30, benchmark_sort_average_ms(NUM_RUNS, data, expected, [&](std::vector<int>& d) {
+            segmented_sort(d, offsets, pool); }), segments, 14);
+    }
+    return 0;
+}
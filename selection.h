@@ -0,0 +1,251 @@
+#ifndef SELECTION_H
+#define SELECTION_H
+
+#include <algorithm>   // std::min, std::max, std::swap, std::sort
+#include <cmath>       // std::floor
+#include <cstddef>     // std::ptrdiff_t
+#include <functional>  // std::less
+#include <iterator>    // std::iterator_traits
+#include <stdexcept>   // std::invalid_argument
+#include <utility>     // std::move
+#include <vector>
+
+#include "task_pool.h"   // TaskPool, TaskGroup, default_task_pool
+#include "sort_common.h" // identity_projection, make_projected_compare
+#include "sorting.h"     // medianOfThree, partition, heapify, heap_pop_bottom_up (heap_engine.h)
+#include "pdqsort.h"     // PdqsortImpl::partition_left, insertion_sort
+
+
+// SELECTION: QUICKSELECT, PARTIAL SORT, TOP-K AND QUANTILES
+//
+// quickselect (nth_element) partitions with the quickSort building blocks, medianOfThree and
+// partition, but only continues into the side holding the wanted rank: O(n) expected. When
+// the previous pivot is not less than the new one, partition_left splits off the run of keys
+// equal to it, so repeated keys cannot stall the loop. A partition that leaves more than 3/4
+// of the range counts as bad; after QUICKSELECT_BAD_PARTITION_LIMIT bad ones the remaining
+// steps use the median-of-medians pivot and a three-way partition, bounding the worst case
+// at O(n).
+//
+// partial_heap_sort keeps the k smallest in a binary max-heap (heapify) and pops it with the
+// bottom-up sift of heap_engine.h.
+// parallel_top_k scans chunks on the TaskPool, each into its own bounded heap, and reduces
+// the per-chunk winners. multi_select places several ranks with one shared recursion:
+// O(n log q) for q ranks; select_quantiles returns e.g. p50/p90/p99 from a single call.
+//
+// These rearrange the range like std::nth_element / std::partial_sort, except parallel_top_k,
+// which leaves its input untouched. Named apart from the std ones to avoid ADL ambiguities.
+
+const int QUICKSELECT_BAD_PARTITION_LIMIT = 4;
+const std::ptrdiff_t QUICKSELECT_INSERTION_THRESHOLD = 24;  // Insertion sort ranges this small
+const std::ptrdiff_t PARALLEL_SELECT_THRESHOLD = 1 << 16;   // multi_select forks, top-k chunks above this
+
+namespace SelectionImpl {
+
+// Three-way partition of [begin, end) around pivot_value: returns [lt, gt), the equal keys
+template<typename RandomIt, typename T, typename Compare>
+inline std::pair<RandomIt, RandomIt> partition_three_way(RandomIt begin, RandomIt end, const T& pivot_value, Compare& comp) {
+    RandomIt lt = begin, i = begin, gt = end;
+    while (i < gt) {
+        if (comp(*i, pivot_value)) std::iter_swap(lt++, i++);
+        else if (comp(pivot_value, *i)) std::iter_swap(i, --gt);
+        else ++i;
+    }
+    return {lt, gt};
+}
+
+template<typename RandomIt, typename Compare>
+inline void select_recursive(RandomIt begin, RandomIt nth, RandomIt end, Compare& comp);
+
+// Median of the medians of groups of five: at least 3/10 of the range on either side of it
+template<typename RandomIt, typename Compare>
+inline RandomIt median_of_medians(RandomIt begin, RandomIt end, Compare& comp) {
+    std::ptrdiff_t n = end - begin;
+    std::ptrdiff_t groups = 0;
+    for (std::ptrdiff_t i = 0; i + 5 <= n; i += 5, ++groups) {
+        PdqsortImpl::insertion_sort(begin + i, begin + i + 5, comp);
+        std::iter_swap(begin + groups, begin + i + 2);
+    }
+    if (groups == 0) {
+        PdqsortImpl::insertion_sort(begin, end, comp);
+        return begin + n / 2;
+    }
+    select_recursive(begin, begin + groups / 2, begin + groups, comp);
+    return begin + groups / 2;
+}
+
+// Introselect: afterwards *nth is the element a full sort would put there, nothing before it
+// is greater and nothing after it is less
+template<typename RandomIt, typename Compare>
+inline void select_recursive(RandomIt begin, RandomIt nth, RandomIt end, Compare& comp) {
+    int bad_allowed = QUICKSELECT_BAD_PARTITION_LIMIT;
+    bool leftmost = true;
+    while (end - begin > QUICKSELECT_INSERTION_THRESHOLD) {
+        std::ptrdiff_t size = end - begin;
+        RandomIt lo, hi; // Keys equal to the pivot end up in [lo, hi)
+        if (bad_allowed > 0) {
+            medianOfThree(begin, 0, size - 1, comp);
+            if (!leftmost && !comp(*(begin - 1), *(begin + (size - 1)))) {
+                // Same key as the previous pivot: split off the run of equal keys, all done
+                std::iter_swap(begin, begin + (size - 1));
+                RandomIt pos = PdqsortImpl::partition_left(begin, end, comp);
+                lo = begin;
+                hi = pos + 1;
+            } else {
+                RandomIt pos = begin + partition(begin, 0, size - 1, comp);
+                lo = pos;
+                hi = pos + 1;
+            }
+        } else {
+            RandomIt pivot = median_of_medians(begin, end, comp);
+            auto pivot_value = *pivot;
+            auto equal = partition_three_way(begin, end, pivot_value, comp);
+            lo = equal.first;
+            hi = equal.second;
+        }
+        if (nth < lo) {
+            end = lo;
+        } else if (nth >= hi) {
+            begin = hi;
+            leftmost = false;
+        } else {
+            return; // nth falls on a key equal to the pivot
+        }
+        if (4 * (end - begin) > 3 * size) --bad_allowed;
+    }
+    PdqsortImpl::insertion_sort(begin, end, comp);
+}
+
+// Place every rank of ranks[r_first, r_last) (sorted, relative to begin); forks above the threshold
+template<typename RandomIt, typename Compare>
+inline void multi_select_recursive(RandomIt begin, RandomIt end, const std::ptrdiff_t* r_first, const std::ptrdiff_t* r_last,
+                                   std::ptrdiff_t offset, Compare comp, TaskPool& pool) {
+    if (r_first == r_last || end - begin < 2) return;
+    const std::ptrdiff_t* mid = r_first + (r_last - r_first) / 2;
+    RandomIt nth = begin + (*mid - offset);
+    select_recursive(begin, nth, end, comp);
+    const std::ptrdiff_t* left = mid;   // Ranks equal to *mid are placed already
+    while (left > r_first && *(left - 1) == *mid) --left;
+    const std::ptrdiff_t* right = mid + 1;
+    while (right < r_last && *right == *mid) ++right;
+    TaskGroup group(pool);
+    if (r_first < left && nth - begin > PARALLEL_SELECT_THRESHOLD) {
+        group.run([=, &pool]() { multi_select_recursive(begin, nth, r_first, left, offset, comp, pool); });
+    } else {
+        multi_select_recursive(begin, nth, r_first, left, offset, comp, pool);
+    }
+    multi_select_recursive(nth + 1, end, right, r_last, offset + (nth + 1 - begin), comp, pool);
+    group.wait();
+}
+
+// Max-heap of the k smallest seen so far, built and repaired with heapify
+template<typename HeapIt, typename InputIt, typename Compare>
+inline void heap_select(HeapIt heap, std::ptrdiff_t k, InputIt first, InputIt last, Compare& comp) {
+    for (; first != last; ++first) {
+        if (comp(*first, heap[0])) {
+            heap[0] = *first;
+            heapify(heap, k, 0, comp);
+        }
+    }
+}
+
+} // namespace SelectionImpl
+
+// Quickselect: rearrange so *nth holds the element of that rank, smaller-or-equal before it
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void quickselect(RandomIt first, RandomIt nth, RandomIt last, Compare comp = {}, Proj proj = {}) {
+    if (last - first < 2 || nth >= last || nth < first) return;
+    auto cmp = make_projected_compare(comp, proj);
+    SelectionImpl::select_recursive(first, nth, last, cmp);
+}
+inline void quickselect(std::vector<int>& arr, std::ptrdiff_t nth) {
+    quickselect(arr.begin(), arr.begin() + nth, arr.end());
+}
+
+// Partial sort: [first, middle) receives the middle - first smallest elements in sorted order
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void partial_heap_sort(RandomIt first, RandomIt middle, RandomIt last, Compare comp = {}, Proj proj = {}) {
+    auto cmp = make_projected_compare(comp, proj);
+    std::ptrdiff_t k = middle - first;
+    if (k <= 0) return;
+    for (std::ptrdiff_t i = k / 2 - 1; i >= 0; --i) heapify(first, k, i, cmp);
+    for (RandomIt it = middle; it != last; ++it) {
+        if (cmp(*it, *first)) {
+            std::swap(*it, *first);
+            heapify(first, k, 0, cmp);
+        }
+    }
+    for (std::ptrdiff_t size = k; size > 1; --size) heap_pop_bottom_up<2>(first, size, cmp);
+}
+inline void partial_heap_sort(std::vector<int>& arr, std::ptrdiff_t k) {
+    partial_heap_sort(arr.begin(), arr.begin() + std::min<std::ptrdiff_t>(k, arr.size()), arr.end());
+}
+
+// The k smallest elements in sorted order; [first, last) is not modified. Each chunk of the
+// range keeps a bounded heap of k candidates; the candidates are then reduced to the top k.
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline std::vector<typename std::iterator_traits<RandomIt>::value_type>
+parallel_top_k(RandomIt first, RandomIt last, std::ptrdiff_t k, Compare comp = {}, Proj proj = {}, TaskPool& pool = default_task_pool()) {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    auto cmp = make_projected_compare(comp, proj);
+    std::ptrdiff_t n = last - first;
+    k = std::max<std::ptrdiff_t>(0, std::min(k, n));
+    if (k == 0) return {};
+
+    std::ptrdiff_t chunks = std::max<std::ptrdiff_t>(1, std::min<std::ptrdiff_t>(pool.thread_count(), n / std::max(PARALLEL_SELECT_THRESHOLD, 2 * k)));
+    std::vector<value_type> candidates(chunks * k, *first); // Chunk c owns [c * k, (c + 1) * k)
+    TaskGroup group(pool);
+    auto scan_chunk = [&, n, k, chunks](std::ptrdiff_t c) {
+        RandomIt begin = first + n * c / chunks, end = first + n * (c + 1) / chunks;
+        auto local = cmp;
+        auto heap = candidates.begin() + c * k;
+        std::copy(begin, begin + k, heap);
+        for (std::ptrdiff_t i = k / 2 - 1; i >= 0; --i) heapify(heap, k, i, local);
+        SelectionImpl::heap_select(heap, k, begin + k, end, local);
+    };
+    for (std::ptrdiff_t c = 1; c < chunks; ++c) group.run([&scan_chunk, c]() { scan_chunk(c); });
+    scan_chunk(0);
+    group.wait();
+
+    if (chunks > 1) partial_heap_sort(candidates.begin(), candidates.begin() + k, candidates.end(), cmp);
+    else for (std::ptrdiff_t size = k; size > 1; --size) heap_pop_bottom_up<2>(candidates.begin(), size, cmp);
+    candidates.resize(k);
+    return candidates;
+}
+inline std::vector<int> parallel_top_k(const std::vector<int>& arr, std::ptrdiff_t k, TaskPool& pool = default_task_pool()) {
+    return parallel_top_k(arr.begin(), arr.end(), k, std::less<>(), identity_projection(), pool);
+}
+
+// Place every rank in ranks (0-based, any order, duplicates allowed) as quickselect would
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void multi_select(RandomIt first, RandomIt last, std::vector<std::ptrdiff_t> ranks, Compare comp = {}, Proj proj = {}, TaskPool& pool = default_task_pool()) {
+    std::ptrdiff_t n = last - first;
+    for (std::ptrdiff_t r : ranks) {
+        if (r < 0 || r >= n) throw std::invalid_argument("multi_select: rank out of range");
+    }
+    std::sort(ranks.begin(), ranks.end());
+    SelectionImpl::multi_select_recursive(first, last, ranks.data(), ranks.data() + ranks.size(), 0, make_projected_compare(comp, proj), pool);
+}
+
+// Values at the given quantiles (each in [0, 1]; rank round(q * (n - 1))), in the order asked,
+// from one multi_select over the range. Example: select_quantiles(f, l, {0.5, 0.9, 0.99}).
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline std::vector<typename std::iterator_traits<RandomIt>::value_type>
+select_quantiles(RandomIt first, RandomIt last, const std::vector<double>& quantiles, Compare comp = {}, Proj proj = {}, TaskPool& pool = default_task_pool()) {
+    std::ptrdiff_t n = last - first;
+    if (n == 0 && !quantiles.empty()) throw std::invalid_argument("select_quantiles: empty range");
+    std::vector<std::ptrdiff_t> ranks;
+    for (double q : quantiles) {
+        if (!(q >= 0.0 && q <= 1.0)) throw std::invalid_argument("select_quantiles: quantile outside [0, 1]");
+        ranks.push_back(static_cast<std::ptrdiff_t>(std::floor(q * (n - 1) + 0.5)));
+    }
+    multi_select(first, last, ranks, comp, proj, pool);
+    std::vector<typename std::iterator_traits<RandomIt>::value_type> values;
+    for (std::ptrdiff_t r : ranks) values.push_back(first[r]);
+    return values;
+}
+inline std::vector<int> select_quantiles(std::vector<int>& arr, const std::vector<double>& quantiles, TaskPool& pool = default_task_pool()) {
+    return select_quantiles(arr.begin(), arr.end(), quantiles, std::less<>(), identity_projection(), pool);
+}
+
+
+#endif
@@ -0,0 +1,78 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <cstdlib>   // std::strtoll
+#include <iomanip>   //  std::setw, std::left (formatting output)
+
+#include "sorting.h"    // quickSort
+#include "selection.h"  // quickselect, partial_heap_sort, parallel_top_k, select_quantiles
+#include "benchmark_timing.h" // benchmark_copy_average_ms, print_benchmark_time
+
+// Benchmark: rank queries without a full sort. The median by quickselect against
+// std::nth_element and a full quickSort; the k smallest by partial_heap_sort and
+// parallel_top_k against std::partial_sort; p50/p90/p99 from one select_quantiles call
+// against three separate quickselects. Each result is checked against the sorted input.
+// Usage: selection_bench [size]   (default 10M; e.g. 100000000 for 100M)
+
+// Constants
+const std::size_t DEFAULT_SIZE = 10'000'000;
+const int NUM_RUNS = 3;
+const std::vector<std::ptrdiff_t> TOP_K = {100, 10000};
+
+
+int main(int argc, char* argv[]) {
+    std::size_t size = argc > 1 ? static_cast<std::size_t>(std::strtoll(argv[1], nullptr, 10)) : DEFAULT_SIZE;
+    if (size < 2) { std::cerr << "size must be at least 2\n"; return 2; }
+    std::mt19937 rng(42);
+    std::vector<int> data(size);
+    for (auto& x : data) x = static_cast<int>(rng());
+    std::vector<int> sorted = data;
+    std::sort(sorted.begin(), sorted.end());
+    std::ptrdiff_t n = static_cast<std::ptrdiff_t>(size);
+
+    std::cout << "Selection on " << size << " random ints (avg over " << NUM_RUNS << " runs, "
+              << default_task_pool().thread_count() << " pool thread(s))" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+
+    std::cout << "\n=== median ===\n";
+    int median = sorted[n / 2];
+    auto median_ok = [median](int value) { return value == median; };
+    print_benchmark_time("quickselect", 36, benchmark_copy_average_ms(NUM_RUNS, data, [n](std::vector<int>& d) { quickselect(d, n / 2); return d[n / 2]; }, median_ok));
+    print_benchmark_time("std::nth_element", 36, benchmark_copy_average_ms(NUM_RUNS, data, [n](std::vector<int>& d) {
+        std::nth_element(d.begin(), d.begin() + n / 2, d.end()); return d[n / 2]; }, median_ok));
+    print_benchmark_time("quickSort (full sort)", 36, benchmark_copy_average_ms(NUM_RUNS, data, [n](std::vector<int>& d) { quickSort(d.begin(), d.end()); return d[n / 2]; }, median_ok));
+
+    for (std::ptrdiff_t k : TOP_K) {
+        if (k > n) continue;
+        std::cout << "\n=== " << k << " smallest, sorted ===\n";
+        auto top_ok = [&sorted](const std::vector<int>& top) { return std::equal(top.begin(), top.end(), sorted.begin()); };
+        print_benchmark_time("partial_heap_sort", 36, benchmark_copy_average_ms(NUM_RUNS, data, [k](std::vector<int>& d) { partial_heap_sort(d, k); return std::vector<int>(d.begin(), d.begin() + k); }, top_ok));
+        print_benchmark_time("parallel_top_k", 36, benchmark_copy_average_ms(NUM_RUNS, data, [k](std::vector<int>& d) { return parallel_top_k(d, k); }, top_ok));
+        print_benchmark_time("std::partial_sort", 36, benchmark_copy_average_ms(NUM_RUNS, data, [k](std::vector<int>& d) {
+            std::partial_sort(d.begin(), d.begin() + k, d.end()); return std::vector<int>(d.begin(), d.begin() + k); }, top_ok));
+    }
+
+    std::cout << "\n=== p50, p90, p99 ===\n";
+    const std::vector<double> quantiles = {0.5, 0.9, 0.99};
+    std::vector<int> expected;
+    for (double q : quantiles) expected.push_back(sorted[static_cast<std::size_t>(q * (n - 1) + 0.5)]);
+    auto quantiles_ok = [&expected](const std::vector<int>& values) { return values == expected; };
+    print_benchmark_time("select_quantiles (one call)", 36, benchmark_copy_average_ms(NUM_RUNS, data, [&quantiles](std::vector<int>& d) {
+        return select_quantiles(d, quantiles); }, quantiles_ok));
+    print_benchmark_time("quickselect per quantile", 36, benchmark_copy_average_ms(NUM_RUNS, data, [&quantiles, n](std::vector<int>& d) {
+        std::vector<int> values;
+        for (double q : quantiles) {
+            std::ptrdiff_t rank = static_cast<std::ptrdiff_t>(q * (n - 1) + 0.5);
+            quickselect(d, rank);
+            values.push_back(d[rank]);
+        }
+        return values; }, quantiles_ok));
+    print_benchmark_time("quickSort (full sort)", 36, benchmark_copy_average_ms(NUM_RUNS, data, [&quantiles, n](std::vector<int>& d) {
+        quickSort(d.begin(), d.end());
+        std::vector<int> values;
+        for (double q : quantiles) values.push_back(d[static_cast<std::size_t>(q * (n - 1) + 0.5)]);
+        return values; }, quantiles_ok));
+    return 0;
+}
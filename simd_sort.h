@@ -0,0 +1,252 @@
+#ifndef SIMD_SORT_H
+#define SIMD_SORT_H
+
+#include <cstddef>     // std::ptrdiff_t
+#include <cstdint>     // std::int32_t, std::int64_t
+#include <cstring>     // std::memcpy
+#include <functional>  // std::less
+#include <iterator>    // std::iterator_traits
+#include <limits>      // std::numeric_limits
+#include <type_traits> // std::is_same, std::is_pointer, std::is_floating_point
+#include <vector>
+
+
+// SIMD SORTING NETWORKS (small-range base case)
+//
+// Bitonic sorting networks over blocks of up to 256 int32 / int64 / float keys. The block is
+// padded to a power of two with +max sentinels and held as an array of vectors; compare-exchange
+// steps between whole vectors are plain vector min/max, steps inside a vector are a lane
+// permute, a min/max and a blend. The network is written once with GCC vector extensions and
+// compiled per instruction set through target("avx2") / target("avx512f") entry points, picked
+// at runtime from the CPU flags. Without AVX2 (or on other compilers / architectures) the
+// kernels report themselves unavailable and callers keep their insertion-sort base case.
+//
+// Networks are not stable, so the leaf hooks only engage for arithmetic keys compared with
+// std::less and no projection. On a tie every compare-exchange keeps both keys (each lane its
+// own), so keys that compare equal but differ in bits, +0.0 and -0.0, still come out as a
+// permutation of the input. A NaN is another matter: vector min/max return their second operand
+// when either is NaN, so one NaN lane can overwrite a key with its neighbour or a +inf pad. Float
+// blocks holding a NaN are therefore declined and the caller's scalar base case sorts them.
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_SORT_X86 1
+#else
+#define SIMD_SORT_X86 0
+#endif
+
+const std::ptrdiff_t SIMD_SORT_MAX_BLOCK = 256;     // Largest range a single network call sorts
+const std::ptrdiff_t SIMD_SORT_LEAF_THRESHOLD = 64; // Leaf size used by quickSort / introsort / mergeSort
+
+enum class SimdSortLevel { Scalar, Avx2, Avx512 };
+
+namespace SimdSortImpl {
+
+template<typename T> struct is_key_type : std::false_type {};
+template<> struct is_key_type<std::int32_t> : std::true_type {};
+template<> struct is_key_type<std::int64_t> : std::true_type {};
+template<> struct is_key_type<float> : std::true_type {};
+
+inline SimdSortLevel detect_level() {
+#if SIMD_SORT_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdSortLevel::Avx512;
+    if (__builtin_cpu_supports("avx2")) return SimdSortLevel::Avx2;
+#endif
+    return SimdSortLevel::Scalar;
+}
+
+#if SIMD_SORT_X86
+
+// Integer type with the key's width: lane indices for __builtin_shuffle and blend masks
+template<typename T> struct lane_int { typedef std::int32_t type; };
+template<> struct lane_int<std::int64_t> { typedef std::int64_t type; };
+
+template<typename T, int W>
+struct Vec {
+    typedef T type __attribute__((vector_size(sizeof(T) * W)));
+    typedef typename lane_int<T>::type lane;
+    typedef lane mask __attribute__((vector_size(sizeof(T) * W)));
+};
+
+template<typename T>
+inline T pad_value() {
+    return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+}
+
+// Whole-vector compare-exchange: a keeps the lane-wise minima, b the maxima
+template<typename V>
+inline void compare_exchange(V& a, V& b) {
+    V lo = a < b ? a : b;
+    b = a < b ? b : a;
+    a = lo;
+}
+
+// In-vector compare-exchange of lane l with lane perm[l]; lanes set in take_max keep the larger key.
+// Each lane computes its side alone, so on a tie both must keep their own key, not the partner's.
+template<typename V, typename M>
+inline void compare_exchange_lanes(V& a, const M& perm, const M& take_max) {
+    V p = __builtin_shuffle(a, perm);
+    V lo = p < a ? p : a;
+    V hi = a < p ? p : a;
+    // Bitwise blend: a ternary on a non-comparison mask is not lowered to vector code for zmm
+    a = reinterpret_cast<V>((reinterpret_cast<M>(hi) & take_max) | (reinterpret_cast<M>(lo) & ~take_max));
+}
+
+// Bitonic sort of NV vectors of W lanes each, all comparators ascending: every stage k first
+// merges pairs of mirrored positions (i, i ^ (k - 1)) and then half-cleans at distances k/4 .. 1
+template<typename T, int W, int NV>
+inline void bitonic_sort_vectors(typename Vec<T, W>::type* v) {
+    typedef typename Vec<T, W>::type V;
+    typedef typename Vec<T, W>::mask M;
+    typedef typename Vec<T, W>::lane L;
+    const int total = W * NV;
+
+    for (int k = 2; k <= total; k *= 2) {
+        if (k <= W) { // Mirror step inside each vector
+            M perm = {}, take_max = {};
+            for (int l = 0; l < W; ++l) {
+                perm[l] = static_cast<L>(l ^ (k - 1));
+                take_max[l] = (l & (k / 2)) ? -1 : 0;
+            }
+            for (int i = 0; i < NV; ++i) compare_exchange_lanes(v[i], perm, take_max);
+        } else { // Mirror step across vectors: reverse the upper partner, min/max, reverse back
+            M reverse = {};
+            for (int l = 0; l < W; ++l) reverse[l] = static_cast<L>(W - 1 - l);
+            const int kv = k / W;
+            for (int b = 0; b < NV; b += kv) {
+                for (int t = 0; t < kv / 2; ++t) {
+                    V& lo = v[b + t];
+                    V& hi = v[b + kv - 1 - t];
+                    V r = __builtin_shuffle(hi, reverse);
+                    compare_exchange(lo, r);
+                    hi = __builtin_shuffle(r, reverse);
+                }
+            }
+        }
+        for (int j = k / 4; j >= 1; j /= 2) {
+            if (j >= W) { // Half-cleaner across vectors
+                const int jv = j / W;
+                for (int i = 0; i < NV; ++i) {
+                    if (!(i & jv)) compare_exchange(v[i], v[i + jv]);
+                }
+            } else { // Half-cleaner inside each vector
+                M perm = {}, take_max = {};
+                for (int l = 0; l < W; ++l) {
+                    perm[l] = static_cast<L>(l ^ j);
+                    take_max[l] = (l & j) ? -1 : 0;
+                }
+                for (int i = 0; i < NV; ++i) compare_exchange_lanes(v[i], perm, take_max);
+            }
+        }
+    }
+}
+
+// Any NaN lane in v[0, NV): the lanes that compare unequal to themselves (none for integer keys)
+template<typename T, int W, int NV>
+inline bool has_nan(const typename Vec<T, W>::type* v) {
+    if constexpr (std::is_floating_point<T>::value) {
+        typename Vec<T, W>::mask unordered = v[0] != v[0];
+        for (int i = 1; i < NV; ++i) unordered |= v[i] != v[i];
+        for (int l = 0; l < W; ++l) {
+            if (unordered[l]) return true;
+        }
+    }
+    return false;
+}
+
+// Load n <= W * NV keys, pad with sentinels, sort, store the first n back. Returns false, with
+// nothing stored, when a key is NaN.
+template<typename T, int W, int NV>
+inline bool sort_padded(T* data, std::ptrdiff_t n) {
+    typedef typename Vec<T, W>::type V;
+    V v[NV];
+    std::memcpy(v, data, sizeof(T) * n);
+    T* lanes = reinterpret_cast<T*>(v);
+    for (std::ptrdiff_t i = n; i < W * NV; ++i) lanes[i] = pad_value<T>();
+    if (has_nan<T, W, NV>(v)) return false;
+    bitonic_sort_vectors<T, W, NV>(v);
+    std::memcpy(data, v, sizeof(T) * n);
+    return true;
+}
+
+// Use the smallest power-of-two vector count NV that holds n keys (W lanes per vector)
+template<typename T, int W, int NV = 1>
+inline bool sort_block(T* data, std::ptrdiff_t n) {
+    if constexpr (NV < SIMD_SORT_MAX_BLOCK / W) {
+        if (n > W * NV) return sort_block<T, W, NV * 2>(data, n);
+    }
+    return sort_padded<T, W, NV>(data, n);
+}
+
+// Per-ISA entry points. flatten inlines the generic network into a function compiled for the
+// target, so the vector extensions lower to ymm / zmm min, max, permute and blend instructions.
+__attribute__((target("avx2"), flatten)) inline bool sort_avx2(std::int32_t* data, std::ptrdiff_t n) { return sort_block<std::int32_t, 8>(data, n); }
+__attribute__((target("avx2"), flatten)) inline bool sort_avx2(std::int64_t* data, std::ptrdiff_t n) { return sort_block<std::int64_t, 4>(data, n); }
+__attribute__((target("avx2"), flatten)) inline bool sort_avx2(float* data, std::ptrdiff_t n) { return sort_block<float, 8>(data, n); }
+__attribute__((target("avx512f"), flatten)) inline bool sort_avx512(std::int32_t* data, std::ptrdiff_t n) { return sort_block<std::int32_t, 16>(data, n); }
+__attribute__((target("avx512f"), flatten)) inline bool sort_avx512(std::int64_t* data, std::ptrdiff_t n) { return sort_block<std::int64_t, 8>(data, n); }
+__attribute__((target("avx512f"), flatten)) inline bool sort_avx512(float* data, std::ptrdiff_t n) { return sort_block<float, 16>(data, n); }
+
+#endif // SIMD_SORT_X86
+
+// Contiguous storage of the value type: raw pointers and std::vector iterators
+template<typename RandomIt>
+struct is_contiguous_iterator : std::integral_constant<bool,
+    std::is_pointer<RandomIt>::value ||
+    std::is_same<RandomIt, typename std::vector<typename std::iterator_traits<RandomIt>::value_type>::iterator>::value> {};
+
+template<typename T> struct is_ascending_compare : std::false_type {};
+template<typename T> struct is_ascending_compare<std::less<T>> : std::true_type {};
+
+// True when the range can go through the networks: int32 / int64 / float keys in contiguous
+// storage, ordered by std::less with no projection
+template<typename RandomIt, typename Compare>
+struct use_simd_leaf : std::integral_constant<bool,
+    is_key_type<typename std::iterator_traits<RandomIt>::value_type>::value &&
+    is_contiguous_iterator<RandomIt>::value &&
+    is_ascending_compare<Compare>::value> {};
+
+} // namespace SimdSortImpl
+
+// Instruction set the kernels dispatch to on this machine (detected once)
+inline SimdSortLevel simd_sort_level() {
+    static const SimdSortLevel level = SimdSortImpl::detect_level();
+    return level;
+}
+
+// Sort data[0, n) ascending with a sorting network. Returns false, leaving the data untouched,
+// when n exceeds SIMD_SORT_MAX_BLOCK, the requested level is Scalar / not supported by the CPU,
+// or float keys include a NaN.
+template<typename T>
+inline bool simd_sort_block(T* data, std::ptrdiff_t n, SimdSortLevel level = simd_sort_level()) {
+    static_assert(SimdSortImpl::is_key_type<T>::value, "simd_sort_block supports int32_t, int64_t and float");
+    if (n > SIMD_SORT_MAX_BLOCK || level == SimdSortLevel::Scalar || level > simd_sort_level()) return false;
+    if (n < 2) return true;
+#if SIMD_SORT_X86
+    if (level == SimdSortLevel::Avx512) return SimdSortImpl::sort_avx512(data, n);
+    return SimdSortImpl::sort_avx2(data, n);
+#else
+    return false;
+#endif
+}
+
+// Leaf size at which the recursive sorts hand [first, last) to simd_sort_leaf; 0 when the
+// networks don't apply to this iterator / comparator or the CPU has no AVX2
+template<typename RandomIt, typename Compare>
+inline std::ptrdiff_t simd_sort_leaf_size() {
+    if (!SimdSortImpl::use_simd_leaf<RandomIt, Compare>::value) return 0;
+    return simd_sort_level() == SimdSortLevel::Scalar ? 0 : SIMD_SORT_LEAF_THRESHOLD;
+}
+
+// Sort a leaf range with the networks; returns false (range untouched) when they don't apply
+template<typename RandomIt, typename Compare>
+inline bool simd_sort_leaf(RandomIt first, RandomIt last) {
+    if constexpr (SimdSortImpl::use_simd_leaf<RandomIt, Compare>::value) {
+        if (last - first < 2) return true;
+        return simd_sort_block(&*first, last - first);
+    } else {
+        return false;
+    }
+}
+
+#endif
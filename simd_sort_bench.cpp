@@ -0,0 +1,129 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>   //  std::setw, std::left (formatting output)
+
+#include "simd_sort.h"
+#include "advanced_sorting.h" // custom_insertion_sort_range (the introsort base case)
+#include "sorting.h"          // quickSort, mergeSort (the signed-zero check)
+#include "benchmark_timing.h" // benchmark_copy_average_ms, is_sorted_permutation, generate_signed_zeros
+
+// Microbenchmark: SIMD sorting networks vs the scalar base cases on small blocks.
+// Each measurement sorts consecutive blocks of one size out of a large random buffer,
+// so every block starts cold in registers but warm in cache, as leaves do in a real sort.
+// Before timing, float keys mixing +0.0 and -0.0, once without and once with NaNs, go through the
+// kernels and the sorts that use them as leaves; each output must be a bitwise permutation of the
+// input, and sorted when it has no NaN. (The kernels decline blocks holding a NaN.)
+
+// Constants
+const std::vector<int> BLOCK_SIZES = {8, 16, 24, 32, 48, 64, 96, 128, 192, 256};
+const std::size_t ELEMENTS_PER_RUN = 1 << 20;
+const int NUM_RUNS = 10;
+const std::vector<std::size_t> SIGNED_ZERO_SIZES = {2, 7, 16, 64, 200, 1000, 100000};
+
+
+//  Function to generate random keys of type T
+template <typename T>
+std::vector<T> generate_random_keys(std::size_t size) {
+    std::vector<T> keys(size);
+    std::mt19937_64 rng(std::random_device{}());
+    for (auto& k : keys) k = static_cast<T>(static_cast<std::int64_t>(rng() % 2'000'000) - 1'000'000);
+    return keys;
+}
+
+// Average nanoseconds per block for sort_block(first, last) over NUM_RUNS passes; -1 if a block is not sorted
+template <typename T, typename SortBlock>
+double average_block_time(SortBlock sort_block, const std::vector<T>& original, int block) {
+    std::size_t blocks = original.size() / block;
+    auto sort_blocks = [&sort_block, blocks, block](std::vector<T>& keys) {
+        for (std::size_t b = 0; b < blocks; ++b) sort_block(keys.data() + b * block, keys.data() + (b + 1) * block);
+    };
+    auto blocks_sorted = [blocks, block](const std::vector<T>& keys) {
+        for (std::size_t b = 0; b < blocks; ++b) {
+            if (!std::is_sorted(keys.data() + b * block, keys.data() + (b + 1) * block)) {
+                std::cerr << "!!! Block not sorted (size " << block << ") !!!" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    };
+    double ms = benchmark_copy_average_ms(NUM_RUNS, original, sort_blocks, blocks_sorted);
+    return ms < 0 ? -1.0 : ms * 1e6 / blocks;
+}
+
+template <typename T>
+void run_type(const std::string& type_name) {
+    std::vector<T> original = generate_random_keys<T>(ELEMENTS_PER_RUN);
+    bool avx512 = simd_sort_level() == SimdSortLevel::Avx512;
+
+    std::cout << "\n=== " << type_name << " (ns per block, avg over " << NUM_RUNS << " runs) ===\n";
+    std::cout << std::left << std::setw(8) << "Block" << std::right
+              << std::setw(12) << "Insertion" << std::setw(12) << "std::sort"
+              << std::setw(12) << "AVX2" << std::setw(12) << "AVX-512" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+
+    for (int block : BLOCK_SIZES) {
+        double insertion_time = average_block_time<T>([](T* first, T* last) { custom_insertion_sort_range(first, last); }, original, block);
+        double std_time = average_block_time<T>([](T* first, T* last) { std::sort(first, last); }, original, block);
+        double avx2_time = average_block_time<T>([](T* first, T* last) { simd_sort_block(first, last - first, SimdSortLevel::Avx2); }, original, block);
+        std::cout << std::left << std::setw(8) << block << std::right
+                  << std::setw(12) << insertion_time << std::setw(12) << std_time << std::setw(12) << avx2_time;
+        if (avx512) {
+            double avx512_time = average_block_time<T>([](T* first, T* last) { simd_sort_block(first, last - first, SimdSortLevel::Avx512); }, original, block);
+            std::cout << std::setw(12) << avx512_time;
+        } else {
+            std::cout << std::setw(12) << "n/a";
+        }
+        std::cout << "\n";
+    }
+}
+
+template <typename SortFunc>
+bool check_signed_zeros(const std::string& name, std::size_t max_size, SortFunc sort_func) {
+    std::mt19937_64 rng(42);
+    for (std::size_t size : SIGNED_ZERO_SIZES) {
+        if (size > max_size) continue;
+        for (bool with_nan : {false, true}) {
+            std::vector<float> input = generate_signed_zeros<float>(size, rng, with_nan);
+            std::vector<float> output = input;
+            sort_func(output);
+            if (!is_sorted_permutation(input, output)) {
+                std::cerr << "!!! " << name << " lost or duplicated a key (size " << size << (with_nan ? ", with NaN" : "") << ") !!!" << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+int main() {
+    const char* level_names[] = {"Scalar", "AVX2", "AVX-512"};
+    std::cout << "Sorting network kernels: " << level_names[static_cast<int>(simd_sort_level())] << std::endl;
+    if (simd_sort_level() == SimdSortLevel::Scalar) {
+        std::cout << "No AVX2 on this machine (or compiler); callers use the insertion-sort base case." << std::endl;
+        return 0;
+    }
+
+    const std::size_t block_max = static_cast<std::size_t>(SIMD_SORT_MAX_BLOCK), any_size = SIGNED_ZERO_SIZES.back();
+    bool zeros_ok = check_signed_zeros("AVX2 network", block_max, [](std::vector<float>& keys) {
+        simd_sort_block(keys.data(), keys.size(), SimdSortLevel::Avx2); });
+    if (simd_sort_level() == SimdSortLevel::Avx512) {
+        zeros_ok = check_signed_zeros("AVX-512 network", block_max, [](std::vector<float>& keys) {
+            simd_sort_block(keys.data(), keys.size(), SimdSortLevel::Avx512); }) && zeros_ok;
+    }
+    zeros_ok = check_signed_zeros("quickSort<float>", any_size, [](std::vector<float>& keys) { quickSort(keys.begin(), keys.end()); }) && zeros_ok;
+    zeros_ok = check_signed_zeros("mergeSort<float>", any_size, [](std::vector<float>& keys) { mergeSort(keys.begin(), keys.end()); }) && zeros_ok;
+    std::cout << "Signed zeros (+0.0 / -0.0) and NaNs kept as a permutation: " << (zeros_ok ? "yes" : "NO") << std::endl;
+    if (!zeros_ok) return 1;
+
+    run_type<std::int32_t>("int32");
+    run_type<std::int64_t>("int64");
+    run_type<float>("float");
+
+    std::cout << "\nLeaf threshold used by quickSort / introsort / mergeSort: " << SIMD_SORT_LEAF_THRESHOLD << std::endl;
+    return 0;
+}
@@ -0,0 +1,178 @@
+#ifndef SORT_CALIBRATION_H
+#define SORT_CALIBRATION_H
+
+#include <algorithm>  // std::sort, std::min
+#include <chrono>
+#include <cstddef>    // std::ptrdiff_t
+#include <functional> // std::less
+#include <limits>
+#include <ostream>
+#include <random>
+#include <vector>
+
+#include "adaptive_sort.h" // adaptive_sort engines, SortTuning
+
+
+// THRESHOLD CALIBRATION
+//
+// Measures the crossover points in SortTuning on this machine: each engine threshold is set to
+// every candidate in turn and the candidate with the fastest median time wins; each dispatcher
+// threshold is the size (or run count) at which one engine starts beating the other. Inputs
+// are uniformly random unless noted. The whole run takes some tens of seconds. The current
+// sort_tuning() is restored afterwards; the caller decides whether to install and save the
+// result (see `benchmark --calibrate`).
+//
+// adaptive_duplicate_percent is not measured and keeps its current value.
+
+const int CALIBRATION_REPETITIONS = 5;               // Median of this many runs per point
+const std::ptrdiff_t CALIBRATION_LARGE_SIZE = 1 << 20;
+const std::ptrdiff_t CALIBRATION_SMALL_BATCH = 1 << 16; // Total elements per small-size point
+
+namespace SortCalibrationImpl {
+
+template<typename T>
+inline std::vector<T> random_input(std::ptrdiff_t n, std::mt19937_64& rng) {
+    std::vector<T> data(n);
+    std::uniform_int_distribution<int> dist(0, std::numeric_limits<int>::max());
+    for (auto& x : data) x = static_cast<T>(dist(rng));
+    return data;
+}
+
+// Median time in ms of sort(copy) over CALIBRATION_REPETITIONS runs
+template<typename T, typename Sort>
+inline double median_ms(const std::vector<T>& original, Sort sort) {
+    std::vector<double> times;
+    for (int r = 0; r < CALIBRATION_REPETITIONS; ++r) {
+        std::vector<T> data = original;
+        auto start = std::chrono::steady_clock::now();
+        sort(data);
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+// Smallest size (doubling from first up to last) from which challenger beats baseline at two
+// consecutive sizes; not_found if it never does. Two wins in a row keep one noisy point from
+// deciding the crossover.
+template<typename Challenger, typename Baseline>
+inline std::ptrdiff_t crossover_size(std::ptrdiff_t first, std::ptrdiff_t last, std::ptrdiff_t not_found, Challenger challenger,
+                                     Baseline baseline, const char* name, std::mt19937_64& rng, std::ostream* log) {
+    std::ptrdiff_t previous_win = 0;
+    for (std::ptrdiff_t size = first; size <= last; size *= 2) {
+        std::vector<int> data = random_input<int>(size, rng);
+        double challenger_ms = median_ms(data, challenger);
+        double baseline_ms = median_ms(data, baseline);
+        if (log) *log << "  size " << size << ": " << name << " " << challenger_ms << " ms, quick " << baseline_ms << " ms\n" << std::flush;
+        if (challenger_ms < baseline_ms) {
+            if (previous_win) return previous_win;
+            previous_win = size;
+        } else {
+            previous_win = 0;
+        }
+    }
+    return previous_win ? previous_win : not_found;
+}
+
+// Set field to each candidate, keep the fastest
+template<typename T, typename Sort>
+inline std::ptrdiff_t best_candidate(std::ptrdiff_t SortTuning::*field, const std::vector<std::ptrdiff_t>& candidates,
+                                     const std::vector<T>& data, Sort sort, const char* name, std::ostream* log) {
+    std::ptrdiff_t best = candidates.front();
+    double best_ms = std::numeric_limits<double>::max();
+    for (std::ptrdiff_t candidate : candidates) {
+        sort_tuning().*field = candidate;
+        double ms = median_ms(data, sort);
+        if (log) *log << "  " << name << " = " << candidate << ": " << ms << " ms\n" << std::flush;
+        if (ms < best_ms) { best_ms = ms; best = candidate; }
+    }
+    return best;
+}
+
+} // namespace SortCalibrationImpl
+
+inline SortTuning calibrate_sort_tuning(TaskPool& pool = default_task_pool(), std::ostream* log = nullptr) {
+    using namespace SortCalibrationImpl;
+    const SortTuning saved = sort_tuning();
+    SortTuning& tuning = sort_tuning();
+    SortTuning result = saved;
+    std::mt19937_64 rng(12345);
+    const std::vector<int> large = random_input<int>(CALIBRATION_LARGE_SIZE, rng);
+
+    // Engine thresholds: fastest candidate
+    if (log) *log << "Calibrating engine thresholds (" << CALIBRATION_LARGE_SIZE << " elements, " << pool.thread_count() << " thread(s))\n";
+    result.parallel_quicksort_threshold = best_candidate(&SortTuning::parallel_quicksort_threshold, {500, 1000, 2000, 4000, 8000, 16000}, large,
+        [&pool](std::vector<int>& a) { quickSort(a.begin(), a.end(), std::less<>(), identity_projection(), pool); }, "parallel_quicksort_threshold", log);
+    tuning = saved;
+    result.parallel_merge_sort_threshold = best_candidate(&SortTuning::parallel_merge_sort_threshold, {500, 1000, 2000, 4000, 8000, 16000}, large,
+        [&pool](std::vector<int>& a) { mergeSort(a.begin(), a.end(), std::less<>(), identity_projection(), pool); }, "parallel_merge_sort_threshold", log);
+    tuning = saved;
+    // double keys: int keys take the sorting-network leaves, which bypass insertion sort
+    result.introsort_insertion_threshold = best_candidate(&SortTuning::introsort_insertion_threshold, {8, 12, 16, 24, 32}, random_input<double>(1 << 18, rng),
+        [](std::vector<double>& a) { introsort(a.begin(), a.end()); }, "introsort_insertion_threshold", log);
+    tuning = saved;
+    result.timsort_min_merge = best_candidate(&SortTuning::timsort_min_merge, {16, 32, 64, 128}, random_input<int>(1 << 18, rng),
+        [](std::vector<int>& a) { tim_sort(a.begin(), a.end()); }, "timsort_min_merge", log);
+    tuning = saved;
+    result.sample_sort_base_case_size = best_candidate(&SortTuning::sample_sort_base_case_size, {1024, 2048, 4096, 8192, 16384}, large,
+        [&pool](std::vector<int>& a) { sample_sort(a.begin(), a.end(), std::less<>(), identity_projection(), pool); }, "sample_sort_base_case_size", log);
+
+    // The dispatcher thresholds are measured with the engine thresholds just found
+    tuning = result;
+    auto quick = [&pool](std::vector<int>& a) { quickSort(a.begin(), a.end(), std::less<>(), identity_projection(), pool); };
+    if (log) *log << "Calibrating dispatch thresholds\n";
+
+    // Largest size at which insertion sort still beats quickSort (batches of small arrays)
+    result.adaptive_small_size = 0;
+    for (std::ptrdiff_t size : {8, 16, 24, 32, 48, 64, 96, 128}) {
+        std::vector<int> batch = random_input<int>(CALIBRATION_SMALL_BATCH, rng);
+        double insertion_ms = median_ms(batch, [size](std::vector<int>& a) {
+            for (std::ptrdiff_t i = 0; i + size <= static_cast<std::ptrdiff_t>(a.size()); i += size) custom_insertion_sort_range(a.begin() + i, a.begin() + i + size);
+        });
+        double quick_ms = median_ms(batch, [size](std::vector<int>& a) {
+            for (std::ptrdiff_t i = 0; i + size <= static_cast<std::ptrdiff_t>(a.size()); i += size) quickSort(a.begin() + i, a.begin() + i + size);
+        });
+        if (log) *log << "  size " << size << ": insertion " << insertion_ms << " ms, quick " << quick_ms << " ms\n" << std::flush;
+        if (insertion_ms > quick_ms) break;
+        result.adaptive_small_size = size;
+    }
+
+    auto radix = [&pool](std::vector<int>& a) {
+        RadixSortOptions options;
+        options.pool = &pool;
+        radix_sort(a.begin(), a.end(), identity_projection(), options);
+    };
+    result.adaptive_radix_min_size = crossover_size(256, CALIBRATION_LARGE_SIZE, std::numeric_limits<std::ptrdiff_t>::max(),
+                                                    radix, quick, "radix", rng, log);
+
+    // Sample sort only pays off with several threads
+    result.adaptive_sample_sort_min_size = std::numeric_limits<std::ptrdiff_t>::max();
+    if (pool.thread_count() > 1) {
+        result.adaptive_sample_sort_min_size = crossover_size(1 << 15, CALIBRATION_LARGE_SIZE * 4, std::numeric_limits<std::ptrdiff_t>::max(),
+            [&pool](std::vector<int>& a) { sample_sort(a.begin(), a.end(), std::less<>(), identity_projection(), pool); },
+            quick, "sample", rng, log);
+    }
+
+    // Most runs at which tim_sort still beats the engine chosen otherwise (radix for int keys),
+    // on inputs made of that many sorted runs of random length
+    std::ptrdiff_t best_runs = 1;
+    for (std::ptrdiff_t runs = 2; runs <= CALIBRATION_LARGE_SIZE / 16; runs *= 2) {
+        std::vector<int> data = random_input<int>(CALIBRATION_LARGE_SIZE, rng);
+        std::vector<std::ptrdiff_t> cuts = {0, CALIBRATION_LARGE_SIZE};
+        for (std::ptrdiff_t i = 1; i < runs; ++i) cuts.push_back(static_cast<std::ptrdiff_t>(rng() % CALIBRATION_LARGE_SIZE));
+        std::sort(cuts.begin(), cuts.end());
+        for (std::size_t i = 0; i + 1 < cuts.size(); ++i) std::sort(data.begin() + cuts[i], data.begin() + cuts[i + 1]);
+        double tim_ms = median_ms(data, [](std::vector<int>& a) { tim_sort(a.begin(), a.end()); });
+        double other_ms = std::min(median_ms(data, quick), median_ms(data, radix));
+        if (log) *log << "  " << runs << " runs: tim " << tim_ms << " ms, best other " << other_ms << " ms\n" << std::flush;
+        if (tim_ms > other_ms) break;
+        best_runs = runs;
+    }
+    result.adaptive_run_divisor = std::max<std::ptrdiff_t>(1, CALIBRATION_LARGE_SIZE / best_runs);
+
+    tuning = saved;
+    return result;
+}
+
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef SORT_COMMON_H
+#define SORT_COMMON_H
+
+#include <functional> // std::invoke, std::less
+#include <utility>    // std::forward
+
+
+// Shared plumbing for the generic (iterator + comparator + projection) sort entry points.
+// Comparators and projections are template parameters held by value, so they inline
+// exactly like the hard-wired int comparisons; nothing goes through std::function.
+
+// Default projection: sorts by the element itself
+struct identity_projection {
+    template<typename T>
+    constexpr T&& operator()(T&& value) const noexcept { return std::forward<T>(value); }
+};
+
+// Compares projected keys: comp(proj(a), proj(b)). proj may be a callable or a
+// pointer to member (e.g. &Record::key), anything std::invoke accepts.
+template<typename Compare, typename Proj>
+struct ProjectedCompare {
+    Compare comp;
+    Proj proj;
+
+    template<typename A, typename B>
+    bool operator()(A&& a, B&& b) {
+        return static_cast<bool>(std::invoke(comp, std::invoke(proj, std::forward<A>(a)), std::invoke(proj, std::forward<B>(b))));
+    }
+};
+
+// With the identity projection the comparator is used as-is, no wrapper at all
+template<typename Compare>
+constexpr Compare make_projected_compare(Compare comp, identity_projection) {
+    return comp;
+}
+
+template<typename Compare, typename Proj>
+constexpr ProjectedCompare<Compare, Proj> make_projected_compare(Compare comp, Proj proj) {
+    return ProjectedCompare<Compare, Proj>{comp, proj};
+}
+
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef SORT_COUNTERS_H
+#define SORT_COUNTERS_H
+
+// ALGORITHM COUNTERS (compiled in only with -DSORT_COUNTERS)
+//
+// Machine-independent operation counts: comparisons and element moves are counted by
+// CountedKey, an int wrapper whose operator< and copy / move operations bump the counters,
+// so any generic sort instantiated on it is counted without touching its code. Recursion
+// depth comes from SORT_COUNT_RECURSION() at the top of the recursive helpers, and from
+// SORT_COUNT_LOOP() plus one SORT_COUNT_LOOP_STEP() per level in loops that replace a
+// recursion (the heap sifts), so both report the same depth. The macros expand to nothing
+// unless SORT_COUNTERS is defined, so regular builds carry no cost.
+//
+// Counted sorts take the generic code paths: the SIMD leaves and branchless partitioning
+// only apply to arithmetic keys, so counts describe the comparison-based algorithm itself.
+
+#ifdef SORT_COUNTERS
+
+#include <atomic>
+#include <cstdint> // std::uint64_t
+
+struct SortCounterTotals {
+    std::uint64_t comparisons = 0;
+    std::uint64_t moves = 0;     // Copy / move constructions and assignments (a swap is 3)
+    int max_depth = 0;           // Deepest SORT_COUNT_RECURSION() nesting on any thread
+};
+
+namespace SortCountersImpl {
+
+inline std::atomic<std::uint64_t> comparisons{0};
+inline std::atomic<std::uint64_t> moves{0};
+inline std::atomic<int> max_depth{0};
+inline thread_local int depth = 0;
+
+inline void record_depth(int d) {
+    int seen = max_depth.load(std::memory_order_relaxed);
+    while (d > seen && !max_depth.compare_exchange_weak(seen, d, std::memory_order_relaxed)) {}
+}
+
+} // namespace SortCountersImpl
+
+inline void sort_counters_reset() {
+    SortCountersImpl::comparisons.store(0, std::memory_order_relaxed);
+    SortCountersImpl::moves.store(0, std::memory_order_relaxed);
+    SortCountersImpl::max_depth.store(0, std::memory_order_relaxed);
+}
+
+inline SortCounterTotals sort_counters_read() {
+    SortCounterTotals totals;
+    totals.comparisons = SortCountersImpl::comparisons.load(std::memory_order_relaxed);
+    totals.moves = SortCountersImpl::moves.load(std::memory_order_relaxed);
+    totals.max_depth = SortCountersImpl::max_depth.load(std::memory_order_relaxed);
+    return totals;
+}
+
+// Depth is per thread: a task stolen by a waiting worker nests on top of the work it waits for
+class SortDepthScope {
+public:
+    SortDepthScope() { SortCountersImpl::record_depth(++SortCountersImpl::depth); }
+    ~SortDepthScope() { --SortCountersImpl::depth; }
+    SortDepthScope(const SortDepthScope&) = delete;
+    SortDepthScope& operator=(const SortDepthScope&) = delete;
+};
+
+#define SORT_COUNT_RECURSION() SortDepthScope sort_depth_scope_
+
+// One level for the loop itself and one more per step, as if each step were a recursive call
+class SortLoopDepthScope {
+public:
+    SortLoopDepthScope() { ++SortCountersImpl::depth; }
+    ~SortLoopDepthScope() {
+        SortCountersImpl::record_depth(SortCountersImpl::depth); // Steps only go deeper: the end is the peak
+        SortCountersImpl::depth -= steps_ + 1;
+    }
+    SortLoopDepthScope(const SortLoopDepthScope&) = delete;
+    SortLoopDepthScope& operator=(const SortLoopDepthScope&) = delete;
+
+    void step() { ++SortCountersImpl::depth; ++steps_; }
+
+private:
+    int steps_ = 0;
+};
+
+#define SORT_COUNT_LOOP() SortLoopDepthScope sort_loop_depth_scope_
+#define SORT_COUNT_LOOP_STEP() sort_loop_depth_scope_.step()
+
+// Int key that counts its comparisons and moves
+struct CountedKey {
+    int value = 0;
+
+    CountedKey() = default;
+    explicit CountedKey(int v) : value(v) {}
+    CountedKey(const CountedKey& other) : value(other.value) { count_move(); }
+    CountedKey(CountedKey&& other) noexcept : value(other.value) { count_move(); }
+    CountedKey& operator=(const CountedKey& other) { value = other.value; count_move(); return *this; }
+    CountedKey& operator=(CountedKey&& other) noexcept { value = other.value; count_move(); return *this; }
+
+    friend bool operator<(const CountedKey& a, const CountedKey& b) {
+        SortCountersImpl::comparisons.fetch_add(1, std::memory_order_relaxed);
+        return a.value < b.value;
+    }
+    friend bool operator>(const CountedKey& a, const CountedKey& b) { return b < a; }
+
+private:
+    static void count_move() { SortCountersImpl::moves.fetch_add(1, std::memory_order_relaxed); }
+};
+
+#else
+
+#define SORT_COUNT_RECURSION() ((void)0)
+#define SORT_COUNT_LOOP() ((void)0)
+#define SORT_COUNT_LOOP_STEP() ((void)0)
+
+#endif
+
+
+#endif
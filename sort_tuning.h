@@ -0,0 +1,148 @@
+#ifndef SORT_TUNING_H
+#define SORT_TUNING_H
+
+#include <cstddef>   // std::ptrdiff_t
+#include <cstdlib>   // std::getenv, std::strtoll
+#include <fstream>
+#include <iostream>
+#include <stdexcept> // std::invalid_argument, std::runtime_error
+#include <string>
+
+
+// RUNTIME TUNING
+//
+// The crossover points the sorts and the adaptive_sort() dispatcher depend on. The defaults
+// are the values picked on the development machine; calibrate_sort_tuning() (adaptive_sort.h,
+// `benchmark --calibrate`) measures them on the current hardware and writes a profile that is
+// loaded the first time sort_tuning() is called: from $SORT_TUNING_PROFILE if set, otherwise
+// from ./sort_tuning.profile when that file exists. A profile is plain `key = value` lines;
+// '#' starts a comment and keys missing from the file keep their defaults.
+//
+// Change values only while no sort is running: the sorts read them without synchronization.
+
+struct SortTuning {
+    // Engine thresholds
+    std::ptrdiff_t parallel_merge_sort_threshold = 2000;  // mergeSort: ranges this small are not forked / split
+    std::ptrdiff_t parallel_quicksort_threshold = 2000;   // quickSort: larger left parts are forked
+    std::ptrdiff_t introsort_insertion_threshold = 16;    // introsort: insertion sort below this
+    std::ptrdiff_t timsort_min_merge = 32;                // tim_sort: minrun is chosen in [min_merge/2, min_merge]
+    std::ptrdiff_t sample_sort_base_case_size = 4096;     // sample_sort: pdqsort below this
+
+    // adaptive_sort() dispatch
+    std::ptrdiff_t adaptive_small_size = 32;              // Insertion sort at or below this size
+    std::ptrdiff_t adaptive_run_divisor = 64;             // tim_sort when runs <= n / divisor
+    std::ptrdiff_t adaptive_radix_min_size = 4096;        // radix_sort from this size (full-range keys)
+    std::ptrdiff_t adaptive_sample_sort_min_size = 1 << 20; // sample_sort from this size (multi-threaded pool)
+    std::ptrdiff_t adaptive_duplicate_percent = 75;       // Sampled duplicates at or above this: quickSort
+};
+
+namespace SortTuningImpl {
+
+struct Field {
+    const char* key;
+    std::ptrdiff_t SortTuning::*member;
+    std::ptrdiff_t min_value;
+};
+
+inline const Field* fields(std::size_t& count) {
+    static const Field table[] = {
+        {"parallel_merge_sort_threshold", &SortTuning::parallel_merge_sort_threshold, 2},
+        {"parallel_quicksort_threshold", &SortTuning::parallel_quicksort_threshold, 2},
+        {"introsort_insertion_threshold", &SortTuning::introsort_insertion_threshold, 4}, // PDQSORT_MIN_INSERTION_THRESHOLD
+        {"timsort_min_merge", &SortTuning::timsort_min_merge, 2},
+        {"sample_sort_base_case_size", &SortTuning::sample_sort_base_case_size, 16},
+        {"adaptive_small_size", &SortTuning::adaptive_small_size, 0},
+        {"adaptive_run_divisor", &SortTuning::adaptive_run_divisor, 1},
+        {"adaptive_radix_min_size", &SortTuning::adaptive_radix_min_size, 0},
+        {"adaptive_sample_sort_min_size", &SortTuning::adaptive_sample_sort_min_size, 0},
+        {"adaptive_duplicate_percent", &SortTuning::adaptive_duplicate_percent, 0},
+    };
+    count = sizeof(table) / sizeof(table[0]);
+    return table;
+}
+
+inline std::string trim(const std::string& s) {
+    std::size_t b = s.find_first_not_of(" \t\r");
+    if (b == std::string::npos) return "";
+    std::size_t e = s.find_last_not_of(" \t\r");
+    return s.substr(b, e - b + 1);
+}
+
+inline SortTuning load_default_profile();
+
+} // namespace SortTuningImpl
+
+// Parse a profile into tuning (throws std::invalid_argument on unknown keys or bad values)
+inline void parse_sort_tuning(std::istream& in, SortTuning& tuning) {
+    std::size_t count;
+    const SortTuningImpl::Field* fields = SortTuningImpl::fields(count);
+    std::string line;
+    while (std::getline(in, line)) {
+        line = SortTuningImpl::trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+        std::size_t eq = line.find('=');
+        if (eq == std::string::npos) throw std::invalid_argument("sort tuning: expected key = value: " + line);
+        std::string key = SortTuningImpl::trim(line.substr(0, eq));
+        std::string value = SortTuningImpl::trim(line.substr(eq + 1));
+        const SortTuningImpl::Field* field = nullptr;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (key == fields[i].key) field = &fields[i];
+        }
+        if (!field) throw std::invalid_argument("sort tuning: unknown key " + key);
+        char* end = nullptr;
+        long long parsed = std::strtoll(value.c_str(), &end, 10);
+        if (value.empty() || *end != '\0' || parsed < field->min_value) {
+            throw std::invalid_argument("sort tuning: bad value for " + key + ": " + value);
+        }
+        tuning.*(field->member) = static_cast<std::ptrdiff_t>(parsed);
+    }
+}
+
+inline void write_sort_tuning(std::ostream& out, const SortTuning& tuning) {
+    std::size_t count;
+    const SortTuningImpl::Field* fields = SortTuningImpl::fields(count);
+    for (std::size_t i = 0; i < count; ++i) out << fields[i].key << " = " << tuning.*(fields[i].member) << "\n";
+}
+
+inline SortTuning load_sort_tuning(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("cannot read sort tuning profile " + path);
+    SortTuning tuning;
+    parse_sort_tuning(in, tuning);
+    return tuning;
+}
+
+inline void save_sort_tuning(const std::string& path, const SortTuning& tuning) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("cannot write sort tuning profile " + path);
+    out << "# Sort tuning profile (benchmark --calibrate)\n";
+    write_sort_tuning(out, tuning);
+}
+
+// Process-wide tuning, loaded from the default profile on first use
+inline SortTuning& sort_tuning() {
+    static SortTuning tuning = SortTuningImpl::load_default_profile();
+    return tuning;
+}
+
+namespace SortTuningImpl {
+
+// A missing ./sort_tuning.profile is normal; an unreadable or malformed profile is reported
+// on stderr and the defaults are used, so a bad profile never stops a sort
+inline SortTuning load_default_profile() {
+    const char* env = std::getenv("SORT_TUNING_PROFILE");
+    bool named = env && *env;
+    std::string path = named ? env : "sort_tuning.profile";
+    if (!named && !std::ifstream(path)) return SortTuning();
+    try {
+        return load_sort_tuning(path);
+    } catch (const std::exception& e) {
+        std::cerr << "Ignoring sort tuning profile: " << e.what() << std::endl;
+        return SortTuning();
+    }
+}
+
+} // namespace SortTuningImpl
+
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef SORT_WORKSPACE_H
+#define SORT_WORKSPACE_H
+
+#include <cstddef> // std::size_t
+#include <memory>  // std::unique_ptr
+#include <utility> // std::move
+#include <vector>
+
+
+// SORT WORKSPACE (reusable scratch memory)
+//
+// mergeSort, tim_sort, library_sort, radix_sort and adaptive_sort take an optional
+// SortWorkspace* and draw their scratch buffers from it instead of allocating them per call. A workspace holds one std::vector<T> per (element type, slot);
+// buffer<T>(n, slot) grows that vector to at least n elements and never shrinks it, so the
+// workspace keeps its high-water mark and a steady stream of sorts of similar sizes makes no
+// heap allocation after the first one. Buffers a sort needs at the same time use different
+// slots; the contents of a buffer between calls are unspecified (moved-from leftovers).
+//
+// A workspace is not thread-safe: give each thread its own, e.g. thread_sort_workspace().
+// Parallel paths still allocate a task per fork (TaskGroup), so zero allocations hold for
+// the sequential sizes and for pools of one thread, which never fork.
+//
+// Not every sort that allocates takes a workspace. These still allocate on every call:
+//   - sample_sort: splitters, the classifier, per-thread block buffers and partition state;
+//     so does adaptive_sort(..., workspace) whenever it picks SortEngine::Sample;
+//   - argsort and sort_by_key: the key-index vector they sort, besides the returned
+//     permutation (and apply_permutation's scratch columns);
+//   - parallel_top_k: the per-chunk candidate vector.
+
+class SortWorkspace {
+public:
+    SortWorkspace() = default;
+    SortWorkspace(const SortWorkspace&) = delete;
+    SortWorkspace& operator=(const SortWorkspace&) = delete;
+
+    // The (T, slot) buffer, grown to at least n elements; callers may resize or clear it and
+    // the capacity stays with the workspace
+    template<typename T>
+    std::vector<T>& buffer(std::size_t n, std::size_t slot = 0) {
+        std::vector<T>& data = find<T>(slot);
+        if (data.size() < n) data.resize(n);
+        return data;
+    }
+
+    // Bytes held by all buffers (their capacity)
+    std::size_t bytes_reserved() const {
+        std::size_t bytes = 0;
+        for (const auto& entry : entries_) bytes += entry.holder->bytes();
+        return bytes;
+    }
+
+    // Free every buffer
+    void release() { entries_.clear(); }
+
+private:
+    struct Holder {
+        virtual ~Holder() = default;
+        virtual std::size_t bytes() const = 0;
+    };
+
+    template<typename T>
+    struct TypedHolder : Holder {
+        std::vector<T> data;
+        std::size_t bytes() const override { return data.capacity() * sizeof(T); }
+    };
+
+    struct Entry {
+        const void* type;
+        std::size_t slot;
+        std::unique_ptr<Holder> holder;
+    };
+
+    // One address per type, no RTTI needed
+    template<typename T>
+    static const void* type_tag() {
+        static const char tag = 0;
+        return &tag;
+    }
+
+    template<typename T>
+    std::vector<T>& find(std::size_t slot) {
+        const void* type = type_tag<T>();
+        for (auto& entry : entries_) {
+            if (entry.type == type && entry.slot == slot) return static_cast<TypedHolder<T>*>(entry.holder.get())->data;
+        }
+        std::unique_ptr<TypedHolder<T>> holder(new TypedHolder<T>());
+        std::vector<T>& data = holder->data;
+        entries_.push_back({type, slot, std::move(holder)});
+        return data;
+    }
+
+    std::vector<Entry> entries_;
+};
+
+// The calling thread's own workspace, kept for the lifetime of the thread
+inline SortWorkspace& thread_sort_workspace() {
+    thread_local SortWorkspace workspace;
+    return workspace;
+}
+
+// Scratch vector of at least n elements: the workspace's (T, slot) buffer if there is a
+// workspace, else local resized to n
+template<typename T>
+inline std::vector<T>& sort_scratch(SortWorkspace* workspace, std::vector<T>& local, std::size_t n, std::size_t slot = 0) {
+    if (workspace) return workspace->buffer<T>(n, slot);
+    local.resize(n);
+    return local;
+}
+
+
+#endif
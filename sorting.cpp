@@ -2,59 +2,21 @@
 #include <vector>
 #include <string>
 #include <thread>
-#include <mutex>
-#include <functional> // for std::cref
 #include <chrono>
-#include <numeric>    //  for std::iota
-#include <random>
 #include <algorithm>
 #include <exception> // for std::exception
 #include <iomanip>   //  std::setw, std::left (formatting output)
 
 #include "sorting.h"
+#include "advanced_sorting.h" // radix_sort
+#include "sample_sort.h"      // sample_sort (parallel in-place sample sort)
+#include "datasets.h"         // generate_dataset, DATASET_CACHE_DIR (seeded, cached inputs)
+#include "benchmark_scheduler.h" // CPU pinning, worker limit, scaling sweeps
 
 // Constants
 const int NUM_RUNS = 10; 
-const int MAX_CONCURRENT_THREADS = 20; 
-
-// Mutex for protecting console output
-std::mutex cout_mutex;
-
-
-//  Function to generate random array
-std::vector<int> generate_random_array(int size) {
-    std::vector<int> arr(size);
-    std::mt19937 rng(std::random_device{}()); 
-    std::uniform_int_distribution<int> dist(0, 1'000'000);
-    std::generate(arr.begin(), arr.end(), [&]() { return dist(rng); });
-    return arr;
-}
-
-//  Function to generate descending array
-std::vector<int> generate_reverse_sorted_array(int size) {
-    std::vector<int> arr(size);
-    std::iota(arr.rbegin(), arr.rend(), 0);
-    return arr;
-}
-
-//  Function to generate ascending array
-std::vector<int> generate_ascending_sorted_array(int size) {
-    std::vector<int> arr(size);
-    std::iota(arr.begin(), arr.end(), 0);
-    return arr;
-}
-
-//  Function to generate shuffled array
-std::vector<int> generate_partially_sorted_array(int size) {
-    std::vector<int> arr(size);
-    std::iota(arr.begin(), arr.end(), 0); // Start with sorted array
-    if (size > 1) {
-        // Shuffle the first half
-        std::mt19937 shuffle_rng(std::random_device{}()); 
-        std::shuffle(arr.begin(), arr.begin() + std::min(size, (size / 2) + (size % 2)), shuffle_rng);
-    }
-    return arr;
-}
+const std::vector<int> STRONG_SCALING_SIZES = {10000000, 100000000};
+const int WEAK_SCALING_SIZE_PER_THREAD = 4000000;
 
 
 template <typename SortFunc>
@@ -72,37 +34,74 @@ double average_sort_time(SortFunc sort_func, const std::vector<int>& original) {
     return total_time / NUM_RUNS;
 }
 
+// Strong scaling (fixed n) and weak scaling (n per thread) of every parallel sort on pinned
+// pools of 1, 2, 4, ... up to the placement's thread count: speedup, efficiency, bandwidth
+void run_scaling_sweeps(const BenchmarkPlacement& placement) {
+    std::vector<const ParallelBenchmarkAlgorithm*> algorithms;
+    for (const auto& a : parallel_benchmark_algorithms()) algorithms.push_back(&a);
+
+    ScalingConfig config;
+    config.cache_dir = DATASET_CACHE_DIR; // Cached after the first run
+    std::cout << "\n=== Strong Scaling: Parallel Sorts (Random Data, Median of " << config.runs << " runs) ===\n" << std::flush;
+    for (int size : STRONG_SCALING_SIZES) {
+        config.size = size;
+        try {
+            if (!run_scaling_sweeps(std::cout, algorithms, placement, config)) std::cerr << "!!! A parallel sort produced a wrong result !!!" << std::endl;
+        } catch (const std::bad_alloc& e) {
+            std::cerr << "Failed to allocate memory for strong scaling of size " << size << ". Skipping." << std::endl;
+        } catch (const std::runtime_error& e) {
+            std::cerr << "Dataset cache error for size " << size << ": " << e.what() << ". Skipping." << std::endl;
+        }
+    }
+
+    config.mode = ScalingMode::Weak;
+    config.size = WEAK_SCALING_SIZE_PER_THREAD;
+    std::cout << "\n=== Weak Scaling: Parallel Sorts (Random Data, " << WEAK_SCALING_SIZE_PER_THREAD << " per thread) ===\n" << std::flush;
+    try {
+        if (!run_scaling_sweeps(std::cout, algorithms, placement, config)) std::cerr << "!!! A parallel sort produced a wrong result !!!" << std::endl;
+    } catch (const std::bad_alloc& e) {
+        std::cerr << "Failed to allocate memory for weak scaling. Skipping." << std::endl;
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Dataset cache error in weak scaling: " << e.what() << ". Skipping." << std::endl;
+    }
+}
+
 void process_dataset(int size, const std::string& label, const std::vector<int>& data) {
     double bubble_time = 0.0, insertion_time = 0.0, selection_time = 0.0;
-    double merge_time = 0.0, quick_time = 0.0, heap_time = 0.0;
+    double merge_time = 0.0, quick_time = 0.0, heap_time = 0.0, radix_time = 0.0, sample_time = 0.0;
 
     try {
         // --- Running ALL conventional sorting algorithms ---
-        { std::lock_guard<std::mutex> lock(cout_mutex); std::cout << "  [" << label << "," << size << "] Starting Bubble Sort..." << std::flush; }
-        bubble_time = average_sort_time(bubble_sort, data);
+        std::cout << "  [" << label << "," << size << "] Starting Bubble Sort..." << std::flush;
+        bubble_time = average_sort_time([](std::vector<int>& arr) { bubble_sort(arr); }, data);
 
-        { std::lock_guard<std::mutex> lock(cout_mutex); std::cout << " Done.\n  [" << label << "," << size << "] Starting Insertion Sort..." << std::flush; }
-        insertion_time = average_sort_time(insertion_sort, data);
+        std::cout << " Done.\n  [" << label << "," << size << "] Starting Insertion Sort..." << std::flush;
+        insertion_time = average_sort_time([](std::vector<int>& arr) { insertion_sort(arr); }, data);
 
-        { std::lock_guard<std::mutex> lock(cout_mutex); std::cout << " Done.\n  [" << label << "," << size << "] Starting Selection Sort..." << std::flush; }
-        selection_time = average_sort_time(selection_sort, data);
+        std::cout << " Done.\n  [" << label << "," << size << "] Starting Selection Sort..." << std::flush;
+        selection_time = average_sort_time([](std::vector<int>& arr) { selection_sort(arr); }, data);
 
-        { std::lock_guard<std::mutex> lock(cout_mutex); std::cout << " Done.\n  [" << label << "," << size << "] Starting Merge Sort..." << std::flush; }
+        std::cout << " Done.\n  [" << label << "," << size << "] Starting Merge Sort..." << std::flush;
         merge_time = average_sort_time(
             [](std::vector<int>& arr) { if (!arr.empty()) mergeSort(arr, 0, arr.size() - 1); }, data);
 
-        { std::lock_guard<std::mutex> lock(cout_mutex); std::cout << " Done.\n  [" << label << "," << size << "] Starting Quick Sort..." << std::flush; }
+        std::cout << " Done.\n  [" << label << "," << size << "] Starting Quick Sort..." << std::flush;
         quick_time = average_sort_time(
             [](std::vector<int>& arr) { if (!arr.empty()) quickSort(arr, 0, arr.size() - 1); }, data);
 
-        { std::lock_guard<std::mutex> lock(cout_mutex); std::cout << " Done.\n  [" << label << "," << size << "] Starting Heap Sort..." << std::flush; }
-        heap_time = average_sort_time(heapSort, data); 
+        std::cout << " Done.\n  [" << label << "," << size << "] Starting Heap Sort..." << std::flush;
+        heap_time = average_sort_time([](std::vector<int>& arr) { heapSort(arr); }, data); 
 
-        { std::lock_guard<std::mutex> lock(cout_mutex); std::cout << " Done." << std::endl; }
+        std::cout << " Done.\n  [" << label << "," << size << "] Starting Radix Sort..." << std::flush;
+        radix_time = average_sort_time([](std::vector<int>& arr) { radix_sort(arr); }, data);
+
+        std::cout << " Done.\n  [" << label << "," << size << "] Starting Sample Sort..." << std::flush;
+        sample_time = average_sort_time([](std::vector<int>& arr) { sample_sort(arr); }, data);
+
+        std::cout << " Done." << std::endl;
 
 
         // Format and print results
-        std::lock_guard<std::mutex> lock(cout_mutex);
         std::cout << "\n-- Results for " << label << " Data (Size: " << size << ") --\n";
         std::cout << std::fixed << std::setprecision(3);
 
@@ -117,24 +116,44 @@ void process_dataset(int size, const std::string& label, const std::vector<int>&
         print_time("Merge Sort", merge_time);
         print_time("Quick Sort", quick_time);
         print_time("Heap Sort", heap_time);
+        print_time("Radix Sort", radix_time);
+        print_time("Sample Sort", sample_time);
 
     } catch (const std::exception& e) {
-        std::lock_guard<std::mutex> lock(cout_mutex);
         std::cerr << "\n!!! Error processing dataset (" << label << ", Size: " << size << "): " << e.what() << std::endl;
     } catch (...) {
-        std::lock_guard<std::mutex> lock(cout_mutex);
         std::cerr << "\n!!! Unknown error processing dataset (" << label << ", Size: " << size << ")" << std::endl;
     }
 }
 
-// --- Main Function (Updated dataset list & info message) ---
-int main() {
+// --- Main Function ---
+// Usage: sorting [--cpus LIST | --numa-node N] [--threads N]
+// Every measurement runs alone, one dataset after another, so the parallel sorts only share
+// the CPUs with their own pool; --cpus / --numa-node pin the whole run, --threads limits the
+// pool the parallel sorts use (and the largest pool of the scaling sweeps).
+int main(int argc, char** argv) {
     std::vector<int> sizes = {1000, 10000, 100000, 500000, 1000000}; // Adjust as needed
 
+    BenchmarkPlacement placement;
+    std::string placement_info;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            if (!parse_placement_option(argc, argv, i, placement)) {
+                std::cerr << "Unknown or incomplete option: " << argv[i] << "\nUsage: " << argv[0] << " [--cpus LIST | --numa-node N] [--threads N]" << std::endl;
+                return 2;
+            }
+        }
+        placement_info = apply_benchmark_placement(placement); // Before the default pool starts
+    } catch (const std::exception& e) {
+        std::cerr << "!!! " << e.what() << " !!!" << std::endl;
+        return 2;
+    }
+
     unsigned int hardware_cores = std::thread::hardware_concurrency();
     std::cout << "Detected " << hardware_cores << " hardware threads (logical cores)." << std::endl;
-    // Update message: Now 4 concurrent tasks per size
-    std::cout << "Running up to " << MAX_CONCURRENT_THREADS << " concurrent dataset processing tasks (max 4 per size)." << std::endl;
+    std::cout << "Placement: " << placement_info << "." << std::endl;
+    std::cout << "Parallel Merge/Quick Sort share one work-stealing pool of " << default_task_pool().thread_count() << " worker threads." << std::endl;
+    std::cout << "Datasets are measured one at a time, in isolation." << std::endl;
     std::cout << "\n!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!" << std::endl;
     std::cout << "!!! WARNING: Running ALL sorts, including O(n^2) algorithms !!!" << std::endl;
     std::cout << "!!! (Bubble, Insertion, Selection) for all sizes.          !!!" << std::endl;
@@ -147,34 +166,26 @@ int main() {
         std::vector<std::pair<std::string, std::vector<int>>> datasets;
         try {
              datasets = {
-                 {"Random", generate_random_array(size)},
-                 {"Reverse Sorted", generate_reverse_sorted_array(size)},
-                 {"Partially Sorted", generate_partially_sorted_array(size)},
-                 {"Ascending Sorted", generate_ascending_sorted_array(size)} // New dataset type
+                 {"Random", generate_dataset<int>("random", size)},
+                 {"Reverse Sorted", generate_dataset<int>("descending", size)},
+                 {"Partially Sorted", generate_dataset<int>("partial", size)},
+                 {"Ascending Sorted", generate_dataset<int>("ascending", size)}
              };
         } catch (const std::bad_alloc& e) {
-             std::lock_guard<std::mutex> lock(cout_mutex);
              std::cerr << "Failed to allocate memory for datasets of size " << size << ". Skipping." << std::endl;
              continue; // Skip to next size
         }
 
         std::cout << "--- Processing Size: " << size << " ---\n" << std::flush;
-        std::vector<std::thread> threads;
-        // iterates through 4 datasets
+        // One dataset at a time: nothing else runs while a sort is timed
         for (auto const& [label, data_vec] : datasets) {
-            threads.emplace_back(process_dataset, size, label, std::cref(data_vec)); // Pass data by const ref
-        }
-
-      
-        std::cout << "Waiting for " << threads.size() << " dataset tasks for size " << size << " to complete...\n" << std::flush;
-        for (auto& t : threads) {
-             if (t.joinable()) {
-                 t.join();
-             }
+            process_dataset(size, label, data_vec);
         }
         std::cout << "--- Finished Processing Size: " << size << " ---\n" << std::flush;
     }
 
+    run_scaling_sweeps(placement);
+
     std::cout << "\n=== All Benchmarks Complete ===\n" << std::flush;
     return 0;
-}
\ No newline at end of file
+}
@@ -5,143 +5,292 @@
 #include <vector>
 #include <algorithm> // std::swap, std::min, std::max, std::make_heap, std::sort_heap
 #include <numeric>   // std::iota
-#include <functional> // std::function
-#include <utility>    // std::pair
-#include <future>     // Required for std::async, std::future
+#include <functional> // std::less
+#include <iterator>   // std::iterator_traits
+#include <cstddef>    // std::ptrdiff_t
+#include <limits>     // std::numeric_limits
+#include <utility>    // std::pair, std::move
 #include <thread>     // Required for std::thread::hardware_concurrency (optional info)
 
+#include "task_pool.h"   // TaskPool, TaskGroup, default_task_pool
+#include "sort_common.h" // identity_projection, make_projected_compare
+#include "pdqsort.h"     // PdqsortImpl (quickSort engine)
+#include "simd_sort.h"   // simd_sort_leaf (sorting-network base case)
+#include "sort_counters.h" // SORT_COUNT_RECURSION (no-op unless SORT_COUNTERS)
+#include "sort_tuning.h"   // sort_tuning() (parallel thresholds)
+#include "sort_workspace.h" // SortWorkspace, sort_scratch (mergeSort buffer)
+#include "heap_engine.h"    // heap_sift_down, heap_sort_range (heapify, heapSort)
 
-const int PARALLEL_MERGE_SORT_THRESHOLD = 2000;
-const int PARALLEL_QUICKSORT_THRESHOLD = 2000;
+
+// The parallel thresholds are runtime values: sort_tuning().parallel_merge_sort_threshold and
+// sort_tuning().parallel_quicksort_threshold (defaults 2000, see sort_tuning.h).
+
+// Every algorithm below is a template over random-access iterators, a comparator and an
+// optional key projection; the std::vector<int> signatures are thin wrappers over them.
 
 
 // RECURSIVE MERGE SORT IMPLEMENTATION (PARALELLIZED)
 
-// Helper function to merge sorted subarrays (remains sequential)
-inline void mergeHelper(std::vector<int>& arr, std::vector<int>& temp_buffer, int left, int mid, int right) {
-    for (int i = left; i <= right; ++i) {
-        temp_buffer[i] = arr[i];
+// Helper function to merge sorted subarrays in place through temp_buffer (sequential)
+template<typename RandomIt, typename BufferIt, typename Compare>
+inline void mergeHelper(RandomIt arr, BufferIt temp_buffer, std::ptrdiff_t left, std::ptrdiff_t mid, std::ptrdiff_t right, Compare comp) {
+    for (std::ptrdiff_t i = left; i <= right; ++i) {
+        temp_buffer[i] = std::move(arr[i]);
     }
-    int i = left, j = mid + 1, k = left;
+    std::ptrdiff_t i = left, j = mid + 1, k = left;
     while (i <= mid && j <= right) {
-        arr[k++] = (temp_buffer[i] <= temp_buffer[j]) ? temp_buffer[i++] : temp_buffer[j++];
+        arr[k++] = !comp(temp_buffer[j], temp_buffer[i]) ? std::move(temp_buffer[i++]) : std::move(temp_buffer[j++]);
     }
     while (i <= mid) {
-        arr[k++] = temp_buffer[i++];
+        arr[k++] = std::move(temp_buffer[i++]);
     }
+    while (j <= right) {
+        arr[k++] = std::move(temp_buffer[j++]);
+    }
+}
+inline void mergeHelper(std::vector<int>& arr, std::vector<int>& temp_buffer, int left, int mid, int right) {
+    mergeHelper(arr.begin(), temp_buffer.begin(), left, mid, right, std::less<>());
 }
 
-// RECURSIVE MERGE SORT IMPLEMENTATION (PARALELLIZED)
-inline void parallelMergeSortRecursive(std::vector<int>& arr, std::vector<int>& temp_buffer, int left, int right) {
-    if (left >= right) { return; } // Base case
-
-    if ((right - left + 1) <= PARALLEL_MERGE_SORT_THRESHOLD) { // Sequential Execution
-        int mid = left + (right - left) / 2;
-        parallelMergeSortRecursive(arr, temp_buffer, left, mid);
-        parallelMergeSortRecursive(arr, temp_buffer, mid + 1, right);
-        mergeHelper(arr, temp_buffer, left, mid, right);
+// Merge sorted [a, a_end) and [b, b_end) into out by moving; ties take from a (stable)
+template<typename InIt, typename OutIt, typename Compare>
+inline OutIt moveMerge(InIt a, InIt a_end, InIt b, InIt b_end, OutIt out, Compare comp) {
+    while (a != a_end && b != b_end) {
+        *out++ = !comp(*b, *a) ? std::move(*a++) : std::move(*b++);
+    }
+    out = std::move(a, a_end, out);
+    return std::move(b, b_end, out);
+}
+
+// Merge path / co-rank: how many of the first k merged outputs come from a (the rest from b)
+template<typename InIt, typename Compare>
+inline std::ptrdiff_t mergePathSplit(InIt a, std::ptrdiff_t na, InIt b, std::ptrdiff_t nb, std::ptrdiff_t k, Compare comp) {
+    std::ptrdiff_t lo = std::max<std::ptrdiff_t>(0, k - nb), hi = std::min(k, na);
+    while (lo < hi) {
+        std::ptrdiff_t i = lo + (hi - lo) / 2, j = k - i;
+        if (j > 0 && !comp(b[j - 1], a[i])) lo = i + 1; // a[i] still belongs before b[j - 1]
+        else hi = i;
+    }
+    return lo;
+}
+
+// Split the output into equal chunks at merge-path boundaries and merge the chunks in parallel
+template<typename InIt, typename OutIt, typename Compare>
+inline void parallelMerge(InIt a, std::ptrdiff_t na, InIt b, std::ptrdiff_t nb, OutIt out, Compare comp, TaskPool& pool) {
+    std::ptrdiff_t total = na + nb;
+    std::ptrdiff_t chunks = std::max<std::ptrdiff_t>(1, std::min<std::ptrdiff_t>(pool.thread_count(), total / sort_tuning().parallel_merge_sort_threshold));
+    if (chunks == 1) { moveMerge(a, a + na, b, b + nb, out, comp); return; } // Nothing to split: no task
+    TaskGroup group(pool);
+    for (std::ptrdiff_t c = 0; c < chunks; ++c) {
+        group.run([=]() {
+            std::ptrdiff_t k_begin = total * c / chunks, k_end = total * (c + 1) / chunks;
+            std::ptrdiff_t i_begin = mergePathSplit(a, na, b, nb, k_begin, comp);
+            std::ptrdiff_t i_end = mergePathSplit(a, na, b, nb, k_end, comp);
+            moveMerge(a + i_begin, a + i_end, b + (k_begin - i_begin), b + (k_end - i_end), out + k_begin, comp);
+        });
+    }
+    group.wait();
+}
+
+// Ping-pong recursion: sorts arr[left..right] and leaves the result in temp_buffer when
+// into_buffer is set, in arr otherwise. The halves are sorted into the other array, so each
+// level is a single merge pass with no copy-back. Forked halves and merge chunks run on the
+// given TaskPool, so the thread count stays fixed regardless of input size; a pool of one
+// thread runs the whole sort inline, without forking. Leaves of up to
+// SIMD_SORT_LEAF_THRESHOLD int32/int64/float keys are sorted by a SIMD sorting network.
+template<typename RandomIt, typename BufferIt, typename Compare>
+inline void parallelMergeSortRecursive(RandomIt arr, BufferIt temp_buffer, std::ptrdiff_t left, std::ptrdiff_t right, bool into_buffer, Compare comp, TaskPool& pool) {
+    SORT_COUNT_RECURSION();
+    if (left >= right) { // Base case
+        if (left == right && into_buffer) temp_buffer[left] = std::move(arr[left]);
+        return;
+    }
+    if (right - left + 1 <= simd_sort_leaf_size<RandomIt, Compare>() && simd_sort_leaf<RandomIt, Compare>(arr + left, arr + right + 1)) {
+        if (into_buffer) std::move(arr + left, arr + right + 1, temp_buffer + left); // Sorting-network leaf
+        return;
+    }
+
+    std::ptrdiff_t mid = left + (right - left) / 2;
+    if ((right - left + 1) <= sort_tuning().parallel_merge_sort_threshold || pool.thread_count() < 2) { // Sequential Execution
+        parallelMergeSortRecursive(arr, temp_buffer, left, mid, !into_buffer, comp, pool);
+        parallelMergeSortRecursive(arr, temp_buffer, mid + 1, right, !into_buffer, comp, pool);
+        if (into_buffer) moveMerge(arr + left, arr + mid + 1, arr + mid + 1, arr + right + 1, temp_buffer + left, comp);
+        else moveMerge(temp_buffer + left, temp_buffer + mid + 1, temp_buffer + mid + 1, temp_buffer + right + 1, arr + left, comp);
     } else { // Parallel Execution
-        int mid = left + (right - left) / 2;
-        auto future_left = std::async(std::launch::async, [&]() { parallelMergeSortRecursive(arr, temp_buffer, left, mid); });
-        parallelMergeSortRecursive(arr, temp_buffer, mid + 1, right); // Run right half synchronously
-        future_left.get(); // Wait for left half
-        mergeHelper(arr, temp_buffer, left, mid, right); // Merge
+        TaskGroup group(pool);
+        group.run([=, &pool]() { parallelMergeSortRecursive(arr, temp_buffer, left, mid, !into_buffer, comp, pool); });
+        parallelMergeSortRecursive(arr, temp_buffer, mid + 1, right, !into_buffer, comp, pool); // Run right half synchronously
+        group.wait(); // Wait for left half
+        // Merge (merge-path split across the pool)
+        if (into_buffer) parallelMerge(arr + left, mid - left + 1, arr + mid + 1, right - mid, temp_buffer + left, comp, pool);
+        else parallelMerge(temp_buffer + left, mid - left + 1, temp_buffer + mid + 1, right - mid, arr + left, comp, pool);
     }
 }
 
-inline void mergeSort(std::vector<int>& arr, int left, int right) {
+// Pass a pool explicitly to let several concurrent sorts share one set of workers, and a
+// workspace to reuse the n-element buffer across calls
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void mergeSort(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}, TaskPool& pool = default_task_pool(),
+                      SortWorkspace* workspace = nullptr) {
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    std::ptrdiff_t n = last - first;
+    if (n < 2) { return; }
+    std::vector<value_type> local;
+    std::vector<value_type>& temp_buffer = sort_scratch(workspace, local, static_cast<std::size_t>(n));
+    parallelMergeSortRecursive(first, temp_buffer.begin(), 0, n - 1, false, make_projected_compare(comp, proj), pool);
+}
+inline void mergeSort(std::vector<int>& arr, int left, int right, TaskPool& pool = default_task_pool(), SortWorkspace* workspace = nullptr) {
     if (left >= right || arr.empty()) { return; }
-    std::vector<int> temp_buffer(arr.size());
-    parallelMergeSortRecursive(arr, temp_buffer, left, right);
+    mergeSort(arr.begin() + left, arr.begin() + right + 1, std::less<>(), identity_projection(), pool, workspace);
 }
 
 
 // HEAP SORT IMPLEMENTATION
-inline void heapify(std::vector<int>& arr, int n, int i) { 
-    int largest = i;
-    int left = 2 * i + 1;
-    int right = 2 * i + 2;
-    if (left < n && arr[left] > arr[largest]) largest = left;
-    if (right < n && arr[right] > arr[largest]) largest = right;
-    if (largest != i) { std::swap(arr[i], arr[largest]); heapify(arr, n, largest); }
-}
-inline void heapSort(std::vector<int>& arr) { 
-    int n = arr.size();
-    if (n < 2) return;
-    for (int i = n / 2 - 1; i >= 0; --i) heapify(arr, n, i);
-    for (int i = n - 1; i > 0; --i) { std::swap(arr[0], arr[i]); heapify(arr, i, 0); }
+// Both run on heap_engine.h: heapify is its binary top-down sift, heapSort its d-ary
+// bottom-up heapsort (8-ary and cache-line aligned for arithmetic keys, binary otherwise).
+template<typename RandomIt, typename Compare>
+inline void heapify(RandomIt arr, std::ptrdiff_t n, std::ptrdiff_t i, Compare comp) {
+    heap_sift_down<2>(arr, n, i, comp);
+}
+inline void heapify(std::vector<int>& arr, int n, int i) {
+    heapify(arr.begin(), n, i, std::less<>());
+}
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void heapSort(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}) {
+    auto cmp = make_projected_compare(comp, proj);
+    heap_sort_range(first, last, cmp);
+}
+inline void heapSort(std::vector<int>& arr) {
+    heapSort(arr.begin(), arr.end());
 }
 
 
 // BUBBLE SORT IMPLEMENTATION
-inline void bubble_sort(std::vector<int>& arr) { 
-    std::size_t n = arr.size();
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void bubble_sort(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}) {
+    auto cmp = make_projected_compare(comp, proj);
+    std::ptrdiff_t n = last - first;
     if (n < 2) return;
-    for (std::size_t i = 0; i < n - 1; ++i) {
+    for (std::ptrdiff_t i = 0; i < n - 1; ++i) {
         bool swapped = false;
-        for (std::size_t j = 0; j < n - i - 1; ++j) {
-            if (arr[j] > arr[j + 1]) { std::swap(arr[j], arr[j + 1]); swapped = true; }
+        for (std::ptrdiff_t j = 0; j < n - i - 1; ++j) {
+            if (cmp(first[j + 1], first[j])) { std::swap(first[j], first[j + 1]); swapped = true; }
         }
         if (!swapped) break;
     }
 }
+inline void bubble_sort(std::vector<int>& arr) {
+    bubble_sort(arr.begin(), arr.end());
+}
 
 
 // INSERTION SORT IMPLEMENTATION
-inline void insertion_sort(std::vector<int>& arr) { 
-    int n = arr.size();
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void insertion_sort(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}) {
+    auto cmp = make_projected_compare(comp, proj);
+    std::ptrdiff_t n = last - first;
     if (n < 2) return;
-    for (int i = 1; i < n; ++i) {
-        int key = arr[i];
-        int j = i - 1;
-        while (j >= 0 && arr[j] > key) { arr[j + 1] = arr[j]; j--; }
-        arr[j + 1] = key;
+    for (std::ptrdiff_t i = 1; i < n; ++i) {
+        auto key = std::move(first[i]);
+        std::ptrdiff_t j = i - 1;
+        while (j >= 0 && cmp(key, first[j])) { first[j + 1] = std::move(first[j]); j--; }
+        first[j + 1] = std::move(key);
     }
 }
+inline void insertion_sort(std::vector<int>& arr) {
+    insertion_sort(arr.begin(), arr.end());
+}
 
 
 // SELECTION SORT IMPLEMENTATION
-inline void selection_sort(std::vector<int>& arr) { 
-    int n = arr.size();
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void selection_sort(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}) {
+    auto cmp = make_projected_compare(comp, proj);
+    std::ptrdiff_t n = last - first;
     if (n < 2) return;
-    for (int i = 0; i < n - 1; ++i) {
-        int min_idx = i;
-        for (int j = i + 1; j < n; ++j) { if (arr[j] < arr[min_idx]) min_idx = j; }
-        if (min_idx != i) std::swap(arr[i], arr[min_idx]);
-    }
-}
-
-
-//PARALLEL QUICK SORT IMPLEMENTATION
-
-// Partition
-inline int partition(std::vector<int>& arr, int low, int high) { 
-    int pivot = arr[high]; int i = (low - 1);
-    for (int j = low; j <= high - 1; j++) { if (arr[j] <= pivot) { i++; if (i != j) std::swap(arr[i], arr[j]); } }
-    std::swap(arr[i + 1], arr[high]); return (i + 1);
-}
-// Median-of-three pivot selection 
-inline void medianOfThree(std::vector<int>& arr, int low, int high) { 
-    if (low >= high) return; int mid = low + (high - low) / 2;
-    if (arr[low] > arr[mid]) std::swap(arr[low], arr[mid]); if (arr[low] > arr[high]) std::swap(arr[low], arr[high]); if (arr[mid] > arr[high]) std::swap(arr[mid], arr[high]);
-    std::swap(arr[mid], arr[high]);
-}
-//  Quick Sort function implementation (PARALELLIZED)
-inline void quickSort(std::vector<int>& arr, int low, int high) {
-    if (low < high) {
-        if ((high - low + 1) <= PARALLEL_QUICKSORT_THRESHOLD) { // Sequential Execution
-             medianOfThree(arr, low, high); int p = partition(arr, low, high);
-             quickSort(arr, low, p - 1); quickSort(arr, p + 1, high);
-        } else { // Parallel Execution
-             medianOfThree(arr, low, high); int p = partition(arr, low, high);
-             auto future_left = std::async(std::launch::async, [&]() { quickSort(arr, low, p - 1); });
-             quickSort(arr, p + 1, high); // Run right half synchronously
-             future_left.get(); // Wait for left half
-        }
+    for (std::ptrdiff_t i = 0; i < n - 1; ++i) {
+        std::ptrdiff_t min_idx = i;
+        for (std::ptrdiff_t j = i + 1; j < n; ++j) { if (cmp(first[j], first[min_idx])) min_idx = j; }
+        if (min_idx != i) std::swap(first[i], first[min_idx]);
     }
 }
+inline void selection_sort(std::vector<int>& arr) {
+    selection_sort(arr.begin(), arr.end());
+}
+
+
+//PARALLEL QUICK SORT IMPLEMENTATION (pattern-defeating quicksort engine, see pdqsort.h)
 
+// Median-of-three pivot selection (ninther for large ranges); the pivot ends up at arr[high]
+template<typename RandomIt, typename Compare>
+inline void medianOfThree(RandomIt arr, std::ptrdiff_t low, std::ptrdiff_t high, Compare comp) {
+    if (high - low < 2) { // Two elements: the larger one is the pivot
+        if (low < high && comp(arr[high], arr[low])) std::swap(arr[low], arr[high]);
+        return;
+    }
+    PdqsortImpl::choose_pivot(arr + low, arr + high + 1, comp);
+    std::swap(arr[low], arr[high]);
+}
+inline void medianOfThree(std::vector<int>& arr, int low, int high) {
+    medianOfThree(arr.begin(), low, high, std::less<>());
+}
+// Partition around the pivot at arr[high] (usually placed there by medianOfThree, but any
+// element will do); returns its final index. Elements less than the pivot end up left of it,
+// the rest right of it.
+template<typename RandomIt, typename Compare>
+inline std::ptrdiff_t partition(RandomIt arr, std::ptrdiff_t low, std::ptrdiff_t high, Compare comp) {
+    if (high - low < 2) {
+        if (low < high && !comp(arr[low], arr[high])) { std::swap(arr[low], arr[high]); return low; }
+        return high;
+    }
+    std::swap(arr[low], arr[high]);
+    // The engine's left scan is unguarded: it needs a key not less than the pivot to its right,
+    // which a median pivot always has. An arbitrary pivot may be the largest key, and then
+    // everything else belongs left of it.
+    if (comp(arr[high], arr[low])) {
+        std::ptrdiff_t i = low + 1;
+        while (i < high && comp(arr[i], arr[low])) ++i;
+        if (i == high) {
+            std::swap(arr[low], arr[high]);
+            return high;
+        }
+    }
+    auto part = PdqsortImpl::use_branchless<RandomIt, Compare>::value
+        ? PdqsortImpl::partition_right_branchless(arr + low, arr + high + 1, comp)
+        : PdqsortImpl::partition_right(arr + low, arr + high + 1, comp);
+    return part.first - arr;
+}
+inline int partition(std::vector<int>& arr, int low, int high) {
+    return static_cast<int>(partition(arr.begin(), low, high, std::less<>()));
+}
+//  Quick Sort recursion: the pdqsort loop, forking left parts above the threshold onto the TaskPool
+//  (never on a pool of one thread, where a fork would only cost an allocation)
+template<typename RandomIt, typename Compare>
+inline void quickSortRecursive(RandomIt begin, RandomIt end, Compare comp, int bad_allowed, bool leftmost, TaskPool& pool) {
+    TaskGroup group(pool);
+    const std::ptrdiff_t parallel_threshold = pool.thread_count() > 1 ? sort_tuning().parallel_quicksort_threshold : std::numeric_limits<std::ptrdiff_t>::max();
+    PdqsortImpl::pdqsort_loop(begin, end, comp, bad_allowed, leftmost, PDQSORT_INSERTION_THRESHOLD,
+        [&](RandomIt b, RandomIt e, int bad, bool lm) {
+            if (e - b > parallel_threshold) { // Parallel Execution
+                group.run([=, &pool]() { quickSortRecursive(b, e, comp, bad, lm, pool); });
+            } else { // Sequential Execution
+                PdqsortImpl::pdqsort_sequential(b, e, comp, bad, lm);
+            }
+        });
+    group.wait(); // Wait for forked left parts
+}
+//  Quick Sort function implementation (the process-wide pool unless one is passed in)
+template<typename RandomIt, typename Compare = std::less<>, typename Proj = identity_projection>
+inline void quickSort(RandomIt first, RandomIt last, Compare comp = {}, Proj proj = {}, TaskPool& pool = default_task_pool()) {
+    std::ptrdiff_t n = last - first;
+    if (n < 2) return;
+    quickSortRecursive(first, last, make_projected_compare(comp, proj), PdqsortImpl::log2(n), true, pool);
+}
+inline void quickSort(std::vector<int>& arr, int low, int high, TaskPool& pool = default_task_pool()) {
+    if (low >= high) return;
+    quickSort(arr.begin() + low, arr.begin() + high + 1, std::less<>(), identity_projection(), pool);
+}
 
 
 
-#endif 
\ No newline at end of file
+#endif
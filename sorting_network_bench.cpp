@@ -0,0 +1,98 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdlib>   // std::strtoll
+#include <iomanip>   //  std::setw, std::left (formatting output)
+#include <utility>   // std::index_sequence
+#include <random>
+
+#include "sorting_network.h"  // fixed_sort, fixed_sort_comparators
+#include "advanced_sorting.h" // custom_insertion_sort_range
+#include "datasets.h"         // generate_dataset (the keys)
+#include "benchmark_timing.h" // benchmark_sort_average_ms, print_benchmark_cell, is_sorted_permutation
+
+// Benchmark: fixed_sort<N> (compile-time sorting network) against custom_insertion_sort_range
+// and std::sort on many small arrays of exactly N random keys, N = 2..32, for int and double
+// keys. Each variant sorts every N-element block of the same buffer; the time per array is
+// the average over NUM_RUNS, and every output is checked against per-block std::sort.
+// Before timing, double keys mixing +0.0 and -0.0, and in every other round NaNs, go through
+// fixed_sort<N> and introsort (whose leaves are networks) to check that keys which compare equal
+// or unordered come out as a permutation; the program exits with status 1 if they do not.
+// Usage: sorting_network_bench [total_elements]   (default 4M)
+
+// Constants
+const std::size_t DEFAULT_TOTAL = 4'000'000;
+const int NUM_RUNS = 5;
+const int SIGNED_ZERO_ROUNDS = 200;
+const std::size_t SIGNED_ZERO_SORT_SIZE = 10000;
+
+
+// Nanoseconds per array of sort_block over every N-element block; -1 if an output was wrong
+template <std::size_t N, typename T, typename SortBlock>
+double ns_per_array(const std::vector<T>& original, const std::vector<T>& expected, SortBlock sort_block) {
+    std::size_t arrays = original.size() / N;
+    double ms = benchmark_sort_average_ms(NUM_RUNS, original, expected, [arrays, sort_block](std::vector<T>& data) {
+        for (std::size_t a = 0; a < arrays; ++a) sort_block(data.begin() + a * N);
+    });
+    return ms < 0 ? -1.0 : ms * 1e6 / arrays;
+}
+
+template <typename T, std::size_t N>
+void run_size(const std::vector<T>& keys) {
+    std::vector<T> data(keys.begin(), keys.begin() + keys.size() / N * N);
+    std::vector<T> expected = data;
+    for (std::size_t a = 0; a < data.size(); a += N) std::sort(expected.begin() + a, expected.begin() + a + N);
+    using It = typename std::vector<T>::iterator;
+
+    std::cout << "  " << std::left << std::setw(6) << N << std::right << std::setw(8) << fixed_sort_comparators(N);
+    print_benchmark_cell(ns_per_array<N>(data, expected, [](It first) { fixed_sort<N>(first); }), 12);
+    print_benchmark_cell(ns_per_array<N>(data, expected, [](It first) { custom_insertion_sort_range(first, first + N, std::less<>()); }), 12);
+    print_benchmark_cell(ns_per_array<N>(data, expected, [](It first) { std::sort(first, first + N); }), 12);
+    std::cout << "\n";
+}
+
+template <typename T, std::size_t... I>
+void run_sizes(const std::string& label, const std::vector<T>& keys, std::index_sequence<I...>) {
+    std::cout << "\n=== " << label << " keys (ns per array) ===\n";
+    std::cout << "  " << std::left << std::setw(6) << "N" << std::right << std::setw(8) << "CEs"
+              << std::setw(12) << "fixed_sort" << std::setw(12) << "insertion" << std::setw(12) << "std::sort" << "\n";
+    (run_size<T, I + 2>(keys), ...);
+}
+
+template <typename SortFunc>
+bool check_signed_zeros(const std::string& name, std::size_t size, SortFunc sort_func) {
+    std::mt19937_64 rng(42);
+    for (int round = 0; round < SIGNED_ZERO_ROUNDS; ++round) {
+        bool with_nan = round % 2 == 1;
+        std::vector<double> input = generate_signed_zeros<double>(size, rng, with_nan);
+        std::vector<double> output = input;
+        sort_func(output);
+        if (!is_sorted_permutation(input, output)) {
+            std::cerr << "!!! " << name << " lost or duplicated a key (size " << size << (with_nan ? ", with NaN" : "") << ") !!!" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+template <std::size_t... I>
+bool check_networks_signed_zeros(std::index_sequence<I...>) {
+    return (check_signed_zeros("fixed_sort<" + std::to_string(I + 2) + ">", I + 2,
+                               [](std::vector<double>& keys) { fixed_sort<I + 2>(keys.begin()); }) && ...);
+}
+
+
+int main(int argc, char* argv[]) {
+    std::size_t total = argc > 1 ? static_cast<std::size_t>(std::strtoll(argv[1], nullptr, 10)) : DEFAULT_TOTAL;
+    bool zeros_ok = check_networks_signed_zeros(std::make_index_sequence<31>())
+        && check_signed_zeros("introsort<double>", SIGNED_ZERO_SORT_SIZE, [](std::vector<double>& keys) { introsort(keys.begin(), keys.end()); });
+    std::cout << "Signed zeros (+0.0 / -0.0) and NaNs kept as a permutation: " << (zeros_ok ? "yes" : "NO") << std::endl;
+    if (!zeros_ok) return 1;
+
+    std::cout << "Sorting networks vs insertion sort vs std::sort on " << total << " keys in blocks of N (avg over "
+              << NUM_RUNS << " runs)\n" << std::fixed << std::setprecision(2);
+    run_sizes("int", generate_dataset<int>("random", total), std::make_index_sequence<31>());
+    run_sizes("double", generate_dataset<double>("random", total), std::make_index_sequence<31>());
+    return 0;
+}
@@ -0,0 +1,439 @@
+#ifndef STRING_SORT_H
+#define STRING_SORT_H
+
+#include <algorithm>   // std::copy, std::max_element, std::min, std::partition, std::sort
+#include <array>
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <cstdint>     // std::uint32_t, std::uint64_t
+#include <cstring>     // std::memcmp, std::memcpy
+#include <functional>  // std::invoke
+#include <iterator>    // std::iterator_traits
+#include <limits>      // std::numeric_limits
+#include <stdexcept>   // std::invalid_argument
+#include <string>
+#include <string_view>
+#include <type_traits> // std::decay_t, std::is_reference, std::is_same
+#include <utility>     // std::move, std::swap
+#include <vector>
+
+#include "task_pool.h"      // TaskPool, TaskGroup, default_task_pool
+#include "sort_common.h"    // identity_projection
+#include "sort_workspace.h" // SortWorkspace, sort_scratch (reference and element buffers)
+#include "heap_engine.h"    // heap_sort_range (multikey quicksort fallback)
+#include "pdqsort.h"        // PdqsortImpl::log2
+#include "kway_merge.h"     // SortedRun, multiway_split (output ranges of the parallel merge)
+
+
+// STRING SORTING (variable-length keys)
+//
+// Sorts elements by a string key: the element itself or whatever the projection returns,
+// viewed as a std::string_view and ordered bytewise as unsigned char, exactly like std::string.
+// The sort never moves the elements while it works. Each one is stood in for by a 24-byte
+// StringRef: the 8 key bytes at the current depth packed big-endian into a uint64 (the cached
+// prefix), the key's data pointer and length, and the element's 32-bit position. Almost every
+// decision compares cached prefixes, which travel with the references; a key's characters are
+// read only to load its next 8 bytes, once per 8 bytes of prefix it shares with its neighbours.
+// The elements are gathered in sorted order once at the end.
+//
+//  - multikey_quicksort: three-way radix quicksort (Bentley & Sedgewick) with the 8-byte
+//    prefix as one symbol. The < and > parts stay at their depth; the = part sets aside its
+//    keys that end inside the 8 bytes and goes 8 bytes deeper. Insertion sort below
+//    STRING_SORT_INSERTION_THRESHOLD, heapsort after log2(n) badly unbalanced partitions.
+//  - string_radix_sort: MSD radix sort, in place (American flag sort, like radix_sort's) on
+//    one byte per level read from the cached prefix, plus a bucket for keys that have ended;
+//    buckets below STRING_SORT_RADIX_MIN keys continue with multikey quicksort.
+//  - string_sort: string_radix_sort, or on a pool of several threads and from
+//    STRING_SORT_PARALLEL_MIN keys: one chunk per thread sorted as a task, then merged.
+//    multiway_split cuts the output into one range per thread and every range merges its
+//    pieces of the chunks pairwise with LCP-aware merges (Ng & Kakehi): each key carries the
+//    length of its common prefix with the key before it, so a merge step reads characters only
+//    when both heads share equally much with the key last written, and then from there on.
+//
+// Not stable. At most 2^32 - 1 keys, each shorter than 4 GiB (std::invalid_argument). The
+// projection must return a reference or a view into the element (a std::string_view, a
+// const std::string&, a const char*), not a temporary std::string.
+
+const std::ptrdiff_t STRING_SORT_INSERTION_THRESHOLD = 32; // Multikey quicksort: insertion sort below this
+const std::ptrdiff_t STRING_SORT_RADIX_MIN = 1 << 10;      // MSD radix sort: multikey quicksort below this
+const std::ptrdiff_t STRING_SORT_PARALLEL_MIN = 1 << 16;   // Fewer keys: one thread
+const std::ptrdiff_t STRING_SORT_PREFETCH_DISTANCE = 16;   // Final gather: element reads issued ahead of use
+
+namespace StringSortImpl {
+
+struct StringRef {
+    std::uint64_t prefix; // Key bytes [depth, depth + 8), big-endian, zero past the end
+    const char* data;
+    std::uint32_t size;
+    std::uint32_t index;  // Position of the element in the input
+};
+
+// Bytes [depth, depth + 8) of a key, big-endian, zero past its end
+inline std::uint64_t load_prefix(const char* data, std::size_t size, std::size_t depth) {
+    std::uint64_t prefix = 0;
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (depth + 8 <= size) {
+        std::memcpy(&prefix, data + depth, 8);
+        return __builtin_bswap64(prefix);
+    }
+#endif
+    for (std::size_t i = depth; i < depth + 8; ++i) {
+        prefix = prefix << 8 | (i < size ? static_cast<unsigned char>(data[i]) : 0u);
+    }
+    return prefix;
+}
+
+inline void load_prefixes(StringRef* first, StringRef* last, std::size_t depth) {
+    for (; first < last; ++first) first->prefix = load_prefix(first->data, first->size, depth);
+}
+
+// Order of two keys that share their first depth bytes, with prefixes loaded at depth. Equal
+// prefixes go on to the bytes after them, then to the lengths: a key that ends inside the
+// prefix is a prefix of the other (the rest of its 8 bytes are zero in both).
+inline bool less_at(const StringRef& a, const StringRef& b, std::size_t depth) {
+    if (a.prefix != b.prefix) return a.prefix < b.prefix;
+    std::size_t a_skip = std::min<std::size_t>(depth + 8, a.size), b_skip = std::min<std::size_t>(depth + 8, b.size);
+    int order = std::string_view(a.data + a_skip, a.size - a_skip).compare(std::string_view(b.data + b_skip, b.size - b_skip));
+    return order != 0 ? order < 0 : a.size < b.size;
+}
+
+struct LessAt {
+    std::size_t depth;
+    bool operator()(const StringRef& a, const StringRef& b) const { return less_at(a, b, depth); }
+};
+
+// Whole-key order, whatever depth the prefixes were loaded at
+struct KeyLess {
+    bool operator()(const StringRef& a, const StringRef& b) const {
+        return std::string_view(a.data, a.size) < std::string_view(b.data, b.size);
+    }
+};
+
+inline void insertion_sort(StringRef* first, StringRef* last, std::size_t depth) {
+    for (StringRef* i = first + 1; i < last; ++i) {
+        StringRef ref = *i;
+        StringRef* j = i;
+        for (; j > first && less_at(ref, j[-1], depth); --j) *j = j[-1];
+        *j = ref;
+    }
+}
+
+inline std::uint64_t median_of_3(std::uint64_t a, std::uint64_t b, std::uint64_t c) {
+    return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+// Median of 3 prefixes, or ninther from 128 keys up
+inline std::uint64_t choose_pivot(const StringRef* first, std::ptrdiff_t n) {
+    auto at = [first](std::ptrdiff_t i) { return first[i].prefix; };
+    std::ptrdiff_t mid = n / 2;
+    if (n < 128) return median_of_3(at(0), at(mid), at(n - 1));
+    std::ptrdiff_t s = n / 8;
+    return median_of_3(median_of_3(at(0), at(s), at(2 * s)),
+                       median_of_3(at(mid - s), at(mid), at(mid + s)),
+                       median_of_3(at(n - 1 - 2 * s), at(n - 1 - s), at(n - 1)));
+}
+
+// Multikey quicksort of keys sharing their first depth bytes, prefixes loaded at depth
+inline void multikey_sort(StringRef* first, StringRef* last, std::size_t depth, int bad_allowed) {
+    for (;;) {
+        std::ptrdiff_t n = last - first;
+        if (n < STRING_SORT_INSERTION_THRESHOLD) {
+            insertion_sort(first, last, depth);
+            return;
+        }
+
+        // [first, lt) < pivot, [lt, gt) == pivot, [gt, last) > pivot
+        std::uint64_t pivot = choose_pivot(first, n);
+        StringRef* lt = first;
+        StringRef* gt = last;
+        for (StringRef* i = first; i < gt;) {
+            if (i->prefix < pivot) std::swap(*lt++, *i++);
+            else if (pivot < i->prefix) std::swap(*i, *--gt);
+            else ++i;
+        }
+
+        // Keys of the = part that end inside the prefix differ only in trailing zero bytes:
+        // shortest first, and done. The others go 8 bytes deeper.
+        StringRef* open = std::partition(lt, gt, [depth](const StringRef& ref) { return ref.size <= depth + 8; });
+        if (open - lt > 1) std::sort(lt, open, [](const StringRef& a, const StringRef& b) { return a.size < b.size; });
+        load_prefixes(open, gt, depth + 8);
+
+        struct Part { StringRef* first; StringRef* last; std::size_t depth; int bad_allowed; };
+        std::array<Part, 3> parts = {{{first, lt, depth, bad_allowed}, {open, gt, depth + 8, PdqsortImpl::log2(gt - open)}, {gt, last, depth, bad_allowed}}};
+        if (std::max(lt - first, last - gt) > n / 8 * 7 && --bad_allowed == 0) {
+            LessAt comp{depth};
+            heap_sort_range(first, lt, comp); // Heapsort fallback (heap_engine.h)
+            heap_sort_range(gt, last, comp);
+            parts[0].last = first;
+            parts[2].first = last;
+        }
+        parts[0].bad_allowed = parts[2].bad_allowed = bad_allowed;
+
+        // The two smaller parts recurse, the largest continues here
+        auto largest = std::max_element(parts.begin(), parts.end(), [](const Part& a, const Part& b) { return a.last - a.first < b.last - b.first; });
+        for (const Part& part : parts) {
+            if (&part != &*largest && part.last - part.first > 1) multikey_sort(part.first, part.last, part.depth, part.bad_allowed);
+        }
+        first = largest->first;
+        last = largest->last;
+        depth = largest->depth;
+        bad_allowed = largest->bad_allowed;
+    }
+}
+
+// MSD radix sort of keys sharing their first pos bytes, prefixes loaded at window (pos - window
+// <= 8). Bucket 0 takes the keys that end at pos, buckets 1 + b the keys with byte b there.
+inline void msd_sort(StringRef* first, StringRef* last, std::size_t pos, std::size_t window) {
+    for (;;) {
+        std::ptrdiff_t n = last - first;
+        if (n < STRING_SORT_RADIX_MIN) {
+            multikey_sort(first, last, window, PdqsortImpl::log2(n));
+            return;
+        }
+        if (pos == window + 8) {
+            load_prefixes(first, last, pos);
+            window = pos;
+        }
+        if (pos == window) {
+            // Skip the bytes of this window that every key has and shares, in one pass
+            std::uint64_t differ = 0;
+            std::size_t shortest = first->size;
+            for (StringRef* i = first; i < last; ++i) {
+                differ |= i->prefix ^ first->prefix;
+                shortest = std::min<std::size_t>(shortest, i->size);
+            }
+            std::size_t shared = 0;
+            while (shared < 8 && (differ >> (56 - 8 * shared) & 0xFF) == 0) ++shared;
+            pos = std::max(pos, std::min(window + shared, shortest));
+            if (pos == window + 8) continue;
+        }
+        int shift = 56 - 8 * static_cast<int>(pos - window);
+        auto digit = [pos, shift](const StringRef& ref) -> std::size_t {
+            return ref.size <= pos ? 0 : 1 + static_cast<std::size_t>((ref.prefix >> shift) & 0xFF);
+        };
+
+        std::array<std::ptrdiff_t, 257> counts{};
+        for (StringRef* i = first; i < last; ++i) ++counts[digit(*i)];
+        if (counts[0] == n) return; // Every key ends here: all equal
+
+        // Constant byte: go straight to the next one without permuting
+        if (std::find(counts.begin(), counts.end(), n) != counts.end()) {
+            ++pos;
+            continue;
+        }
+
+        std::array<std::ptrdiff_t, 257> starts, heads, tails;
+        std::ptrdiff_t sum = 0;
+        for (std::size_t b = 0; b < 257; ++b) { starts[b] = heads[b] = sum; sum += counts[b]; tails[b] = sum; }
+
+        // Cycle every misplaced key into its bucket's next free slot
+        for (std::size_t b = 0; b < 257; ++b) {
+            while (heads[b] < tails[b]) {
+                std::size_t d = digit(first[heads[b]]);
+                if (d == b) ++heads[b];
+                else std::swap(first[heads[b]], first[heads[d]++]);
+            }
+        }
+
+        // Ended keys are equal; the other buckets recurse, the largest continues here
+        std::size_t largest = static_cast<std::size_t>(std::max_element(counts.begin() + 1, counts.end()) - counts.begin());
+        for (std::size_t b = 1; b < 257; ++b) {
+            if (b != largest && counts[b] > 1) msd_sort(first + starts[b], first + tails[b], pos + 1, window);
+        }
+        last = first + tails[largest];
+        first += starts[largest];
+        ++pos;
+    }
+}
+
+// Length of the common prefix of two keys known to share their first from bytes
+inline std::size_t common_prefix(const StringRef& a, const StringRef& b, std::size_t from) {
+    std::size_t n = std::min(a.size, b.size), i = from;
+    while (i + 8 <= n && std::memcmp(a.data + i, b.data + i, 8) == 0) i += 8;
+    while (i < n && a.data[i] == b.data[i]) ++i;
+    return i;
+}
+
+// lcp[i] = common prefix of sorted keys i - 1 and i (lcp[0] = 0)
+inline void compute_lcp(const StringRef* refs, std::uint32_t* lcp, std::ptrdiff_t n) {
+    if (n > 0) lcp[0] = 0;
+    for (std::ptrdiff_t i = 1; i < n; ++i) lcp[i] = static_cast<std::uint32_t>(common_prefix(refs[i - 1], refs[i], 0));
+}
+
+// A sorted run with its LCP array (lcp[0] is not used)
+struct Piece {
+    const StringRef* refs;
+    const std::uint32_t* lcp;
+    std::size_t size;
+};
+
+// LCP-aware merge of two sorted pieces into out, with out's LCP array. ha and hb are the common
+// prefixes of the heads with the last key written: the head sharing more is the smaller one,
+// and only on a tie are characters compared, from that offset on.
+inline void lcp_merge(const Piece& a, const Piece& b, StringRef* out, std::uint32_t* out_lcp) {
+    std::size_t i = 0, j = 0, k = 0, ha = 0, hb = 0;
+    while (i < a.size && j < b.size) {
+        bool take_a;
+        if (ha != hb) {
+            take_a = ha > hb;
+        } else {
+            std::size_t h = common_prefix(a.refs[i], b.refs[j], ha);
+            take_a = h == a.refs[i].size ||
+                     (h < b.refs[j].size && static_cast<unsigned char>(a.refs[i].data[h]) < static_cast<unsigned char>(b.refs[j].data[h]));
+            (take_a ? hb : ha) = h;
+        }
+        if (take_a) {
+            out[k] = a.refs[i];
+            out_lcp[k++] = static_cast<std::uint32_t>(ha);
+            if (++i < a.size) ha = a.lcp[i];
+        } else {
+            out[k] = b.refs[j];
+            out_lcp[k++] = static_cast<std::uint32_t>(hb);
+            if (++j < b.size) hb = b.lcp[j];
+        }
+    }
+    for (; i < a.size; ++i, ha = i < a.size ? a.lcp[i] : 0) { out[k] = a.refs[i]; out_lcp[k++] = static_cast<std::uint32_t>(ha); }
+    for (; j < b.size; ++j, hb = j < b.size ? b.lcp[j] : 0) { out[k] = b.refs[j]; out_lcp[k++] = static_cast<std::uint32_t>(hb); }
+}
+
+// Merge the pieces into out (as many slots as they hold together), in rounds of pairwise LCP merges
+inline void merge_pieces(std::vector<Piece> pieces, StringRef* out) {
+    std::size_t total = 0;
+    for (const Piece& piece : pieces) total += piece.size;
+    if (pieces.size() == 1) std::copy(pieces[0].refs, pieces[0].refs + total, out);
+    if (pieces.size() < 2) return;
+
+    std::array<std::vector<StringRef>, 2> refs;
+    std::array<std::vector<std::uint32_t>, 2> lcps;
+    for (int t = 0; t < 2; ++t) { refs[t].resize(total); lcps[t].resize(total); }
+    for (int target = 0; pieces.size() > 1; target ^= 1) {
+        StringRef* dst = pieces.size() == 2 ? out : refs[target].data();
+        std::uint32_t* dst_lcp = lcps[target].data();
+        std::vector<Piece> merged;
+        std::size_t offset = 0;
+        for (std::size_t p = 0; p < pieces.size(); p += 2) {
+            std::size_t size = pieces[p].size;
+            if (p + 1 < pieces.size()) {
+                size += pieces[p + 1].size;
+                lcp_merge(pieces[p], pieces[p + 1], dst + offset, dst_lcp + offset);
+            } else {
+                std::copy(pieces[p].refs, pieces[p].refs + size, dst + offset);
+                std::copy(pieces[p].lcp, pieces[p].lcp + size, dst_lcp + offset);
+            }
+            merged.push_back({dst + offset, dst_lcp + offset, size});
+            offset += size;
+        }
+        pieces = std::move(merged);
+    }
+}
+
+// Sort refs[0, n) on the pool into buffer: one chunk per thread, each sorted with msd_sort as
+// a task, then one output range per thread, each an LCP merge of its pieces of the chunks
+inline void parallel_sort(StringRef* refs, StringRef* buffer, std::uint32_t* lcp, std::ptrdiff_t n, TaskPool& pool) {
+    std::ptrdiff_t chunks = static_cast<std::ptrdiff_t>(pool.thread_count());
+    auto bound = [n, chunks](std::ptrdiff_t c) { return n * c / chunks; };
+    std::vector<SortedRun<StringRef*>> runs;
+    {
+        TaskGroup group(pool);
+        for (std::ptrdiff_t c = 0; c < chunks; ++c) {
+            StringRef* begin = refs + bound(c);
+            StringRef* end = refs + bound(c + 1);
+            std::uint32_t* chunk_lcp = lcp + bound(c);
+            runs.emplace_back(begin, end);
+            group.run([begin, end, chunk_lcp]() {
+                msd_sort(begin, end, 0, 0);
+                compute_lcp(begin, chunk_lcp, end - begin);
+            });
+        }
+        group.wait();
+    }
+
+    std::vector<std::vector<std::ptrdiff_t>> splits;
+    for (std::ptrdiff_t r = 0; r <= chunks; ++r) splits.push_back(multiway_split(runs, bound(r), KeyLess()));
+    TaskGroup group(pool);
+    for (std::ptrdiff_t r = 0; r < chunks; ++r) {
+        std::vector<Piece> pieces;
+        for (std::ptrdiff_t c = 0; c < chunks; ++c) {
+            std::ptrdiff_t begin = bound(c) + splits[r][c], end = bound(c) + splits[r + 1][c];
+            if (begin < end) pieces.push_back({refs + begin, lcp + begin, static_cast<std::size_t>(end - begin)});
+        }
+        StringRef* out = buffer + bound(r);
+        group.run([pieces = std::move(pieces), out]() { merge_pieces(pieces, out); });
+    }
+    group.wait();
+}
+
+enum class Engine { Multikey, Radix };
+
+template<typename RandomIt, typename Proj>
+inline void sort_elements(RandomIt first, RandomIt last, Proj& proj, Engine engine, TaskPool* pool, SortWorkspace* workspace) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using Key = decltype(std::invoke(proj, *first));
+    static_assert(std::is_reference<Key>::value || !std::is_same<std::decay_t<Key>, std::string>::value,
+                  "string sort projections must return a reference or a view into the element, not a std::string");
+    std::ptrdiff_t n = last - first;
+    if (n < 2) return;
+    const std::size_t max_size = std::numeric_limits<std::uint32_t>::max();
+    if (static_cast<std::size_t>(n) > max_size) throw std::invalid_argument("string_sort: more than 2^32 - 1 keys");
+
+    std::vector<StringRef> local_refs, local_buffer;
+    std::vector<StringRef>& refs = sort_scratch(workspace, local_refs, static_cast<std::size_t>(n), 0);
+    for (std::ptrdiff_t i = 0; i < n; ++i) {
+        std::string_view key(std::invoke(proj, first[i]));
+        if (key.size() >= max_size) throw std::invalid_argument("string_sort: key of 4 GiB or more");
+        refs[i] = {load_prefix(key.data(), key.size(), 0), key.data(), static_cast<std::uint32_t>(key.size()), static_cast<std::uint32_t>(i)};
+    }
+
+    const StringRef* sorted = refs.data();
+    if (pool != nullptr && pool->thread_count() > 1 && n >= STRING_SORT_PARALLEL_MIN) {
+        std::vector<std::uint32_t> local_lcp;
+        std::vector<StringRef>& buffer = sort_scratch(workspace, local_buffer, static_cast<std::size_t>(n), 1);
+        std::vector<std::uint32_t>& lcp = sort_scratch(workspace, local_lcp, static_cast<std::size_t>(n), 0);
+        parallel_sort(refs.data(), buffer.data(), lcp.data(), n, *pool);
+        sorted = buffer.data();
+    } else if (engine == Engine::Radix) {
+        msd_sort(refs.data(), refs.data() + n, 0, 0);
+    } else {
+        multikey_sort(refs.data(), refs.data() + n, 0, PdqsortImpl::log2(n));
+    }
+
+    // Gather the elements in sorted order, then move them back
+    std::vector<T> local_elements;
+    std::vector<T>& elements = sort_scratch(workspace, local_elements, static_cast<std::size_t>(n), 0);
+    for (std::ptrdiff_t i = 0; i < n; ++i) {
+#if defined(__GNUC__)
+        if (i + STRING_SORT_PREFETCH_DISTANCE < n) __builtin_prefetch(&first[sorted[i + STRING_SORT_PREFETCH_DISTANCE].index]);
+#endif
+        elements[i] = std::move(first[sorted[i].index]);
+    }
+    std::move(elements.begin(), elements.begin() + n, first);
+}
+
+} // namespace StringSortImpl
+
+// Multikey quicksort by the string key proj(element)
+template<typename RandomIt, typename Proj = identity_projection>
+inline void multikey_quicksort(RandomIt first, RandomIt last, Proj proj = {}, SortWorkspace* workspace = nullptr) {
+    StringSortImpl::sort_elements(first, last, proj, StringSortImpl::Engine::Multikey, nullptr, workspace);
+}
+inline void multikey_quicksort(std::vector<std::string>& strings) { multikey_quicksort(strings.begin(), strings.end()); }
+
+// MSD radix sort by the string key proj(element)
+template<typename RandomIt, typename Proj = identity_projection>
+inline void string_radix_sort(RandomIt first, RandomIt last, Proj proj = {}, SortWorkspace* workspace = nullptr) {
+    StringSortImpl::sort_elements(first, last, proj, StringSortImpl::Engine::Radix, nullptr, workspace);
+}
+inline void string_radix_sort(std::vector<std::string>& strings) { string_radix_sort(strings.begin(), strings.end()); }
+
+// MSD radix sort by the string key proj(element), with the parallel chunk sort and LCP merge
+// on a pool of several threads
+template<typename RandomIt, typename Proj = identity_projection>
+inline void string_sort(RandomIt first, RandomIt last, Proj proj = {}, TaskPool& pool = default_task_pool(),
+                        SortWorkspace* workspace = nullptr) {
+    StringSortImpl::sort_elements(first, last, proj, StringSortImpl::Engine::Radix, &pool, workspace);
+}
+inline void string_sort(std::vector<std::string>& strings, TaskPool& pool = default_task_pool()) {
+    string_sort(strings.begin(), strings.end(), identity_projection(), pool);
+}
+
+
+#endif
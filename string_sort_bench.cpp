@@ -0,0 +1,59 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdlib>   // std::strtoll
+#include <fstream>   // std::ifstream (a corpus file)
+#include <iomanip>   //  std::setw, std::left (formatting output)
+
+#include "string_sort.h" // multikey_quicksort, string_radix_sort, string_sort
+#include "datasets.h"    // generate_string_dataset, string_dataset_corpora
+#include "benchmark_timing.h" // benchmark_sort_average_ms, print_benchmark_row
+
+// Benchmark: sorting std::vector<std::string> corpora with std::sort against multikey
+// quicksort, MSD radix sort and string_sort on the default pool. The corpora are the
+// generated ones of datasets.h (URLs, prefixed IDs, UUIDs, log keys, Zipf words) or the lines
+// of a file. Reports the average over NUM_RUNS in ms and in million keys per second; every
+// output is checked against std::sort.
+// Usage: string_sort_bench [keys] [corpus_file]   (default 1M keys; a file is sorted whole, one key per line)
+
+// Constants
+const std::size_t DEFAULT_KEYS = 1000000;
+const int NUM_RUNS = 3;
+
+
+void run_corpus(const std::string& name, const std::vector<std::string>& data, TaskPool& pool) {
+    std::size_t bytes = 0;
+    for (const auto& s : data) bytes += s.size();
+    std::vector<std::string> expected = data;
+    std::sort(expected.begin(), expected.end());
+
+    std::cout << "\n=== " << name << ": " << data.size() << " keys, " << bytes / std::max<std::size_t>(1, data.size()) << " bytes on average ===\n";
+    std::cout << "  " << std::left << std::setw(24) << "variant" << std::right << std::setw(12) << "ms" << std::setw(12) << "Mkeys/s" << "\n";
+    print_benchmark_row("std::sort", 24, benchmark_sort_average_ms(NUM_RUNS, data, expected, [](std::vector<std::string>& d) { std::sort(d.begin(), d.end()); }), data.size(), 12);
+    print_benchmark_row("multikey_quicksort", 24, benchmark_sort_average_ms(NUM_RUNS, data, expected, [](std::vector<std::string>& d) { multikey_quicksort(d); }), data.size(), 12);
+    print_benchmark_row("string_radix_sort", 24, benchmark_sort_average_ms(NUM_RUNS, data, expected, [](std::vector<std::string>& d) { string_radix_sort(d); }), data.size(), 12);
+    print_benchmark_row("string_sort, pool", 24, benchmark_sort_average_ms(NUM_RUNS, data, expected, [&pool](std::vector<std::string>& d) { string_sort(d, pool); }), data.size(), 12);
+}
+
+
+int main(int argc, char* argv[]) {
+    std::size_t keys = argc > 1 ? static_cast<std::size_t>(std::strtoll(argv[1], nullptr, 10)) : DEFAULT_KEYS;
+    TaskPool& pool = default_task_pool();
+    std::cout << "String sorting (avg over " << NUM_RUNS << " runs, " << pool.thread_count() << " pool thread(s))\n"
+              << std::fixed << std::setprecision(2);
+
+    if (argc > 2) {
+        std::ifstream file(argv[2]);
+        if (!file) {
+            std::cerr << "cannot open " << argv[2] << "\n";
+            return 1;
+        }
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(file, line);) lines.push_back(std::move(line));
+        run_corpus(argv[2], lines, pool);
+        return 0;
+    }
+    for (const std::string& corpus : string_dataset_corpora()) run_corpus(corpus, generate_string_dataset(corpus, keys), pool);
+    return 0;
+}
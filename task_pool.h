@@ -0,0 +1,217 @@
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>             // std::unique_ptr
+#include <functional>         // std::function
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>          // std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <utility>            // std::forward, std::move
+
+
+// WORK-STEALING TASK POOL
+//
+// A fixed set of worker threads, each owning a deque of tasks. A worker pushes
+// and pops its own tasks at the back (LIFO, cache friendly for fork/join
+// recursion) and, when it runs dry, steals from the front of another worker's
+// deque. Tasks submitted from outside the pool land in a shared injection queue.
+// The number of threads never changes after construction, however many tasks
+// the sorts fork.
+class TaskPool {
+public:
+    using Task = std::function<void()>;
+
+    // thread_count == 0 sizes the pool to std::thread::hardware_concurrency()
+    explicit TaskPool(unsigned thread_count = 0) {
+        if (thread_count == 0) thread_count = std::thread::hardware_concurrency();
+        if (thread_count == 0) thread_count = 1;
+        // One deque per worker plus the injection queue at index thread_count
+        for (unsigned i = 0; i <= thread_count; ++i) queues_.emplace_back(new WorkerQueue());
+        workers_.reserve(thread_count);
+        for (unsigned i = 0; i < thread_count; ++i) {
+            workers_.emplace_back([this, i]() { worker_loop(i); });
+        }
+    }
+
+    ~TaskPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : workers_) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    unsigned thread_count() const { return static_cast<unsigned>(workers_.size()); }
+
+    // Queue a task. From a worker of this pool it goes onto that worker's own deque.
+    void submit(Task task) {
+        WorkerSlot& slot = current_slot();
+        std::size_t target = (slot.pool == this) ? slot.index : workers_.size();
+        {
+            WorkerQueue& q = *queues_[target];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            queued_.fetch_add(1, std::memory_order_release);
+        }
+        wake_.notify_one();
+    }
+
+    // Run one queued task on the calling thread, if any. Used by TaskGroup::wait
+    // so that a thread blocked on a join keeps doing useful work instead of sleeping.
+    bool run_pending_task() {
+        Task task;
+        WorkerSlot& slot = current_slot();
+        std::size_t self = (slot.pool == this) ? slot.index : workers_.size();
+        if (!find_task(self, task)) return false;
+        task();
+        return true;
+    }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    struct WorkerSlot {
+        TaskPool* pool = nullptr;
+        std::size_t index = 0;
+    };
+
+    static WorkerSlot& current_slot() {
+        static thread_local WorkerSlot slot;
+        return slot;
+    }
+
+    bool pop_back(std::size_t i, Task& out) {
+        WorkerQueue& q = *queues_[i];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) return false;
+        out = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+    }
+
+    bool pop_front(std::size_t i, Task& out) {
+        WorkerQueue& q = *queues_[i];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) return false;
+        out = std::move(q.tasks.front());
+        q.tasks.pop_front();
+        return true;
+    }
+
+    // Own deque first, then the injection queue, then steal round-robin from the other workers
+    bool find_task(std::size_t self, Task& out) {
+        if (queued_.load(std::memory_order_acquire) == 0) return false;
+        std::size_t n = workers_.size();
+        bool found = (self < n && pop_back(self, out)) || pop_front(n, out);
+        for (std::size_t k = 1; !found && k <= n; ++k) {
+            std::size_t victim = (self + k) % n;
+            if (victim != self) found = pop_front(victim, out);
+        }
+        if (found) queued_.fetch_sub(1, std::memory_order_acq_rel);
+        return found;
+    }
+
+    void worker_loop(std::size_t index) {
+        current_slot() = WorkerSlot{this, index};
+        for (;;) {
+            Task task;
+            if (find_task(index, task)) {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_.wait(lock, [this]() { return stopping_ || queued_.load(std::memory_order_acquire) > 0; });
+            if (stopping_ && queued_.load(std::memory_order_acquire) == 0) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<std::size_t> queued_{0};
+    bool stopping_ = false;
+};
+
+// Worker threads of default_task_pool(); 0 sizes it to the machine. Read once, when the pool
+// is first used, so a program that limits it (the benchmarks' --threads) sets it at startup.
+inline unsigned& default_task_pool_threads() {
+    static unsigned threads = 0;
+    return threads;
+}
+
+// Process-wide pool; sorts use it when no pool is passed in
+inline TaskPool& default_task_pool() {
+    static TaskPool pool(default_task_pool_threads());
+    return pool;
+}
+
+
+// FORK/JOIN GROUP
+//
+// run() forks a task onto the pool, wait() joins every task forked through this
+// group. While waiting, the caller executes queued tasks itself, so nested
+// fork/join never deadlocks even on a single-thread pool. The first exception
+// thrown by a task is rethrown from wait().
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskPool& pool) : pool_(pool) {}
+
+    ~TaskGroup() {
+        try { wait(); } catch (...) {}
+    }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    template<typename Func>
+    void run(Func&& func) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        pool_.submit([this, func = std::forward<Func>(func)]() mutable {
+            try {
+                func();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex_);
+                if (!error_) error_ = std::current_exception();
+            }
+            pending_.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    void wait() {
+        while (pending_.load(std::memory_order_acquire) != 0) {
+            if (!pool_.run_pending_task()) std::this_thread::yield();
+        }
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            std::swap(error, error_);
+        }
+        if (error) std::rethrow_exception(error);
+    }
+
+private:
+    TaskPool& pool_;
+    std::atomic<int> pending_{0};
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+
+#endif